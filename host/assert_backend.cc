@@ -0,0 +1,36 @@
+/**
+ * pw_assert_basic backend for host builds – flushes the log queue, prints
+ * the failure to stderr and aborts, so a debugger or the shell sees the crash (the board version
+ * in src/pw_assert_backend/ halts with both LEDs on).
+ */
+
+#include "pw_assert_basic/assert_basic.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+#include "log_control.h"
+
+extern "C"
+void pw_assert_basic_HandleFailure(const char* file_name,
+                                   int         line_number,
+                                   const char* function_name,
+                                   const char* message,
+                                   ...) {
+    log_control::Drain();
+    std::fprintf(stderr, "!!! ASSERTION FAILED !!!\n");
+    if (file_name)
+        std::fprintf(stderr, "  file:     %s:%d\n", file_name, line_number);
+    if (function_name)
+        std::fprintf(stderr, "  function: %s\n", function_name);
+    if (message && *message) {
+        va_list args;
+        va_start(args, message);
+        std::fprintf(stderr, "  message:  ");
+        std::vfprintf(stderr, message, args);
+        std::fprintf(stderr, "\n");
+        va_end(args);
+    }
+    std::abort();
+}
@@ -0,0 +1,113 @@
+// NOR flash emulator – see flash_emulator.h.
+
+#include "flash_emulator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+
+namespace host {
+
+FlashEmulator::FlashEmulator(size_t sector_count, size_t sector_size)
+    : sector_count_(sector_count),
+      sector_size_(sector_size),
+      words_(sector_count * sector_size / 4, 0xFFFF'FFFF),
+      erase_counts_(sector_count, 0) {}
+
+void FlashEmulator::Read(size_t sector, size_t offset, pw::span<std::byte> out) const {
+    std::memcpy(out.data(),
+                reinterpret_cast<const std::byte*>(words_.data()) + sector * sector_size_ + offset,
+                out.size());
+    bytes_read_ += out.size();
+}
+
+bool FlashEmulator::Survives() {
+    if (!powered_)
+        return false;
+    if (cut_armed_ && cut_after_-- == 0) {
+        cut_armed_ = false;
+        powered_   = false;
+    }
+    return powered_;
+}
+
+pw::Status FlashEmulator::Program(size_t sector, size_t offset, uint32_t word) {
+    if (sector >= sector_count_ || offset % 4 != 0 || offset + 4 > sector_size_)
+        return pw::Status::OutOfRange();
+    const bool was_powered = powered_;
+    const bool survives    = Survives();
+    if (!was_powered)
+        return pw::Status::Unavailable();
+
+    uint32_t& cell = words_[(sector * sector_size_ + offset) / 4];
+    if (word & ~cell)
+        ++violations_;
+    // A torn program clears only some of the bits it should have.
+    cell &= survives ? word : (word | random_());
+    ++programs_;
+    busy_us_ += kProgramWordUs;
+    return survives ? pw::OkStatus() : pw::Status::Unavailable();
+}
+
+pw::Status FlashEmulator::Erase(size_t sector) {
+    if (sector >= sector_count_)
+        return pw::Status::OutOfRange();
+    const bool was_powered = powered_;
+    const bool survives    = Survives();
+    if (!was_powered)
+        return pw::Status::Unavailable();
+
+    uint32_t* first = &words_[sector * sector_size_ / 4];
+    for (size_t i = 0; i < sector_size_ / 4; ++i) {
+        // A torn erase gets some words all the way, sets random bits in others.
+        if (survives || random_() % 2)
+            first[i] = 0xFFFF'FFFF;
+        else
+            first[i] |= random_();
+    }
+    ++erase_counts_[sector];
+    ++erases_;
+    busy_us_ += kEraseUsPerKb * static_cast<double>(sector_size_) / 1024.0;
+    return survives ? pw::OkStatus() : pw::Status::Unavailable();
+}
+
+void FlashEmulator::CutPowerAfter(uint64_t operations, uint32_t seed) {
+    cut_armed_ = true;
+    cut_after_ = operations;
+    random_.seed(seed);
+}
+
+void FlashEmulator::PowerOn() {
+    powered_   = true;
+    cut_armed_ = false;
+}
+
+bool FlashEmulator::Load(const char* path) {
+    std::FILE* f = std::fopen(path, "rb");
+    if (f == nullptr)
+        return false;
+    std::vector<uint32_t> words(words_.size());
+    const bool ok = std::fread(words.data(), 4, words.size(), f) == words.size() &&
+                    std::fgetc(f) == EOF;
+    std::fclose(f);
+    if (ok)
+        words_ = std::move(words);
+    return ok;
+}
+
+bool FlashEmulator::Save(const char* path) const {
+    std::FILE* f = std::fopen(path, "wb");
+    if (f == nullptr)
+        return false;
+    const bool ok = std::fwrite(words_.data(), 4, words_.size(), f) == words_.size();
+    return std::fclose(f) == 0 && ok;
+}
+
+void FlashEmulator::ResetStatistics() {
+    bytes_read_ = programs_ = erases_ = violations_ = 0;
+    busy_us_ = 0;
+    std::fill(erase_counts_.begin(), erase_counts_.end(), 0);
+}
+
+}  // namespace host
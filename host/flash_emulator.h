@@ -0,0 +1,85 @@
+// NOR flash in RAM, with a timing model and power-failure injection, as a
+// flash_log::Flash backend for the host build and host/flash_log_bench.cc.
+//
+//   host::FlashEmulator flash(4, 128 * 1024);   // the target's geometry
+//   flash.CutPowerAfter(17, seed);  // the 18th Program()/Erase() is torn
+//   …                               // … and every later one fails
+//   flash.PowerOn();
+//
+// NOR rules are enforced: Program() can only clear bits (an attempt to set
+// one is counted in violations() and has no effect on that bit).  A torn
+// program clears a random subset of the bits it should have cleared; a torn
+// erase leaves a random part of the sector erased and sets random bits in
+// the rest.
+//
+// busy_us() adds up the time the target's flash controller would have been
+// busy, from the STM32F429 data sheet typical values (x32 parallelism).
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "flash_log.h"
+
+namespace host {
+
+class FlashEmulator final : public flash_log::Flash {
+public:
+    static constexpr double kProgramWordUs = 16.0;         // t_PROG, x32
+    static constexpr double kEraseUsPerKb  = 1e6 / 128.0;  // t_ERASE128KB ≈ 1 s
+
+    FlashEmulator(size_t sector_count, size_t sector_size);
+
+    size_t sector_count() const override { return sector_count_; }
+    size_t sector_size() const override { return sector_size_; }
+
+    void       Read(size_t sector, size_t offset, pw::span<std::byte> out) const override;
+    pw::Status Program(size_t sector, size_t offset, uint32_t word) override;
+    pw::Status Erase(size_t sector) override;
+
+    // ── Fault injection ─────────────────────────────────────────────────────
+    // After |operations| more successful Program()/Erase() calls the next one
+    // is torn and returns UNAVAILABLE, like every call after it until
+    // PowerOn().  Reads keep working.
+    void CutPowerAfter(uint64_t operations, uint32_t seed);
+    void PowerOn();
+    bool powered() const { return powered_; }
+
+    // ── Persistence ─────────────────────────────────────────────────────────
+    // Raw image, sector after sector.  Load() fails if the size differs.
+    bool Load(const char* path);
+    bool Save(const char* path) const;
+
+    // ── Statistics ──────────────────────────────────────────────────────────
+    uint64_t bytes_read() const { return bytes_read_; }
+    uint64_t programs() const { return programs_; }
+    uint64_t erases() const { return erases_; }
+    uint64_t violations() const { return violations_; }
+    double   busy_us() const { return busy_us_; }
+    uint32_t erase_count(size_t sector) const { return erase_counts_[sector]; }
+    void     ResetStatistics();
+
+private:
+    // False (and tears the operation) once the power is cut.
+    bool Survives();
+
+    size_t                sector_count_;
+    size_t                sector_size_;
+    std::vector<uint32_t> words_;
+    std::vector<uint32_t> erase_counts_;
+
+    bool         powered_   = true;
+    bool         cut_armed_ = false;
+    uint64_t     cut_after_ = 0;
+    std::mt19937 random_;
+
+    mutable uint64_t bytes_read_ = 0;
+    uint64_t         programs_   = 0;
+    uint64_t         erases_     = 0;
+    uint64_t         violations_ = 0;
+    double           busy_us_    = 0;
+};
+
+}  // namespace host
@@ -0,0 +1,224 @@
+/**
+ * Throughput, mount time, wear and crash consistency of the flash log
+ * (src/flash_log.h) on the NOR emulator (host/flash_emulator.h).
+ *
+ *   flash_log_bench [records] [power cuts]     (default 20000 2000)
+ *
+ *   throughput  appends |records| batch summaries encoded as on the target
+ *               (history::EncodeBatch) to the target's geometry, 4 × 128 KB;
+ *               reports host time and the time the STM32's flash controller
+ *               would be busy
+ *   mount       remounts the full log: time and bytes read, against a full
+ *               ForEach() scan
+ *   wear        erase count per sector; must not differ by more than one
+ *   crash       on a small log (4 × 2 KB, so sectors rotate constantly) cuts
+ *               the power at a random Program()/Erase() |power cuts| times,
+ *               remounts and checks that every record read back is intact,
+ *               that sequence numbers increase with gaps only in the oldest
+ *               sector, that the last acknowledged record survived and that
+ *               dropped records never come back
+ *
+ * Exits non-zero on the first inconsistency.
+ */
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "flash_emulator.h"
+#include "flash_log.h"
+#include "history.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using flash_log::FlashLog;
+
+double UsSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+}
+
+int Fail(const char* what) {
+    std::printf("FAIL: %s\n", what);
+    return 1;
+}
+
+// Values in the range the firmware produces: 16 readings of -50..49 taken
+// 500 ms apart.
+history::BatchSummary MakeSummary(uint32_t batch, std::minstd_rand& rng) {
+    const auto min = static_cast<int32_t>(rng() % 50) - 50;
+    const auto max = static_cast<int32_t>(rng() % 50);
+    return {batch, batch * 8000, (min + max) / 2, min, max, static_cast<uint32_t>(rng() % 200),
+            static_cast<uint32_t>(rng() % 20)};
+}
+
+// ── Throughput, mount, wear ───────────────────────────────────────────────────
+
+int Throughput(uint32_t records) {
+    host::FlashEmulator flash(4, 128 * 1024);
+    FlashLog log(flash);
+    if (!log.Mount().ok())
+        return Fail("mount of blank flash");
+    flash.ResetStatistics();
+
+    std::minstd_rand rng(1);
+    std::array<std::byte, history::kMaxBatchSize> payload;
+    size_t payload_bytes = 0;
+    size_t size          = 0;
+    const auto t0 = Clock::now();
+    for (uint32_t i = 0; i < records; ++i) {
+        size = history::EncodeBatch(MakeSummary(i, rng), payload);
+        payload_bytes += size;
+        if (!log.Append(static_cast<uint8_t>(history::RecordType::kBatch),
+                        pw::span(payload.data(), size)).ok())
+            return Fail("append");
+    }
+    const double host_us = UsSince(t0);
+    std::printf("throughput: %u records, %.1f B payload each, %.2f us/record on the host; "
+                "target flash busy %.0f us/record (%llu erases)\n",
+                (unsigned)records, double(payload_bytes) / records, host_us / records,
+                flash.busy_us() / records, (unsigned long long)flash.erases());
+
+    uint32_t least = UINT32_MAX, most = 0;
+    std::printf("wear: erases per sector");
+    for (size_t s = 0; s < flash.sector_count(); ++s) {
+        std::printf(" %u", (unsigned)flash.erase_count(s));
+        least = std::min(least, flash.erase_count(s));
+        most  = std::max(most, flash.erase_count(s));
+    }
+    std::printf("\n");
+    if (most - least > 1)
+        return Fail("uneven wear");
+
+    flash.ResetStatistics();
+    FlashLog remount(flash);
+    const auto t1 = Clock::now();
+    if (!remount.Mount().ok())
+        return Fail("remount");
+    const double   mount_us    = UsSince(t1);
+    const uint64_t mount_bytes = flash.bytes_read();
+
+    flash.ResetStatistics();
+    bool       last_matches = false;
+    const auto t2           = Clock::now();
+    const size_t found = remount.ForEach([&](uint8_t, pw::span<const std::byte> p) {
+        last_matches = p.size() == size && std::memcmp(p.data(), payload.data(), size) == 0;
+        return true;
+    });
+    const double scan_us = UsSince(t2);
+    std::printf("mount: %.1f us, %llu bytes read; full scan of %zu records: %.1f us, "
+                "%llu bytes read\n",
+                mount_us, (unsigned long long)mount_bytes, found, scan_us,
+                (unsigned long long)flash.bytes_read());
+    if (!last_matches)
+        return Fail("last record not found after remount");
+    return 0;
+}
+
+// ── Crash consistency ─────────────────────────────────────────────────────────
+
+// sequence number (u32) | 12 bytes derived from it
+constexpr size_t kCrashPayload = 16;
+
+std::array<std::byte, kCrashPayload> CrashPayload(uint32_t seq) {
+    std::array<std::byte, kCrashPayload> p;
+    std::memcpy(p.data(), &seq, 4);
+    for (size_t i = 4; i < p.size(); ++i)
+        p[i] = static_cast<std::byte>(seq * 31 + i * 7);
+    return p;
+}
+
+int Crash(uint32_t cuts) {
+    constexpr size_t kSectorSize = 2048;
+    constexpr size_t kPerSector =
+        (kSectorSize - FlashLog::kSectorHeaderSize) / (FlashLog::kRecordHeaderSize + kCrashPayload);
+
+    host::FlashEmulator flash(4, kSectorSize);
+    std::minstd_rand    rng(2);
+    uint32_t next       = 0;   // sequence number of the next record
+    int64_t  last_acked = -1;  // newest record Append() confirmed
+    uint32_t oldest     = 0;   // oldest record seen so far
+    uint64_t appended   = 0;
+
+    for (uint32_t cut = 0; cut < cuts; ++cut) {
+        // About 7 operations per record: up to ~30 records, or a sector
+        // rotation, per power cycle.
+        flash.CutPowerAfter(rng() % 200, rng());
+        {
+            FlashLog log(flash);
+            if (log.Mount().ok()) {
+                while (log.Append(1, CrashPayload(next)).ok()) {
+                    last_acked = next++;
+                    ++appended;
+                }
+            }
+        }
+        flash.PowerOn();
+
+        FlashLog log(flash);
+        if (!log.Mount().ok())
+            return Fail("mount after power cut");
+        std::vector<uint32_t> seqs;
+        bool intact = true;
+        log.ForEach([&](uint8_t type, pw::span<const std::byte> p) {
+            uint32_t seq = 0;
+            if (type != 1 || p.size() != kCrashPayload) {
+                intact = false;
+            } else {
+                std::memcpy(&seq, p.data(), 4);
+                intact = intact && std::memcmp(p.data(), CrashPayload(seq).data(), p.size()) == 0;
+            }
+            seqs.push_back(seq);
+            return true;
+        });
+        if (!intact)
+            return Fail("corrupt record returned");
+        for (size_t i = 1; i < seqs.size(); ++i) {
+            if (seqs[i] <= seqs[i - 1])
+                return Fail("records out of order");
+            if (seqs[i] != seqs[i - 1] + 1 && i > kPerSector)
+                return Fail("record missing outside the oldest sector");
+        }
+        if (last_acked >= 0 && (seqs.empty() || (seqs.back() != last_acked &&
+                                                 seqs.back() != last_acked + 1)))
+            return Fail("acknowledged record lost");
+        if (!seqs.empty() && seqs.front() < oldest)
+            return Fail("dropped record came back");
+
+        // A record whose commit word made it counts as written even though
+        // Append() reported the power failure.
+        if (!seqs.empty()) {
+            oldest     = seqs.front();
+            last_acked = seqs.back();
+            next       = seqs.back() + 1;
+        }
+    }
+    if (flash.violations() != 0)
+        return Fail("programmed a word that was not erased");
+
+    std::printf("crash: %u power cuts, %llu records acknowledged, %llu sector erases: "
+                "no torn, reordered or lost records\n",
+                (unsigned)cuts, (unsigned long long)appended,
+                (unsigned long long)flash.erases());
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const uint32_t records = argc > 1 ? static_cast<uint32_t>(std::atol(argv[1])) : 20'000;
+    const uint32_t cuts    = argc > 2 ? static_cast<uint32_t>(std::atol(argv[2])) : 2'000;
+    if (records == 0 || argc > 3) {
+        std::fprintf(stderr, "Usage: %s [records] [power cuts]\n", argv[0]);
+        return 2;
+    }
+    if (Throughput(records) != 0 || Crash(cuts) != 0)
+        return 1;
+    std::printf("OK\n");
+    return 0;
+}
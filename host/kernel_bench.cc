@@ -0,0 +1,271 @@
+/**
+ * Host timings of the firmware's hot-path kernels (src/bench.h), with a
+ * comparison against a stored baseline.
+ *
+ *   kernel_bench [--samples N] [--warmup N] [--json FILE]
+ *                [--baseline FILE] [--threshold PERCENT] [KERNEL...]
+ *
+ * The kernels are the ones Bench.Run times on the board: batch reduction,
+ * Base64 log lines, CRC-32 / CRC-32C, pw_tokenizer argument encoding.  A
+ * call takes nanoseconds on a PC, so each sample times a loop of calls,
+ * sized to take at least kMinSampleNs, minus the same loop over an empty
+ * kernel.  --warmup samples (default 5) are discarded, then --samples
+ * (default 50) are kept; the table shows ns per call:
+ *
+ *   min, median, mean ± standard deviation, max
+ *
+ * --json writes the results, one kernel per line, in the layout of
+ * tools/bench_collect.py ("unit": "ns").  --baseline reads such a file –
+ * from this tool, or bench_collect.py run against the host build – and
+ * compares medians: a kernel more than --threshold percent (default 10)
+ * slower is a regression, and the exit status is then 1.  Baselines are
+ * only comparable on the same machine and build type.
+ *
+ * Exits 2 on a usage or file error.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bench.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr double kMinSampleNs = 100'000;
+
+struct Options {
+    int                      samples   = 50;
+    int                      warmup    = 5;
+    double                   threshold = 10;
+    const char*              json      = nullptr;
+    const char*              baseline  = nullptr;
+    std::vector<std::string> only;
+};
+
+struct Stats {
+    std::string name;
+    uint64_t    iterations;
+    double      min, median, mean, stddev, max;
+};
+
+volatile uint32_t sink;
+
+uint32_t Empty() { return 0; }
+
+double LoopNs(uint32_t (*run)(), uint64_t iterations) {
+    const auto t0 = Clock::now();
+    for (uint64_t i = 0; i < iterations; ++i)
+        sink = run();
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+}
+
+// Doubles the loop until one sample takes kMinSampleNs.
+uint64_t Calibrate(uint32_t (*run)()) {
+    uint64_t iterations = 1;
+    while (LoopNs(run, iterations) < kMinSampleNs && iterations < (uint64_t{1} << 30))
+        iterations *= 2;
+    return iterations;
+}
+
+Stats Measure(const bench::Kernel& kernel, const Options& opt) {
+    const uint64_t iterations = Calibrate(kernel.run);
+    for (int i = 0; i < opt.warmup; ++i)
+        LoopNs(kernel.run, iterations);
+
+    std::vector<double> ns;
+    for (int i = 0; i < opt.samples; ++i) {
+        // The empty loop right before each sample, so both see the same
+        // clock speed.
+        const double overhead = LoopNs(Empty, iterations);
+        ns.push_back(std::max(0.0, LoopNs(kernel.run, iterations) - overhead) /
+                     static_cast<double>(iterations));
+    }
+    std::sort(ns.begin(), ns.end());
+
+    Stats s{kernel.name, iterations, ns.front(), 0, 0, 0, ns.back()};
+    const size_t n = ns.size();
+    s.median = n % 2 ? ns[n / 2] : (ns[n / 2 - 1] + ns[n / 2]) / 2;
+    for (double v : ns)
+        s.mean += v / static_cast<double>(n);
+    for (double v : ns)
+        s.stddev += (v - s.mean) * (v - s.mean);
+    s.stddev = n > 1 ? std::sqrt(s.stddev / static_cast<double>(n - 1)) : 0;
+    return s;
+}
+
+// ── JSON ──────────────────────────────────────────────────────────────────────
+
+bool WriteJson(const char* path, const std::vector<Stats>& results, const Options& opt) {
+    FILE* f = std::fopen(path, "w");
+    if (f == nullptr)
+        return false;
+    std::fprintf(f, "{\n  \"tool\": \"kernel_bench\",\n  \"unit\": \"ns\",\n");
+    std::fprintf(f, "  \"samples\": %d,\n  \"kernels\": {\n", opt.samples);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Stats& s = results[i];
+        std::fprintf(f,
+                     "    \"%s\": {\"iterations\": %llu, \"min\": %.3f, \"median\": %.3f, "
+                     "\"mean\": %.3f, \"stddev\": %.3f, \"max\": %.3f}%s\n",
+                     s.name.c_str(), static_cast<unsigned long long>(s.iterations), s.min,
+                     s.median, s.mean, s.stddev, s.max, i + 1 < results.size() ? "," : "");
+    }
+    std::fprintf(f, "  }\n}\n");
+    return std::fclose(f) == 0;
+}
+
+// The string value of the first "|key|": "..." in |text|.
+std::optional<std::string> StringField(std::string_view text, std::string_view key) {
+    const size_t k = text.find("\"" + std::string(key) + "\"");
+    if (k == std::string_view::npos)
+        return std::nullopt;
+    const size_t open = text.find('"', text.find(':', k) + 1);
+    const size_t end  = text.find('"', open + 1);
+    if (open == std::string_view::npos || end == std::string_view::npos)
+        return std::nullopt;
+    return std::string(text.substr(open + 1, end - open - 1));
+}
+
+// Kernel name → median from the "kernels" object of |text|: every
+// "name": { ... "median": N ... } in it.  Enough for the files this tool
+// and tools/bench_collect.py write, not a general JSON parser.
+std::map<std::string, double> Medians(std::string_view text) {
+    std::map<std::string, double> medians;
+    size_t pos = text.find("\"kernels\"");
+    if (pos == std::string_view::npos)
+        return medians;
+    pos = text.find('{', pos);
+    while (pos != std::string_view::npos) {
+        const size_t name = text.find_first_not_of(" \t\r\n,", pos + 1);
+        if (name == std::string_view::npos || text[name] != '"')
+            break;  // the end of "kernels"
+        const size_t name_end = text.find('"', name + 1);
+        const size_t open     = text.find('{', name_end);
+        const size_t close    = text.find('}', open);
+        if (name_end == std::string_view::npos || open == std::string_view::npos ||
+            close == std::string_view::npos)
+            break;
+        const std::string_view body   = text.substr(open, close - open);
+        const size_t           median = body.find("\"median\"");
+        if (median != std::string_view::npos) {
+            const std::string number(body.substr(body.find(':', median) + 1));
+            medians[std::string(text.substr(name + 1, name_end - name - 1))] =
+                std::strtod(number.c_str(), nullptr);
+        }
+        pos = close;
+    }
+    return medians;
+}
+
+// Prints one line per kernel; returns the number of regressions.
+int Compare(const std::vector<Stats>& results, const std::map<std::string, double>& baseline,
+            double threshold) {
+    std::printf("\n%-14s %10s %10s %8s\n", "vs baseline", "before", "now", "change");
+    int regressions = 0;
+    for (const Stats& s : results) {
+        const auto it = baseline.find(s.name);
+        if (it == baseline.end() || it->second <= 0) {
+            std::printf("%-14s %10s %10.2f %8s  new\n", s.name.c_str(), "-", s.median, "");
+            continue;
+        }
+        const double change = (s.median / it->second - 1) * 100;
+        const char*  verdict = "";
+        if (change > threshold) {
+            verdict = "  REGRESSION";
+            ++regressions;
+        } else if (change < -threshold) {
+            verdict = "  faster";
+        }
+        std::printf("%-14s %10.2f %10.2f %+7.1f%%%s\n", s.name.c_str(), it->second, s.median,
+                    change, verdict);
+    }
+    return regressions;
+}
+
+int Usage() {
+    std::fprintf(stderr,
+                 "usage: kernel_bench [--samples N] [--warmup N] [--json FILE]\n"
+                 "                    [--baseline FILE] [--threshold PERCENT] [KERNEL...]\n");
+    return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool has_value       = i + 1 < argc;
+        if (arg == "--samples" && has_value)
+            opt.samples = std::atoi(argv[++i]);
+        else if (arg == "--warmup" && has_value)
+            opt.warmup = std::atoi(argv[++i]);
+        else if (arg == "--threshold" && has_value)
+            opt.threshold = std::atof(argv[++i]);
+        else if (arg == "--json" && has_value)
+            opt.json = argv[++i];
+        else if (arg == "--baseline" && has_value)
+            opt.baseline = argv[++i];
+        else if (arg.starts_with("--"))
+            return Usage();
+        else
+            opt.only.emplace_back(arg);
+    }
+    if (opt.samples < 1 || opt.warmup < 0)
+        return Usage();
+
+    std::map<std::string, double> baseline;
+    if (opt.baseline != nullptr) {
+        std::ifstream in(opt.baseline);
+        if (!in) {
+            std::perror(opt.baseline);
+            return 2;
+        }
+        const std::string text{std::istreambuf_iterator<char>(in), {}};
+        if (const auto unit = StringField(text, "unit"); unit && *unit != "ns") {
+            std::fprintf(stderr, "%s: unit is %s, not ns\n", opt.baseline, unit->c_str());
+            return 2;
+        }
+        baseline = Medians(text);
+        if (baseline.empty()) {
+            std::fprintf(stderr, "%s: no kernels found\n", opt.baseline);
+            return 2;
+        }
+    }
+
+    std::printf("%-14s %10s %9s %9s %9s %8s %9s   (ns per call, %d samples)\n", "kernel",
+                "iterations", "min", "median", "mean", "stddev", "max", opt.samples);
+    std::vector<Stats> results;
+    for (const bench::Kernel& kernel : bench::Kernels()) {
+        if (!opt.only.empty() &&
+            std::find(opt.only.begin(), opt.only.end(), kernel.name) == opt.only.end())
+            continue;
+        const Stats& s = results.emplace_back(Measure(kernel, opt));
+        std::printf("%-14s %10llu %9.2f %9.2f %9.2f %8.2f %9.2f\n", s.name.c_str(),
+                    static_cast<unsigned long long>(s.iterations), s.min, s.median, s.mean,
+                    s.stddev, s.max);
+    }
+    if (results.empty()) {
+        std::fprintf(stderr, "no such kernel\n");
+        return 2;
+    }
+
+    if (opt.json != nullptr && !WriteJson(opt.json, results, opt)) {
+        std::perror(opt.json);
+        return 2;
+    }
+    if (opt.baseline != nullptr && Compare(results, baseline, opt.threshold) > 0)
+        return 1;
+    return 0;
+}
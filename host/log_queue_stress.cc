@@ -0,0 +1,151 @@
+/**
+ * Multi-threaded stress run of MpscRecordQueue (src/mpsc_queue.h), the queue
+ * between pw_log_tokenized_HandleLog and the UART.
+ *
+ * N producer threads push records of random length (1..kMaxPayloadSize) as
+ * fast as they can while one consumer thread pops them.  Every payload
+ * carries its producer, a sequence number and a CRC-32, so the consumer can
+ * detect records that are
+ *   torn       – CRC or length does not match the content written,
+ *   reordered  – a producer's sequence numbers do not increase,
+ *   lost       – popped + dropped (Push returned false) != pushed.
+ *
+ *   log_queue_stress [producers] [records per producer]     (default 4 1000000)
+ *
+ * Exits non-zero on the first inconsistency.  The ring is deliberately small
+ * (1 KB) so that wrap-around, padding records and full-queue drops all happen
+ * constantly.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "crc.h"
+#include "mpsc_queue.h"
+
+namespace {
+
+using Queue = MpscRecordQueue<1024>;
+
+// producer (u8) | seq (u32) | crc32 of the filler (u32) | filler …
+constexpr size_t kMinPayload = 1 + 4 + 4;
+
+struct ProducerResult {
+    uint32_t pushed  = 0;
+    uint32_t dropped = 0;
+};
+
+void Produce(Queue& q, uint8_t id, uint32_t count, ProducerResult& r) {
+    std::minstd_rand rng(id + 1);
+    std::byte buf[Queue::kMaxPayloadSize];
+    for (uint32_t seq = 0; seq < count; ++seq) {
+        const size_t len = kMinPayload + rng() % (Queue::kMaxPayloadSize - kMinPayload + 1);
+        for (size_t i = kMinPayload; i < len; ++i)
+            buf[i] = static_cast<std::byte>(rng());
+        const uint32_t crc = crc::Crc32::Compute(buf + kMinPayload, len - kMinPayload);
+        buf[0] = static_cast<std::byte>(id);
+        std::memcpy(buf + 1, &seq, 4);
+        std::memcpy(buf + 5, &crc, 4);
+
+        // The tag repeats the length so a record spliced from two others is
+        // caught even if the CRC happened to match.
+        if (q.Push(static_cast<uint32_t>(len), pw::span<const std::byte>(buf, len))) {
+            ++r.pushed;
+        } else {
+            ++r.dropped;
+            std::this_thread::yield();  // let the consumer catch up (matters on few cores)
+        }
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const unsigned producers = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 4;
+    const uint32_t per_producer = argc > 2 ? static_cast<uint32_t>(std::atol(argv[2])) : 1'000'000;
+    if (producers == 0 || producers > 255) {
+        std::fprintf(stderr, "Usage: %s [producers 1..255] [records per producer]\n", argv[0]);
+        return 2;
+    }
+
+    static Queue queue;
+    std::vector<ProducerResult> results(producers);
+    std::vector<int64_t>        last_seq(producers, -1);
+    std::vector<uint32_t>       popped(producers, 0);
+    std::atomic<unsigned>       running{producers};
+    const char*                 error = nullptr;
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    std::thread consumer([&] {
+        auto check = [&](uint32_t tag, pw::span<const std::byte> p) {
+            if (error != nullptr)
+                return;
+            if (p.size() < kMinPayload || tag != p.size()) {
+                error = "torn record (length)";
+                return;
+            }
+            const auto id = static_cast<uint8_t>(p[0]);
+            uint32_t seq, crc;
+            std::memcpy(&seq, p.data() + 1, 4);
+            std::memcpy(&crc, p.data() + 5, 4);
+            if (id >= producers ||
+                crc != crc::Crc32::Compute(p.data() + kMinPayload, p.size() - kMinPayload)) {
+                error = "torn record (content)";
+                return;
+            }
+            if (static_cast<int64_t>(seq) <= last_seq[id]) {
+                error = "records reordered";
+                return;
+            }
+            last_seq[id] = seq;
+            ++popped[id];
+        };
+        while (running.load(std::memory_order_acquire) != 0) {
+            if (queue.Drain(check) == 0)
+                std::this_thread::yield();
+        }
+        queue.Drain(check);
+    });
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < producers; ++i) {
+        threads.emplace_back([&, i] {
+            Produce(queue, static_cast<uint8_t>(i), per_producer, results[i]);
+            running.fetch_sub(1, std::memory_order_release);
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    consumer.join();
+
+    const double secs =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    uint64_t total_pushed = 0, total_dropped = 0;
+    for (unsigned i = 0; i < producers && error == nullptr; ++i) {
+        total_pushed  += results[i].pushed;
+        total_dropped += results[i].dropped;
+        if (popped[i] != results[i].pushed)
+            error = "records lost";
+    }
+    if (error == nullptr && total_dropped != queue.dropped())
+        error = "drop counter mismatch";
+
+    std::printf("%u producers x %u records: %llu popped, %llu dropped (full), %.2f s, "
+                "%.1f Mrecords/s\n",
+                producers, (unsigned)per_producer, (unsigned long long)total_pushed,
+                (unsigned long long)total_dropped, secs, total_pushed / secs / 1e6);
+    if (error != nullptr) {
+        std::printf("FAIL: %s\n", error);
+        return 1;
+    }
+    std::printf("OK: no torn, reordered or lost records\n");
+    return 0;
+}
@@ -0,0 +1,247 @@
+/**
+ * Host-native build of the demo (DEMO_HOST_BUILD).
+ *
+ * Runs the RPC server and tokenized logging of the firmware on a
+ * pseudo-terminal and simulates the sensor loop of src/main.cpp (one sample
+ * every 500 ms, a batch every 16 samples by default), so host tools can be
+ * developed and tested without a board:
+ *
+ *   stm32f429i_demo_host [--link PATH] [--flash FILE] [--config FILE] [--lcd FILE]
+ *                        [--log-file FILE]
+ *
+ * The pty's slave path is printed on stderr; --link additionally creates a
+ * symlink to it at PATH (replaced if it exists) for scripts.
+ *
+ * Batch summaries and events go to a flash log (src/history.h) on an
+ * emulated 4 × 128 KB flash, as on the board.  --flash keeps its contents in
+ * FILE across runs (loaded at start if it exists, saved at exit).
+ * --config does the same for the configuration store (src/config.h, 2 ×
+ * 128 KB); the log level comes from there, and a new sample period or batch
+ * size takes effect at the next batch as on the board.  The baud rate is
+ * ignored.
+ *
+ * The LCD strip chart (src/strip_chart.h) is drawn into a framebuffer in the
+ * simulated SDRAM exactly as on the board; --lcd writes it to FILE as a PPM
+ * image after every update (open it in a viewer that reloads on change).
+ *
+ * Built with -DDEMO_LOG_TRANSPORT=file (src/transport.h), the tokenized log
+ * goes to --log-file FILE instead of the pty, as fast as the disk takes it;
+ * RPC stays on the pty.
+ */
+
+#include "log_config.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <utility>
+#include <unistd.h>
+
+#include "capture.h"
+#include "config.h"
+#include "coro.h"
+#include "flash_emulator.h"
+#include "history.h"
+#include "lcd.h"
+#include "log_control.h"
+#include "memory_bench.h"
+#include "memory_region.h"
+#include "ppm.h"
+#include "pty.h"
+#include "pw_build_info/build_id.h"
+#include "rpc_services.h"
+#include "stats.h"
+#include "strip_chart.h"
+#include "transport.h"
+#include "watchdog.h"
+
+#undef PW_LOG_MODULE_NAME
+#define PW_LOG_MODULE_NAME "DEMO"
+
+namespace {
+
+volatile std::sig_atomic_t running = 1;
+
+void Stop(int) { running = 0; }
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* link        = nullptr;
+    const char* flash_file  = nullptr;
+    const char* config_file = nullptr;
+    const char* lcd_file    = nullptr;
+    const char* log_file    = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--link") == 0 && i + 1 < argc) {
+            link = argv[++i];
+        } else if (std::strcmp(argv[i], "--flash") == 0 && i + 1 < argc) {
+            flash_file = argv[++i];
+        } else if (std::strcmp(argv[i], "--config") == 0 && i + 1 < argc) {
+            config_file = argv[++i];
+        } else if (std::strcmp(argv[i], "--lcd") == 0 && i + 1 < argc) {
+            lcd_file = argv[++i];
+        } else if (std::strcmp(argv[i], "--log-file") == 0 && i + 1 < argc) {
+            log_file = argv[++i];
+        } else {
+            std::fprintf(stderr,
+                         "Usage: %s [--link PATH] [--flash FILE] [--config FILE] [--lcd FILE] "
+                         "[--log-file FILE]\n",
+                         argv[0]);
+            return 2;
+        }
+    }
+
+    static host::FlashEmulator flash(4, 128 * 1024);         // sectors 20–23 of the STM32F429
+    static host::FlashEmulator config_flash(2, 128 * 1024);  // sectors 18–19
+    for (const auto& [file, emulator] : {std::pair(flash_file, &flash),
+                                         std::pair(config_file, &config_flash)}) {
+        if (file != nullptr && access(file, F_OK) == 0 && !emulator->Load(file)) {
+            std::fprintf(stderr, "%s: not a %zu-byte flash image\n", file,
+                         emulator->sector_count() * emulator->sector_size());
+            return 1;
+        }
+    }
+
+#ifdef DEMO_LOG_TRANSPORT_FILE
+    if (log_file == nullptr) {
+        std::fprintf(stderr, "Log transport is a file: --log-file FILE is required\n");
+        return 2;
+    }
+    if (!transport::File::Open(log_file)) {
+        std::perror(log_file);
+        return 1;
+    }
+#else
+    if (log_file != nullptr)
+        std::fprintf(stderr, "--log-file ignored: log transport is %s\n", transport::Log::kName);
+#endif
+
+    const char* pty = host::OpenPty();
+    if (pty == nullptr) {
+        std::perror("pseudo-terminal");
+        return 1;
+    }
+    if (link != nullptr) {
+        unlink(link);
+        if (symlink(pty, link) != 0) {
+            std::perror(link);
+            return 1;
+        }
+    }
+    std::fprintf(stderr, "UART on %s%s%s\n", pty, link ? " → " : "", link ? link : "");
+
+    std::signal(SIGINT, Stop);
+    std::signal(SIGTERM, Stop);
+
+    PW_LOG_INFO("=========================================");
+    PW_LOG_INFO(" STM32F429I-DISCO demo – host build      ");
+    PW_LOG_INFO("=========================================");
+    {
+        const pw::span<const std::byte> bid = pw::build_info::BuildId();
+        char hex[pw::build_info::kMaxBuildIdSizeBytes * 2 + 1] = {};
+        static constexpr char kNibble[] = "0123456789abcdef";
+        for (size_t i = 0; i < bid.size(); ++i) {
+            const auto b  = static_cast<uint8_t>(bid[i]);
+            hex[i * 2]     = kNibble[b >> 4];
+            hex[i * 2 + 1] = kNibble[b & 0x0F];
+        }
+        PW_LOG_INFO("Build ID: %s", hex);
+    }
+    config::Initialize(config_flash).IgnoreError();
+    log_control::SetLevel(config::Get(config::kLogLevel));
+    history::Initialize(flash).IgnoreError();
+    // "SDRAM" is a static array here (memory_region.cc).
+    memory_region::EnableSdram();
+    memory_bench::Initialize();
+    lcd::Initialize().IgnoreError();
+    strip_chart::StripChart chart(lcd::Framebuffer());
+    chart.Redraw();
+    capture::Initialize().IgnoreError();
+
+    // Same as Plot() in src/main.cpp.
+    auto show = [&] {
+        stats::Set(stats::Gauge::kDisplayUs, chart.last_update_us());
+        if (lcd_file != nullptr && !host::WritePpm(lcd_file, lcd::Framebuffer()))
+            std::perror(lcd_file);
+    };
+
+    using Clock = std::chrono::steady_clock;
+    auto     sample_period = std::chrono::milliseconds(config::Get(config::kSamplePeriodMs));
+    uint32_t batch_size    = config::Get(config::kBatchSize);
+
+    auto next_sample = Clock::now() + sample_period;
+    uint32_t in_batch = 0;
+    uint32_t index    = 0;
+    history::BatchSummary summary{};
+    int32_t  sum      = 0;
+
+    coro::Spawn(log_control::Drainer());
+
+    // Same supervision as the firmware, minus the IWDG: a starved task is
+    // only logged.
+    watchdog::Watch(watchdog::Task::kSampler,
+                    static_cast<uint32_t>(sample_period.count()) + 1000);
+    watchdog::Watch(watchdog::Task::kLogDrain, 1000);
+    watchdog::Start();
+
+    while (running) {
+        coro::RunReady();
+        rpc_services::Server().Poll();
+        watchdog::Service();
+
+        if (Clock::now() >= next_sample) {
+            next_sample += sample_period;
+            watchdog::CheckIn(watchdog::Task::kSampler);
+            stats::Increment(stats::Counter::kSamples);
+            // Same simulated readings as the firmware's Sampler.
+            const int32_t raw = static_cast<int32_t>(++index % 100u) - 50;
+            capture::Add({stats::UptimeMs(), static_cast<int16_t>(raw), 0});
+            chart.AddSample(static_cast<int16_t>(raw));
+            show();
+            sum         = in_batch == 0 ? raw : sum + raw;
+            summary.min = in_batch == 0 ? raw : std::min(summary.min, raw);
+            summary.max = in_batch == 0 ? raw : std::max(summary.max, raw);
+            if (++in_batch == batch_size) {
+                in_batch = 0;
+                stats::Increment(stats::Counter::kBatches);
+                PW_LOG_INFO("--- Batch #%u (t=%u ms) ---",
+                            (unsigned int)stats::Get(stats::Counter::kBatches),
+                            (unsigned int)stats::UptimeMs());
+                summary.batch = stats::Get(stats::Counter::kBatches);
+                summary.t_ms  = stats::UptimeMs();
+                summary.mean  = sum / static_cast<int32_t>(batch_size);
+                history::RecordBatch(summary).IgnoreError();
+                chart.AddBatch(static_cast<int16_t>(summary.mean),
+                               static_cast<int16_t>(summary.min),
+                               static_cast<int16_t>(summary.max));
+                show();
+                config::Commit().IgnoreError();
+                // Same as ApplyCadence() in src/main.cpp.
+                sample_period = std::chrono::milliseconds(config::Get(config::kSamplePeriodMs));
+                batch_size    = config::Get(config::kBatchSize);
+                watchdog::Watch(watchdog::Task::kSampler,
+                                static_cast<uint32_t>(sample_period.count()) + 1000);
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    log_control::Drain();
+    transport::Log::Flush();
+    if (link != nullptr)
+        unlink(link);
+    // Changes since the last batch are stored now.
+    config::Commit().IgnoreError();
+    for (const auto& [file, emulator] : {std::pair(flash_file, &flash),
+                                         std::pair(config_file, &config_flash)}) {
+        if (file != nullptr && !emulator->Save(file)) {
+            std::perror(file);
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,296 @@
+/**
+ * Throughput, thread safety and fragmentation of the fixed-block pools
+ * (src/block_pool.h).
+ *
+ *   pool_bench [operations] [threads]     (default 10000000 4)
+ *
+ *   throughput     Allocate()/Free() pairs on one BlockPool and one
+ *                  AtomicBlockPool, and a burst that empties the pool and
+ *                  refills it: host ns per operation
+ *   contention     |threads| threads allocate from one small AtomicBlockPool,
+ *                  stamp the block with their id and a sequence number, check
+ *                  the stamp is still intact and free it; a block handed out
+ *                  twice or a corrupted free list shows up as a foreign stamp
+ *                  or a wrong in_use count
+ *   fragmentation  size classes of AtomicBlockPools (32, 64 and 256 bytes,
+ *                  4 KB) shared by the firmware's variable-size records – log
+ *                  messages in bursts, RPC responses, capture chunks – with
+ *                  random lifetimes: bytes requested per byte of block held,
+ *                  allocation failures, fall-overs to a larger class, and the
+ *                  pools' total size against dedicated worst-case buffers for
+ *                  the same peaks.  The firmware keeps dedicated buffers
+ *                  (the log queue's ring, the RPC response buffer): for this
+ *                  mix they are the smaller choice.
+ *
+ * Exits non-zero on the first inconsistency.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "block_pool.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double NsSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+}
+
+int Fail(const char* what) {
+    std::printf("FAIL: %s\n", what);
+    return 1;
+}
+
+// ── Throughput ────────────────────────────────────────────────────────────────
+
+template <typename Pool>
+int Throughput(const char* name, Pool& pool, uint32_t operations) {
+    const auto t0 = Clock::now();
+    for (uint32_t i = 0; i < operations; ++i) {
+        void* p = pool.Allocate();
+        if (p == nullptr)
+            return Fail("allocate from an idle pool");
+        std::atomic_signal_fence(std::memory_order_seq_cst);  // keep the pair
+        pool.Free(p);
+    }
+    const double pair_ns = NsSince(t0) / operations;
+
+    std::array<void*, Pool::kCount> held;
+    const uint32_t rounds = std::max<uint32_t>(1, operations / Pool::kCount);
+    const auto t1 = Clock::now();
+    for (uint32_t r = 0; r < rounds; ++r) {
+        for (void*& p : held)
+            p = pool.Allocate();
+        if (pool.Allocate() != nullptr)
+            return Fail("allocate from a full pool");
+        for (void* p : held)
+            pool.Free(p);
+    }
+    const double burst_ns = NsSince(t1) / (rounds * 2.0 * Pool::kCount);
+
+    const PoolStats s = pool.stats();
+    if (s.in_use != 0 || s.peak != Pool::kCount)
+        return Fail("statistics");
+    std::printf("throughput: %-15s allocate + free %.1f ns; burst of %zu: %.1f ns per operation\n",
+                name, pair_ns, Pool::kCount, burst_ns);
+    return 0;
+}
+
+// ── Contention ────────────────────────────────────────────────────────────────
+
+using SmallPool = AtomicBlockPool<16, 8>;
+
+int Contention(uint32_t operations, unsigned threads) {
+    static SmallPool pool;
+    std::atomic<bool> failed{false};
+    std::atomic<uint64_t> empty{0};
+
+    std::vector<std::thread> workers;
+    const auto t0 = Clock::now();
+    for (unsigned id = 0; id < threads; ++id) {
+        workers.emplace_back([&, id] {
+            const uint32_t count = operations / threads;
+            for (uint32_t seq = 0; seq < count && !failed; ++seq) {
+                auto* p = static_cast<uint32_t*>(pool.Allocate());
+                if (p == nullptr) {
+                    empty.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+                const uint32_t stamp[4] = {id, seq, ~id, ~seq};
+                std::memcpy(p, stamp, sizeof(stamp));
+                std::this_thread::yield();
+                if (std::memcmp(p, stamp, sizeof(stamp)) != 0)
+                    failed = true;
+                pool.Free(p);
+            }
+        });
+    }
+    for (std::thread& t : workers)
+        t.join();
+    const double ns = NsSince(t0) / operations;
+
+    if (failed)
+        return Fail("block handed out twice");
+    const PoolStats s = pool.stats();
+    if (s.in_use != 0)
+        return Fail("in_use not back to zero");
+    if (s.allocations + s.failures != operations / threads * threads)
+        return Fail("allocations + failures != attempts");
+    std::printf("contention: %u threads, %u blocks: %.1f ns per allocate/check/free, "
+                "%llu attempts found the pool empty, peak %u in use\n",
+                threads, (unsigned)SmallPool::kCount, ns, (unsigned long long)empty.load(),
+                (unsigned)s.peak);
+    return 0;
+}
+
+// ── Fragmentation ─────────────────────────────────────────────────────────────
+
+// Size classes shared by the firmware's variable-size records, smallest first,
+// with fall-over to the next larger class when one is empty (4 KB in all).
+AtomicBlockPool<32, 32> small_blocks;
+AtomicBlockPool<64, 16> medium_blocks;
+AtomicBlockPool<256, 8> large_blocks;
+
+struct SizeClass {
+    size_t size;
+    void* (*allocate)();
+    void (*free)(void*);
+    PoolStats (*stats)();
+};
+
+const std::array<SizeClass, 3> kClasses = {{
+    {32, [] { return small_blocks.Allocate(); }, [](void* p) { small_blocks.Free(p); },
+     [] { return small_blocks.stats(); }},
+    {64, [] { return medium_blocks.Allocate(); }, [](void* p) { medium_blocks.Free(p); },
+     [] { return medium_blocks.stats(); }},
+    {256, [] { return large_blocks.Allocate(); }, [](void* p) { large_blocks.Free(p); },
+     [] { return large_blocks.stats(); }},
+}};
+
+struct Block {
+    void*  data       = nullptr;
+    size_t size_class = 0;
+};
+
+Block Allocate(size_t size) {
+    for (size_t c = 0; c < kClasses.size(); ++c) {
+        if (kClasses[c].size < size)
+            continue;
+        if (void* p = kClasses[c].allocate())
+            return {p, c};
+    }
+    return {};
+}
+
+struct User {
+    const char* name;
+    size_t      min_size, max_size;
+    uint32_t    per_1000;       // allocations per 1000 steps
+    uint32_t    burst;          // records per allocation event
+    uint32_t    max_lifetime;   // steps a record stays allocated
+};
+
+// Sizes as the firmware produces them: tokenized log messages of 8..40 bytes
+// in bursts (the boot banner, Stats.Dump), 160-byte RPC responses, capture
+// chunks of up to 20 samples.
+constexpr std::array<User, 3> kUsers = {{
+    {"log record",   8,  40, 60, 6, 40},
+    {"rpc response", 160, 160, 10, 1, 20},
+    {"capture chunk", 8, 160, 30, 1, 30},
+}};
+
+struct Live {
+    Block    block;
+    size_t   user;
+    size_t   requested;
+    uint32_t until;
+};
+
+int Fragmentation(uint32_t steps) {
+    std::minstd_rand  rng(3);
+    std::vector<Live> live;
+
+    std::array<uint32_t, kUsers.size()> live_per_user{}, peak_per_user{}, failures{};
+    uint64_t requested_sum = 0, held_sum = 0, attempts = 0;
+    size_t   peak_held     = 0;
+    for (uint32_t step = 0; step < steps; ++step) {
+        for (size_t i = 0; i < live.size();) {
+            if (live[i].until == step) {
+                --live_per_user[live[i].user];
+                kClasses[live[i].block.size_class].free(live[i].block.data);
+                live[i] = live.back();
+                live.pop_back();
+            } else {
+                ++i;
+            }
+        }
+        for (size_t u = 0; u < kUsers.size(); ++u) {
+            const User& user = kUsers[u];
+            if (rng() % 1000 >= user.per_1000)
+                continue;
+            for (uint32_t b = 0; b < user.burst; ++b) {
+                const size_t size = user.min_size + rng() % (user.max_size - user.min_size + 1);
+                ++attempts;
+                const Block block = Allocate(size);
+                if (block.data == nullptr) {
+                    ++failures[u];
+                    continue;
+                }
+                std::memset(block.data, int(u), size);
+                const auto until = static_cast<uint32_t>(step + 1 + rng() % user.max_lifetime);
+                live.push_back({block, u, size, until});
+                peak_per_user[u] = std::max(peak_per_user[u], ++live_per_user[u]);
+            }
+        }
+        size_t held = 0;
+        for (const Live& l : live) {
+            requested_sum += l.requested;
+            held          += kClasses[l.block.size_class].size;
+        }
+        held_sum += held;
+        peak_held = std::max(peak_held, held);
+    }
+    for (const Live& l : live)
+        kClasses[l.block.size_class].free(l.block.data);
+
+    std::printf("fragmentation: %u steps, %llu allocations, %.1f%% of the bytes held were "
+                "requested\n",
+                (unsigned)steps, (unsigned long long)attempts,
+                held_sum ? 100.0 * requested_sum / held_sum : 100.0);
+    size_t dedicated = 0;
+    for (size_t u = 0; u < kUsers.size(); ++u) {
+        std::printf("  %-14s peak %3u live, %u failed\n", kUsers[u].name,
+                    (unsigned)peak_per_user[u], (unsigned)failures[u]);
+        dedicated += peak_per_user[u] * kUsers[u].max_size;
+    }
+    size_t pooled = 0;
+    for (const SizeClass& c : kClasses) {
+        const PoolStats s = c.stats();
+        if (s.in_use != 0)
+            return Fail("block leaked");
+        pooled += size_t{s.block_size} * s.blocks;
+        std::printf("  pool %4u B × %2u: peak %2u, %u allocations, %u found it empty\n",
+                    (unsigned)s.block_size, (unsigned)s.blocks, (unsigned)s.peak,
+                    (unsigned)s.allocations, (unsigned)s.failures);
+    }
+    // A buffer per user must hold that user's own peak at its largest record
+    // size; the shared blocks only ever hold the peak of the sum.
+    std::printf("  pools %zu bytes, at most %zu held at once; dedicated buffers for the "
+                "same peaks: %zu bytes\n",
+                pooled, peak_held, dedicated);
+    return 0;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const uint32_t operations = argc > 1 ? std::strtoul(argv[1], nullptr, 0) : 10'000'000;
+    const unsigned threads    = argc > 2 ? std::strtoul(argv[2], nullptr, 0) : 4;
+    if (operations == 0 || threads == 0) {
+        std::fprintf(stderr, "usage: %s [operations] [threads]\n", argv[0]);
+        return 2;
+    }
+
+    static BlockPool<32, 64>       single;
+    static AtomicBlockPool<32, 64> atomic;
+    if (int r = Throughput("BlockPool", single, operations))
+        return r;
+    if (int r = Throughput("AtomicBlockPool", atomic, operations))
+        return r;
+    if (int r = Contention(operations, threads))
+        return r;
+    if (int r = Fragmentation(std::max<uint32_t>(1000, operations / 100)))
+        return r;
+    std::printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,36 @@
+// PPM snapshots – see ppm.h.
+
+#include "ppm.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace host {
+
+bool WritePpm(const char* path, const dma2d::Surface& surface) {
+    const std::string temporary = std::string(path) + ".tmp";
+    std::FILE* f = std::fopen(temporary.c_str(), "wb");
+    if (f == nullptr)
+        return false;
+    std::fprintf(f, "P6\n%u %u\n255\n", unsigned{surface.width}, unsigned{surface.height});
+    for (uint16_t y = 0; y < surface.height; ++y) {
+        for (uint16_t x = 0; x < surface.width; ++x) {
+            const uint16_t p = surface.pixels[size_t{y} * surface.stride + x];
+            // Replicate the high bits into the low ones so white stays 255.
+            const uint8_t r = static_cast<uint8_t>((p >> 11) << 3 | (p >> 13));
+            const uint8_t g = static_cast<uint8_t>((p >> 5 & 0x3F) << 2 | (p >> 9 & 0x3));
+            const uint8_t b = static_cast<uint8_t>((p & 0x1F) << 3 | (p >> 2 & 0x7));
+            const uint8_t rgb[3] = {r, g, b};
+            std::fwrite(rgb, 1, 3, f);
+        }
+    }
+    const bool written = std::ferror(f) == 0;
+    if (std::fclose(f) != 0 || !written) {
+        std::remove(temporary.c_str());
+        return false;
+    }
+    return std::rename(temporary.c_str(), path) == 0;
+}
+
+}  // namespace host
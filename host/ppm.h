@@ -0,0 +1,15 @@
+// Framebuffer snapshots as binary PPM (P6) images, which most image viewers
+// and `convert` open directly.
+
+#pragma once
+
+#include "dma2d.h"
+
+namespace host {
+
+// Writes |surface| (RGB565) to |path|, replacing it atomically so a viewer
+// that reloads the file never sees half an image.  False with errno set on
+// failure.
+bool WritePpm(const char* path, const dma2d::Surface& surface);
+
+}  // namespace host
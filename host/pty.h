@@ -0,0 +1,14 @@
+// Pseudo-terminal standing in for the ST-Link UART in host builds.
+//
+// pw::sys_io (sys_io_pty.cc) reads and writes the master side; host tools open
+// the slave side exactly like the board's /dev/ttyACM0.
+
+#pragma once
+
+namespace host {
+
+// Creates the pty and switches it to raw mode.  Returns the slave path (e.g.
+// /dev/pts/7), or nullptr with errno set.  Must be called before any I/O.
+const char* OpenPty();
+
+}  // namespace host
@@ -0,0 +1,246 @@
+/**
+ * Replays a recorded sample stream through the firmware's batch processing
+ * (src/batch.h), as fast as the host runs it, on a virtual clock.
+ *
+ *   replay [--log-file FILE] [--config FILE] [--repeat N] CAPTURE
+ *
+ * CAPTURE is what `tools/rpc_client.py PORT capture-read` prints – one
+ * reading per line – with configuration changes to inject between them:
+ *
+ *   t_ms,raw_value,jitter_us         header, optional
+ *   500,-49,0                        a reading
+ *   8000,set,batch_size,8            Config.Set at 8000 ms
+ *   # comment
+ *
+ * Rows are replayed in file order.  stats::UptimeMs() follows their t_ms,
+ * so everything stamped with it (history records) sees the device's times.
+ * Readings are grouped into batches of the configured size starting with
+ * the first one, and each batch goes through the sampler's and processor's
+ * steps of src/main.cpp: batch::TakeCadence(), batch::Handle() into an
+ * emulated history flash, config::Commit().  A "set" row takes effect like
+ * the RPC: log_level at once, batch_size and sample_period_ms at the next
+ * batch.  Readings of a last, incomplete batch are not processed.
+ *
+ * The tokenized log is the device's, message for message, and goes to
+ * --log-file ($-prefixed Base64 lines; decode with the host or firmware
+ * token database).  Without it every message is still encoded and queued,
+ * then dropped by the file transport.  --config starts from a configuration
+ * store image (as written by stm32f429i_demo_host --config), and --repeat
+ * plays the capture N times back to back, shifted in time.
+ *
+ * On stderr: readings, batches, log messages, wall time and readings per
+ * second.  Run it under perf or valgrind to profile the batch path on a
+ * real workload.  Exits 2 on a usage or file error.
+ */
+
+#include "log_config.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "batch.h"
+#include "config.h"
+#include "flash_emulator.h"
+#include "history.h"
+#include "log_control.h"
+#include "stats.h"
+#include "transport.h"
+
+#undef PW_LOG_MODULE_NAME
+#define PW_LOG_MODULE_NAME "DEMO"
+
+#ifndef DEMO_LOG_TRANSPORT_FILE
+#error "replay is built with DEMO_LOG_TRANSPORT_FILE (host/CMakeLists.txt)"
+#endif
+
+namespace {
+
+// A reading, or a configuration change (|key| < config::kKeyCount).
+struct Row {
+    uint32_t t_ms;
+    int16_t  raw_value;
+    uint32_t jitter_us;
+    uint8_t  key;
+    uint32_t value;
+};
+
+constexpr uint8_t kReading = UINT8_MAX;
+
+// Parses one line of CAPTURE into |row|; false for a header, comment or
+// blank line.  Prints the error and exits on a malformed line.
+bool Parse(const char* path, int line_number, const std::string& line, Row& row) {
+    if (line.empty() || line[0] == '#' || line.starts_with("t_ms"))
+        return false;
+    auto fail = [&](const char* what) {
+        std::fprintf(stderr, "%s:%d: %s: %s\n", path, line_number, what, line.c_str());
+        std::exit(2);
+    };
+
+    unsigned long t_ms;
+    char          name[32];
+    unsigned long value;
+    long          raw;
+    unsigned long jitter;
+    if (std::sscanf(line.c_str(), "%lu,set,%31[^,],%lu", &t_ms, name, &value) == 3) {
+        uint8_t id = 0;
+        while (id < config::kKeyCount && std::strcmp(config::kEntries[id].name, name) != 0)
+            ++id;
+        if (id == config::kKeyCount)
+            fail("unknown configuration key");
+        if (!config::Check(id, static_cast<uint32_t>(value)).ok())
+            fail("value not allowed for the key");
+        row = {static_cast<uint32_t>(t_ms), 0, 0, id, static_cast<uint32_t>(value)};
+        return true;
+    }
+    if (std::sscanf(line.c_str(), "%lu,%ld,%lu", &t_ms, &raw, &jitter) == 3 &&
+        raw >= INT16_MIN && raw <= INT16_MAX) {
+        row = {static_cast<uint32_t>(t_ms), static_cast<int16_t>(raw),
+               static_cast<uint32_t>(jitter), kReading, 0};
+        return true;
+    }
+    fail("neither a reading nor a \"set\" row");
+    return false;
+}
+
+void Drain() { log_control::Drain(); }
+
+int Usage() {
+    std::fprintf(stderr,
+                 "usage: replay [--log-file FILE] [--config FILE] [--repeat N] CAPTURE\n");
+    return 2;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const char* log_file    = nullptr;
+    const char* config_file = nullptr;
+    const char* capture     = nullptr;
+    int         repeat      = 1;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--log-file") == 0 && i + 1 < argc)
+            log_file = argv[++i];
+        else if (std::strcmp(argv[i], "--config") == 0 && i + 1 < argc)
+            config_file = argv[++i];
+        else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+            repeat = std::atoi(argv[++i]);
+        else if (argv[i][0] != '-' && capture == nullptr)
+            capture = argv[i];
+        else
+            return Usage();
+    }
+    if (capture == nullptr || repeat < 1)
+        return Usage();
+
+    static host::FlashEmulator flash(4, 128 * 1024);         // sectors 20–23 of the STM32F429
+    static host::FlashEmulator config_flash(2, 128 * 1024);  // sectors 18–19
+    if (config_file != nullptr && !config_flash.Load(config_file)) {
+        std::fprintf(stderr, "%s: not a %zu-byte flash image\n", config_file,
+                     config_flash.sector_count() * config_flash.sector_size());
+        return 2;
+    }
+    if (log_file != nullptr && !transport::File::Open(log_file)) {
+        std::perror(log_file);
+        return 2;
+    }
+
+    std::vector<Row> rows;
+    {
+        std::ifstream in(capture);
+        if (!in) {
+            std::perror(capture);
+            return 2;
+        }
+        std::string line;
+        Row         row;
+        for (int n = 1; std::getline(in, line); ++n) {
+            if (!line.empty() && line.back() == '\r')
+                line.pop_back();
+            if (Parse(capture, n, line, row))
+                rows.push_back(row);
+        }
+    }
+    if (rows.empty()) {
+        std::fprintf(stderr, "%s: no readings\n", capture);
+        return 2;
+    }
+
+    // Boot, as far as the batch path is concerned.
+    stats::SetUptimeMs(rows.front().t_ms);
+    config::Initialize(config_flash).IgnoreError();  // logs its own errors
+    log_control::SetLevel(config::Get(config::kLogLevel));
+    history::Initialize(flash).IgnoreError();
+    auto   sample_period = std::chrono::milliseconds(config::Get(config::kSamplePeriodMs));
+    size_t batch_size    = config::Get(config::kBatchSize);
+    log_control::Drain();
+
+    // Each repetition starts one sample period after the previous one ended.
+    const uint32_t span = rows.back().t_ms - rows.front().t_ms +
+                          static_cast<uint32_t>(sample_period.count());
+
+    std::vector<batch::SensorReading> readings;
+    readings.reserve(config::kEntries[config::kBatchSize.id].max);
+    size_t   in_batch = 0;
+    uint64_t samples  = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < repeat; ++round) {
+        for (const Row& row : rows) {
+            const uint32_t t_ms = row.t_ms + static_cast<uint32_t>(round) * span;
+            stats::SetUptimeMs(t_ms);
+
+            if (row.key != kReading) {
+                // As Rpc "Config.Set" (rpc_services.cc) does it.
+                config::Set(row.key, row.value).IgnoreError();  // checked by Parse()
+                if (row.key == config::kLogLevel.id)
+                    log_control::SetLevel(config::Get(config::kLogLevel));
+                continue;
+            }
+
+            // The sampler (main.cpp's Sampler::Take() and sampler fiber).
+            ++samples;
+            stats::Increment(stats::Counter::kSamples);
+            if (row.jitter_us > stats::Get(stats::Gauge::kJitterMaxUs))
+                stats::Set(stats::Gauge::kJitterMaxUs, row.jitter_us);
+            in_batch = in_batch + 1 < batch_size ? in_batch + 1 : 0;
+            readings.push_back({t_ms, row.raw_value, row.jitter_us, in_batch == 0});
+            if (!readings.back().batch_end)
+                continue;
+            batch::TakeCadence(sample_period, batch_size);
+
+            // The processor fiber; the log drainer runs where it would yield.
+            batch::Handle(readings, Drain);
+            readings.clear();
+            const pw::Status status = config::Commit();
+            if (!status.ok())
+                PW_LOG_WARN("config: not stored (%s), retrying after the next batch",
+                            status.str());
+            log_control::Drain();
+        }
+    }
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    log_control::Drain();
+    transport::Log::Flush();
+
+    const double device_s = static_cast<double>(repeat) * span / 1000.0;
+    std::fprintf(stderr,
+                 "%" PRIu64 " readings, %u batches, %u log messages in %.3f s: "
+                 "%.0f readings/s, %.0f× the device's %.0f s\n",
+                 samples, (unsigned int)stats::Get(stats::Counter::kBatches),
+                 (unsigned int)log_control::Emitted(), seconds, samples / seconds,
+                 device_s / seconds, device_s);
+    if (!readings.empty())
+        std::fprintf(stderr, "%zu readings of an incomplete last batch not processed\n",
+                     readings.size());
+    if (log_control::Dropped() != 0)
+        std::fprintf(stderr, "%u log messages dropped: queue full\n",
+                     (unsigned int)log_control::Dropped());
+    return 0;
+}
@@ -0,0 +1,146 @@
+/**
+ * Rendering check and per-update cost of the LCD strip chart
+ * (src/strip_chart.h), with the CPU stand-in for the DMA2D (src/dma2d.cc).
+ *
+ *   strip_chart_render [readings] [PPM directory]     (default 2000, no images)
+ *
+ * Feeds |readings| simulated readings – the firmware's sawtooth with noise
+ * and the odd out-of-range spike – into a chart on a 240 × 320 framebuffer,
+ * with a batch summary every 16 readings, as on the board.
+ *
+ *   check   after every update the framebuffer must equal a Redraw() from
+ *           scratch; since each update starts from a verified picture, this
+ *           covers any sequence of updates
+ *   cost    pixels written per update (what the DMA2D has to move on the
+ *           board, independent of clocks) against a full redraw, and host
+ *           time per update
+ *   images  with a directory, one PPM per batch: frame_NNNNNN.ppm, numbered
+ *           by reading (e.g. `convert -delay 8 DIR/frame_*.ppm chart.gif`)
+ *
+ * Exits non-zero on the first mismatch.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "dma2d.h"
+#include "ppm.h"
+#include "strip_chart.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using strip_chart::StripChart;
+
+constexpr uint32_t kBatchSize = 16;
+
+double UsSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+}
+
+struct Cost {
+    uint64_t updates = 0;
+    uint64_t pixels  = 0;
+    uint32_t most    = 0;
+    double   us      = 0;
+
+    void Add(uint32_t update_pixels, double update_us) {
+        ++updates;
+        pixels += update_pixels;
+        most    = std::max(most, update_pixels);
+        us     += update_us;
+    }
+
+    void Print(const char* what, uint32_t redraw_pixels) const {
+        if (updates == 0)
+            return;
+        const double mean = static_cast<double>(pixels) / static_cast<double>(updates);
+        std::printf("%s: %llu updates, %.0f pixels each (max %u, %.1f%% of a redraw), "
+                    "%.2f us on the host\n",
+                    what, (unsigned long long)updates, mean, (unsigned)most,
+                    100.0 * mean / redraw_pixels, us / static_cast<double>(updates));
+    }
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    const uint32_t readings = argc > 1 ? static_cast<uint32_t>(std::atol(argv[1])) : 2'000;
+    const char*    dir      = argc > 2 ? argv[2] : nullptr;
+    if (argc > 3 || readings == 0) {
+        std::fprintf(stderr, "Usage: %s [readings] [PPM directory]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<uint16_t> pixels(size_t{StripChart::kWidth} * StripChart::kHeight);
+    const dma2d::Surface  surface{pixels.data(), StripChart::kWidth, StripChart::kHeight,
+                                  StripChart::kWidth};
+    StripChart chart(surface);
+
+    uint32_t before = dma2d::PixelsWritten();
+    chart.Redraw();
+    const uint32_t redraw_pixels = dma2d::PixelsWritten() - before;
+
+    std::vector<uint16_t> incremental(pixels.size());
+    std::minstd_rand      rng(1);
+    Cost                  samples, batches;
+    int16_t               batch[kBatchSize];
+
+    // Runs |update|, records its cost and compares the result with a redraw.
+    auto check = [&](Cost& cost, auto update) {
+        before        = dma2d::PixelsWritten();
+        const auto t0 = Clock::now();
+        update();
+        cost.Add(dma2d::PixelsWritten() - before, UsSince(t0));
+
+        incremental = pixels;
+        chart.Redraw();
+        return incremental == pixels;
+    };
+
+    for (uint32_t i = 1; i <= readings; ++i) {
+        int32_t value = static_cast<int32_t>(i % 100u) - 50 + static_cast<int32_t>(rng() % 17) - 8;
+        if (rng() % 50 == 0)
+            value = rng() % 2 ? 100 : -100;  // clamped by the chart
+        batch[(i - 1) % kBatchSize] = static_cast<int16_t>(value);
+
+        if (!check(samples, [&] { chart.AddSample(static_cast<int16_t>(value)); })) {
+            std::printf("FAIL: reading %u: incremental picture differs from a redraw\n", i);
+            return 1;
+        }
+        if (i % kBatchSize != 0)
+            continue;
+
+        int32_t sum = 0;
+        for (int16_t v : batch)
+            sum += v;
+        const auto [min, max] = std::minmax_element(std::begin(batch), std::end(batch));
+        if (!check(batches, [&] {
+                chart.AddBatch(static_cast<int16_t>(sum / int32_t{kBatchSize}), *min, *max);
+            })) {
+            std::printf("FAIL: batch %u: incremental picture differs from a redraw\n",
+                        i / kBatchSize);
+            return 1;
+        }
+
+        if (dir != nullptr) {
+            char path[4096];
+            std::snprintf(path, sizeof(path), "%s/frame_%06u.ppm", dir, i);
+            if (!host::WritePpm(path, surface)) {
+                std::perror(path);
+                return 1;
+            }
+        }
+    }
+
+    std::printf("redraw: %u pixels\n", redraw_pixels);
+    samples.Print("reading", redraw_pixels);
+    batches.Print("batch", redraw_pixels);
+    std::printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,99 @@
+/**
+ * pw_sys_io backend for host builds – the master side of a pseudo-terminal
+ * replaces Board::stlink::Uart (see log_backend.cc for the board version).
+ *
+ * When the pty buffer is full, output waits for the client like the UART
+ * waits for its FIFO.  If nobody drains it within 100 ms, bytes are dropped
+ * until there is room again, so running without a client does not stall.
+ */
+
+#include "pty.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "pw_sys_io/sys_io.h"
+
+namespace {
+
+int  master_fd = -1;
+bool draining  = true;  // false after a write timed out
+
+}  // namespace
+
+namespace host {
+
+const char* OpenPty() {
+    master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master_fd < 0 || grantpt(master_fd) != 0 || unlockpt(master_fd) != 0)
+        return nullptr;
+
+    const char* name = ptsname(master_fd);
+    if (name == nullptr)
+        return nullptr;
+
+    // Raw mode is a property of the slave's line discipline: no echo, no
+    // CR/LF translation, so HDLC frames pass through unchanged.
+    const int slave_fd = open(name, O_RDWR | O_NOCTTY);
+    if (slave_fd < 0)
+        return nullptr;
+    termios tio;
+    tcgetattr(slave_fd, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(slave_fd, TCSANOW, &tio);
+    close(slave_fd);
+
+    fcntl(master_fd, F_SETFL, fcntl(master_fd, F_GETFL) | O_NONBLOCK);
+    return name;
+}
+
+}  // namespace host
+
+namespace pw::sys_io {
+
+// ── Output ────────────────────────────────────────────────────────────────────
+
+Status WriteByte(std::byte b) {
+    for (;;) {
+        if (write(master_fd, &b, 1) == 1) {
+            draining = true;
+            return OkStatus();
+        }
+        if (errno != EAGAIN || !draining)
+            return Status::Unavailable();
+        pollfd p{master_fd, POLLOUT, 0};
+        if (poll(&p, 1, 100) <= 0) {
+            draining = false;
+            return Status::Unavailable();
+        }
+    }
+}
+
+StatusWithSize WriteLine(std::string_view s) {
+    for (char c : s) {
+        WriteByte(static_cast<std::byte>(c)).IgnoreError();
+    }
+    WriteByte(std::byte{'\n'}).IgnoreError();
+    return StatusWithSize(s.size() + 1);
+}
+
+// ── Input ─────────────────────────────────────────────────────────────────────
+
+Status TryReadByte(std::byte* dest) {
+    // EIO: no client has the slave side open.
+    return read(master_fd, dest, 1) == 1 ? OkStatus() : Status::Unavailable();
+}
+
+Status ReadByte(std::byte* dest) {
+    while (!TryReadByte(dest).ok()) {
+        pollfd p{master_fd, POLLIN, 0};
+        poll(&p, 1, -1);
+    }
+    return OkStatus();
+}
+
+}  // namespace pw::sys_io
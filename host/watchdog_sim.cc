@@ -0,0 +1,166 @@
+/**
+ * The watchdog supervisor (src/watchdog.h) against a fake clock.
+ *
+ *   watchdog_sim
+ *
+ * Each scenario runs the firmware's deadlines at the default 500 ms sample
+ * period (src/main.cpp) in 1 ms steps: tasks check in on their own
+ * schedule, Service() is polled by the UART fiber, and a model of the IWDG
+ * resets the board when kicks stop for longer than its period.  The IWDG is modelled with the fastest LSI the
+ * datasheet allows (47 kHz instead of 32 kHz), so "no reset" holds for every
+ * part.
+ *
+ *   healthy        every task on schedule for ten minutes: no reset, and no
+ *                  more kicks than one per kKickIntervalMs
+ *   slow batch     the processor blocked 4.5 s by a history and a config
+ *                  sector erase: no reset
+ *   starved        the processor stops at 10 s: the supervisor names it and
+ *                  the board resets within its deadline plus the IWDG period
+ *   busy service   Service() polled every step while no task checks in:
+ *                  polling alone does not keep the board alive
+ *   stalled        the UART fiber stops calling Service() at 10 s: reset
+ *                  without a starved task, one IWDG period later
+ *
+ * Exits non-zero if a scenario ends differently than expected.
+ */
+
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+
+#include "watchdog.h"
+
+namespace {
+
+using watchdog::Supervisor;
+using watchdog::Task;
+
+// IWDG period with the fastest LSI.
+constexpr uint32_t kShortestTimeoutMs = watchdog::kTimeoutMs * 32 / 47;
+
+struct Schedule {
+    uint32_t sampler_period   = 500;
+    uint32_t drain_period     = 1;
+    uint32_t processor_stall  = 0;  // ms without check-in, once, at stall_at
+    uint32_t stall_at         = 0;
+    uint32_t processor_stops  = UINT32_MAX;
+    uint32_t all_stop         = UINT32_MAX;
+    uint32_t service_stops    = UINT32_MAX;
+};
+
+struct Outcome {
+    std::optional<uint32_t> reset_at;
+    std::optional<Task>     starved;
+    uint32_t                kicks;
+    uint32_t                longest_gap;  // between kicks
+};
+
+Outcome Run(const Schedule& s, uint32_t duration_ms) {
+    Supervisor sup;
+    sup.Watch(Task::kSampler, 1500, 0);
+    sup.Watch(Task::kProcessor, 5500, 0);
+    sup.Watch(Task::kLogDrain, 1000, 0);
+
+    Outcome  out{};
+    uint32_t last_kick = 0;  // watchdog::Start() kicks once
+    for (uint32_t now = 1; now <= duration_ms; ++now) {
+        if (now < s.all_stop) {
+            if (now % s.sampler_period == 0)
+                sup.CheckIn(Task::kSampler, now);
+            const bool stalled = now >= s.stall_at && now < s.stall_at + s.processor_stall;
+            // The processor receives each reading the sampler sends.
+            if (now % s.sampler_period == 0 && !stalled && now < s.processor_stops)
+                sup.CheckIn(Task::kProcessor, now);
+            if (now % s.drain_period == 0)
+                sup.CheckIn(Task::kLogDrain, now);
+        }
+        if (now < s.service_stops && sup.Poll(now)) {
+            if (now - last_kick > out.longest_gap)
+                out.longest_gap = now - last_kick;
+            last_kick = now;
+        }
+        if (now - last_kick >= kShortestTimeoutMs) {
+            out.reset_at = now;
+            break;
+        }
+    }
+    out.starved = sup.starved();
+    out.kicks   = sup.kicks();
+    return out;
+}
+
+int failures = 0;
+
+void Expect(const char* scenario, bool ok, const char* what) {
+    if (!ok) {
+        std::printf("FAIL: %s: %s\n", scenario, what);
+        ++failures;
+    }
+}
+
+void Print(const char* scenario, const Outcome& o) {
+    std::printf("%-13s ", scenario);
+    if (o.reset_at)
+        std::printf("reset at %6u ms", (unsigned)*o.reset_at);
+    else
+        std::printf("no reset         ");
+    std::printf(", starved: %-9s, %6u kicks, longest gap %u ms\n",
+                o.starved ? watchdog::Name(*o.starved) : "-", (unsigned)o.kicks,
+                (unsigned)o.longest_gap);
+}
+
+}  // namespace
+
+int main() {
+    std::printf("IWDG period %u ms (%u ms with the fastest LSI), kicks at most every %u ms\n",
+                (unsigned)watchdog::kTimeoutMs, (unsigned)kShortestTimeoutMs,
+                (unsigned)watchdog::kKickIntervalMs);
+
+    {
+        const uint32_t duration = 10 * 60 * 1000;
+        const Outcome  o        = Run({}, duration);
+        Print("healthy", o);
+        Expect("healthy", !o.reset_at && !o.starved, "reset");
+        Expect("healthy", o.kicks <= duration / watchdog::kKickIntervalMs + 1, "kicked too often");
+        Expect("healthy", o.longest_gap < kShortestTimeoutMs / 2, "kicks too far apart");
+    }
+    {
+        Schedule s;
+        s.stall_at        = 10'000;
+        s.processor_stall = 4500;
+        const Outcome o   = Run(s, 60'000);
+        Print("slow batch", o);
+        Expect("slow batch", !o.reset_at && !o.starved, "reset");
+    }
+    {
+        Schedule s;
+        s.processor_stops = 10'000;
+        const Outcome o   = Run(s, 60'000);
+        Print("starved", o);
+        Expect("starved", o.starved == Task::kProcessor, "processor not named");
+        Expect("starved", o.reset_at && *o.reset_at <= 10'000 + 5500 + watchdog::kTimeoutMs,
+               "no reset in time");
+    }
+    {
+        Schedule s;
+        s.all_stop      = 10'000;
+        const Outcome o = Run(s, 60'000);
+        Print("busy service", o);
+        Expect("busy service", o.starved.has_value(), "no starved task");
+        Expect("busy service", o.reset_at.has_value(), "no reset");
+    }
+    {
+        Schedule s;
+        s.service_stops = 10'000;
+        const Outcome o = Run(s, 60'000);
+        Print("stalled", o);
+        Expect("stalled", !o.starved, "task blamed");
+        Expect("stalled", o.reset_at && *o.reset_at <= 10'000 + kShortestTimeoutMs,
+               "no reset in time");
+    }
+
+    if (failures != 0)
+        return 1;
+    std::printf("OK\n");
+    return 0;
+}
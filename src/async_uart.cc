@@ -0,0 +1,128 @@
+// Awaitable UART output – see async_uart.h.
+
+#include "async_uart.h"
+
+#include <utility>
+
+#include "coro.h"
+
+#ifdef DEMO_HOST_BUILD
+#include "pw_sys_io/sys_io.h"
+#else
+#include <modm/board.hpp>
+#include <modm/processing/fiber.hpp>
+#endif
+
+namespace async_uart {
+
+#ifdef DEMO_HOST_BUILD
+
+void Initialize() {}
+
+bool Idle() { return true; }
+
+void Stop() {}
+
+bool WriteAwaiter::await_ready() {
+    for (std::byte b : data_)
+        pw::sys_io::WriteByte(b).IgnoreError();
+    return true;
+}
+
+bool WriteAwaiter::await_suspend(std::coroutine_handle<>) { return false; }
+
+#else
+
+namespace {
+
+// USART1_TX request: DMA2 stream 7, channel 4 (RM0090, table 43).
+constexpr uint32_t kAllStream7Flags = DMA_HIFCR_CTCIF7 | DMA_HIFCR_CHTIF7 | DMA_HIFCR_CTEIF7 |
+                                      DMA_HIFCR_CDMEIF7 | DMA_HIFCR_CFEIF7;
+
+// The transfer queued behind the running one and the coroutine waiting for
+// it.  Written by thread code inside a critical section, consumed by the ISR.
+pw::span<const std::byte> pending;
+std::coroutine_handle<>   waiter;
+
+// EN is cleared by hardware at the end of a transfer, independent of the
+// interrupt, so this also works with interrupts disabled (crash handler).
+bool Running() { return DMA2_Stream7->CR & DMA_SxCR_EN; }
+
+void Start(pw::span<const std::byte> data) {
+    if (data.empty())
+        return;
+    DMA2->HIFCR         = kAllStream7Flags;
+    DMA2_Stream7->M0AR  = reinterpret_cast<uint32_t>(data.data());
+    DMA2_Stream7->NDTR  = static_cast<uint32_t>(data.size());
+    DMA2_Stream7->CR   |= DMA_SxCR_EN;
+}
+
+}  // namespace
+
+void Initialize() {
+    RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN;
+    __DSB();
+    DMA2_Stream7->CR  = 0;
+    DMA2_Stream7->PAR = reinterpret_cast<uint32_t>(&USART1->DR);
+    // Channel 4, memory → peripheral, byte-wise, memory increment, interrupt
+    // on transfer complete or error.
+    DMA2_Stream7->CR  = (4u << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_DIR_0 | DMA_SxCR_MINC |
+                        DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+    // TXE raises a DMA request only while the stream is enabled, so this does
+    // not disturb modm's interrupt-driven byte output in between.
+    USART1->CR3 |= USART_CR3_DMAT;
+    NVIC_EnableIRQ(DMA2_Stream7_IRQn);
+}
+
+bool Idle() { return !Running() && !waiter; }
+
+// The interrupt that would start |pending| no longer runs, so do it here.
+void Stop() {
+    while (Running()) {}
+    if (waiter) {
+        Start(pending);
+        while (Running()) {}
+        waiter = {};
+    }
+    DMA2->HIFCR  = kAllStream7Flags;
+    USART1->CR3 &= ~USART_CR3_DMAT;
+}
+
+bool WriteAwaiter::await_ready() {
+    if (Running())
+        return false;
+    // Bytes written through modm's buffer (RPC replies) must leave first.
+    while (!Board::stlink::Uart::isWriteFinished())
+        modm::this_fiber::yield();
+    Start(data_);
+    return true;
+}
+
+bool WriteAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    modm::atomic::Lock lock;
+    if (!Running()) {
+        // Finished between await_ready() and here; its interrupt will find no
+        // waiter.
+        Start(data_);
+        return false;
+    }
+    pending = data_;
+    waiter  = handle;
+    return true;
+}
+
+// A transfer error also ends the transfer (EN cleared); the bytes are lost
+// like any other UART output error, but the waiting coroutine still resumes.
+MODM_ISR(DMA2_Stream7) {
+    if (!(DMA2->HISR & (DMA_HISR_TCIF7 | DMA_HISR_TEIF7)))
+        return;
+    DMA2->HIFCR = kAllStream7Flags;
+    if (waiter) {
+        Start(pending);
+        coro::Schedule(std::exchange(waiter, {}));
+    }
+}
+
+#endif  // DEMO_HOST_BUILD
+
+}  // namespace async_uart
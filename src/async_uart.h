@@ -0,0 +1,61 @@
+// Awaitable UART output for coroutines (coro.h).
+//
+//   co_await async_uart::Write(line);   // resumes once |line| is on its way
+//   … prepare the next line while the UART sends this one …
+//   co_await async_uart::Flush();       // resumes once everything is sent
+//
+// Transfers run on DMA2 stream 7 (USART1_TX, the ST-Link UART) and their
+// transfer-complete interrupt resumes the waiting coroutine through
+// coro::Schedule(), so the CPU is free while bytes go out.  Write() is
+// write-behind: it waits only for the *previous* transfer, starts this one and
+// continues.  The caller must therefore leave |data| untouched until its next
+// Write() or Flush() has completed (alternate between two buffers), and |data|
+// must be in DMA-reachable RAM (not CCM).  At most 65535 bytes per Write().
+//
+// Byte-wise output (pw::sys_io::WriteByte: RPC replies) waits for Idle()
+// first, and a DMA transfer waits until modm's UART buffer has drained, so
+// the two paths never interleave on the wire; the crash handler calls Stop()
+// instead.  Only one coroutine may use the writer.
+//
+// Host builds (DEMO_HOST_BUILD) write synchronously through pw::sys_io and
+// never suspend.
+
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+
+#include "pw_span/span.h"
+
+namespace async_uart {
+
+// Sets up the DMA stream and its interrupt.  Call once after the UART itself
+// has been initialised.
+void Initialize();
+
+// True when no transfer is running or waiting to start.
+bool Idle();
+
+// For the crash handler, with interrupts disabled: sends the running and the
+// queued transfer to the end by polling and turns DMA requests off.  The
+// waiting coroutine is never resumed.
+void Stop();
+
+class WriteAwaiter {
+public:
+    explicit WriteAwaiter(pw::span<const std::byte> data) : data_(data) {}
+
+    bool await_ready();
+    bool await_suspend(std::coroutine_handle<> handle);
+    void await_resume() const {}
+
+private:
+    pw::span<const std::byte> data_;
+};
+
+inline WriteAwaiter Write(pw::span<const std::byte> data) { return WriteAwaiter(data); }
+
+// An empty Write(): only waits for the running transfer.
+inline WriteAwaiter Flush() { return WriteAwaiter({}); }
+
+}  // namespace async_uart
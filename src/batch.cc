@@ -0,0 +1,72 @@
+// Batch processing – see batch.h.
+
+#include "log_config.h"
+
+#include "batch.h"
+
+#include "config.h"
+#include "pw_assert/check.h"
+#include "stats.h"
+
+// The messages moved here from main.cpp; same module, same tokens.
+#undef PW_LOG_MODULE_NAME
+#define PW_LOG_MODULE_NAME "DEMO"
+
+namespace batch {
+
+pw::Status Process(pw::span<const SensorReading> readings, history::BatchSummary& summary,
+                   void (*yield)()) {
+    if (readings.empty()) {
+        PW_LOG_WARN("ProcessBatch called with an empty span");
+        return pw::Status::InvalidArgument();
+    }
+
+    for (const SensorReading& r : readings) {
+        // Fix: %-6lu -> %-6u (uint32_t ist unter Clang/ARM 'unsigned int')
+        PW_LOG_DEBUG("  t=%-6u  raw=%d", (unsigned int)r.timestamp_ms, r.raw_value);
+        yield();
+    }
+    Summarize(readings, summary);
+
+    // Pigweed kümmert sich um alles: Formatierung, Typ-Sicherheit und Logging.
+    PW_LOG_INFO("batch mean=%d  n=%u", (int)summary.mean, (unsigned int)readings.size());
+    PW_LOG_INFO("sampling jitter max=%u us mean=%u us",
+                (unsigned int)summary.jitter_max_us,
+                (unsigned int)summary.jitter_mean_us);
+    return pw::OkStatus();
+}
+
+history::BatchSummary Handle(pw::span<const SensorReading> readings, void (*yield)()) {
+    stats::Increment(stats::Counter::kBatches);
+    const uint32_t number = stats::Get(stats::Counter::kBatches);
+    // Fix: %lu -> %u für Batch-Counter und Zeit
+    PW_LOG_INFO("--- Batch #%u (t=%u ms) ---",
+                (unsigned int)number, (unsigned int)readings.back().timestamp_ms);
+
+    history::BatchSummary summary{};
+    summary.batch = number;
+    const pw::Status status = Process(readings, summary, yield);
+    PW_CHECK_OK(status, "ProcessBatch failed");
+
+    // About every 5000th batch fills a sector and starts an erase of the next
+    // (1–2 s, yields to the other fibers).
+    const pw::Status recorded = history::RecordBatch(summary);
+    if (!recorded.ok())
+        PW_LOG_WARN("history: batch not recorded (%s)", recorded.str());
+    return summary;
+}
+
+bool TakeCadence(std::chrono::milliseconds& sample_period, size_t& batch_size) {
+    const auto   period = std::chrono::milliseconds(config::Get(config::kSamplePeriodMs));
+    const size_t size   = config::Get(config::kBatchSize);
+    if (period == sample_period && size == batch_size)
+        return false;
+    PW_LOG_INFO("cadence: %u ms -> %u ms, batches of %u -> %u",
+                (unsigned int)sample_period.count(), (unsigned int)period.count(),
+                (unsigned int)batch_size, (unsigned int)size);
+    sample_period = period;
+    batch_size    = size;
+    return true;
+}
+
+}  // namespace batch
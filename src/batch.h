@@ -0,0 +1,74 @@
+// Sensor readings and what the processor does with a batch of them.
+//
+//   history::BatchSummary s{};
+//   batch::Summarize(readings, s);         // all but s.batch, no logging
+//
+//   s = batch::Handle(readings, yield);    // logs, summarizes, records in flash
+//
+// Summarize() is inline, so the benchmarks (bench.h) time it without the
+// logger.  Handle() and TakeCadence() (batch.cc) are the processor's and
+// sampler's steps, shared by main.cpp and the capture replay
+// (host/replay.cc), so both write the same log.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "history.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace batch {
+
+struct SensorReading {
+    uint32_t timestamp_ms;
+    int16_t  raw_value;
+    uint32_t jitter_us;   // |interval since the previous reading − sample_period|
+    bool     batch_end;   // the last reading of its batch
+};
+
+// Fills |summary| (all but the batch number); |readings| must not be empty.
+inline void Summarize(pw::span<const SensorReading> readings, history::BatchSummary& summary) {
+    int32_t  sum        = 0;
+    int32_t  min        = INT16_MAX;
+    int32_t  max        = INT16_MIN;
+    uint32_t jitter_sum = 0;
+    uint32_t jitter_max = 0;
+    for (const SensorReading& r : readings) {
+        sum        += r.raw_value;
+        min         = std::min<int32_t>(min, r.raw_value);
+        max         = std::max<int32_t>(max, r.raw_value);
+        jitter_sum += r.jitter_us;
+        jitter_max  = std::max(jitter_max, r.jitter_us);
+    }
+
+    const auto n           = static_cast<uint32_t>(readings.size());
+    summary.t_ms           = readings.back().timestamp_ms;
+    summary.mean           = sum / static_cast<int32_t>(n);
+    summary.min            = min;
+    summary.max            = max;
+    summary.jitter_max_us  = jitter_max;
+    summary.jitter_mean_us = jitter_sum / n;
+}
+
+// Logs every reading and the batch's mean and jitter and fills |summary|
+// (all but the batch number).  Calls |yield| after each reading: encoding a
+// log message is the longest step.  INVALID_ARGUMENT for an empty batch.
+pw::Status Process(pw::span<const SensorReading> readings, history::BatchSummary& summary,
+                   void (*yield)());
+
+// Counts the batch (stats::Counter::kBatches, also its number), processes
+// it and appends its summary to the flash history.  May erase a history
+// sector (1–2 s, yields).
+history::BatchSummary Handle(pw::span<const SensorReading> readings, void (*yield)());
+
+// Takes over a batch size and sample period changed in the configuration
+// store (config.h); logs and returns true if either changed.  Call right
+// after the last reading of a batch, so every batch has one length and one
+// period.
+bool TakeCadence(std::chrono::milliseconds& sample_period, size_t& batch_size);
+
+}  // namespace batch
@@ -0,0 +1,173 @@
+// Hot-path benchmarks – see bench.h.
+//
+// Registers: RM0090 section 3.5.2 (FLASH_ACR).
+
+#include "bench.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdarg>
+#include <string_view>
+
+#include "batch.h"
+#include "crc.h"
+#include "cycle_counter.h"
+#include "log_line.h"
+#include "pw_tokenizer/encode_args.h"
+#include "pw_tokenizer/tokenize.h"
+
+#ifndef DEMO_HOST_BUILD
+#include <modm/board.hpp>
+#endif
+
+namespace bench {
+namespace {
+
+// ── Inputs ────────────────────────────────────────────────────────────────────
+// Not const, so the compiler cannot fold a kernel into its result.
+
+std::array<batch::SensorReading, 16> readings;
+std::array<uint8_t, 12>              message;
+std::array<uint8_t, 100>             metadata;
+std::array<uint8_t, 64>              record;
+
+volatile uint32_t sink;
+
+void Prepare() {
+    static bool prepared = false;
+    if (prepared)
+        return;
+    prepared = true;
+    // Same simulated readings as main.cpp's Sampler.
+    for (size_t i = 0; i < readings.size(); ++i) {
+        readings[i] = {static_cast<uint32_t>(500 * (i + 1)),
+                       static_cast<int16_t>(static_cast<int16_t>((i + 1) % 100u) - 50),
+                       static_cast<uint32_t>(3 * i), i + 1 == readings.size()};
+    }
+    uint32_t seed = 0x1234'5678u;
+    for (auto bytes : {pw::span<uint8_t>(message), pw::span<uint8_t>(metadata),
+                       pw::span<uint8_t>(record)}) {
+        for (uint8_t& b : bytes) {
+            seed = seed * 1664525u + 1013904223u;
+            b    = static_cast<uint8_t>(seed >> 24);
+        }
+    }
+}
+
+// ── Kernels ───────────────────────────────────────────────────────────────────
+
+uint32_t ProcessBatch() {
+    history::BatchSummary summary{};
+    batch::Summarize(readings, summary);
+    return static_cast<uint32_t>(summary.mean) ^ summary.jitter_mean_us;
+}
+
+uint32_t LogBase64() {
+    std::array<char, log_line::Size(sizeof(message))> line;
+    size_t n = 0;
+    log_line::Encode(message.data(), message.size(), [&](char c) { line[n++] = c; });
+    return static_cast<uint32_t>(line[n / 2]) + n;
+}
+
+uint32_t Crc32() { return crc::Crc32::Compute(metadata.data(), metadata.size()); }
+
+uint32_t Crc32C() { return crc::Crc32C::Compute(record.data(), record.size()); }
+
+// What pw_log_tokenized does with the arguments of a PW_LOG_* call.
+size_t EncodeArgs(pw::span<std::byte> out, pw_tokenizer_ArgTypes types, ...) {
+    va_list args;
+    va_start(args, types);
+    const size_t size = pw::tokenizer::EncodeArgs(types, args, out);
+    va_end(args);
+    return size;
+}
+
+uint32_t EncodeLogArgs() {
+    std::array<std::byte, 16> out;
+    const auto t_ms = static_cast<unsigned int>(readings[7].timestamp_ms);
+    const int  raw  = readings[7].raw_value;
+    // The arguments of ProcessBatch()'s per-reading PW_LOG_DEBUG.
+    const size_t size = EncodeArgs(out, PW_TOKENIZER_ARG_TYPES(t_ms, raw), t_ms, raw);
+    return static_cast<uint32_t>(out[0]) + size;
+}
+
+constexpr Kernel kKernels[] = {
+    {"process_batch", ProcessBatch},
+    {"log_base64",    LogBase64},
+    {"crc32",         Crc32},
+    {"crc32c",        Crc32C},
+    {"encode_args",   EncodeLogArgs},
+};
+
+constexpr bool NamesFit() {
+    for (const Kernel& k : kKernels)
+        if (std::char_traits<char>::length(k.name) > kMaxNameLength)
+            return false;
+    return true;
+}
+
+static_assert(std::size(kKernels) == kKernelCount, "update kKernelCount in bench.h");
+static_assert(NamesFit(), "a kernel name is longer than kMaxNameLength");
+
+// ── Timing ────────────────────────────────────────────────────────────────────
+
+// Flushes the ART's caches, which must be disabled while they are reset,
+// and leaves caches and prefetch enabled.
+void FlushFlashCaches() {
+#ifndef DEMO_HOST_BUILD
+    constexpr uint32_t kEnable = FLASH_ACR_ICEN | FLASH_ACR_DCEN | FLASH_ACR_PRFTEN;
+    const uint32_t     acr     = FLASH->ACR & ~(kEnable | FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+    FLASH->ACR = acr;
+    FLASH->ACR = acr | FLASH_ACR_ICRST | FLASH_ACR_DCRST;
+    FLASH->ACR = acr;
+    FLASH->ACR = acr | kEnable;
+#endif
+}
+
+uint32_t Time(uint32_t (*run)()) {
+#ifndef DEMO_HOST_BUILD
+    const uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+#endif
+    const uint32_t t0 = cycle_counter::Now();
+    sink              = run();
+    const uint32_t t  = cycle_counter::Now() - t0;
+#ifndef DEMO_HOST_BUILD
+    __set_PRIMASK(primask);
+#endif
+    return t;
+}
+
+// Reading the counter twice and an indirect call, as in every Time().
+uint32_t Overhead() {
+    uint32_t best = UINT32_MAX;
+    for (int i = 0; i < 8; ++i)
+        best = std::min(best, Time([] { return 0u; }));
+    return best;
+}
+
+}  // namespace
+
+pw::span<const Kernel> Kernels() { return kKernels; }
+
+Result Measure(const Kernel& kernel, size_t runs) {
+    runs = std::clamp<size_t>(runs, 1, kMaxRuns);
+    Prepare();
+    const uint32_t overhead = Overhead();
+    auto net = [&](uint32_t t) { return t > overhead ? t - overhead : 0; };
+
+    Result r{};
+    FlushFlashCaches();
+    r.cold = net(Time(kernel.run));
+
+    std::array<uint32_t, kMaxRuns> times;
+    for (size_t i = 0; i < runs; ++i)
+        times[i] = net(Time(kernel.run));
+    std::sort(times.begin(), times.begin() + runs);
+    r.min    = times[0];
+    r.median = times[runs / 2];
+    r.max    = times[runs - 1];
+    return r;
+}
+
+}  // namespace bench
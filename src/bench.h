@@ -0,0 +1,64 @@
+// Cycle counts of the firmware's hot paths (kernels), on the target itself.
+//
+//   for (const bench::Kernel& k : bench::Kernels())
+//       const bench::Result r = bench::Measure(k, 32);
+//
+//   Kernel         Times
+//   -------------  ---------------------------------------------------------
+//   process_batch  batch::Summarize() over 16 readings (main.cpp's batches)
+//   log_base64     log_line::Encode() of a 12-byte message (token + three
+//                  varint arguments), as the log drainer does for each one
+//   crc32          crc::Crc32 over 100 bytes (BuildMetadata, HDLC frames)
+//   crc32c         crc::Crc32C over 64 bytes (flash_log record payloads)
+//   encode_args    pw_tokenizer's EncodeArgs() of an unsigned and an int –
+//                  the varint encoding behind every PW_LOG with arguments
+//
+// Measure() times each run alone with the DWT cycle counter
+// (cycle_counter.h), with interrupts masked, so neither an ISR nor a fiber
+// switch lands in a sample.  The flash accelerator (ART: instruction cache,
+// data cache, prefetch) is enabled and flushed before the first run, which
+// is reported separately as the cold run; the others run with warm caches.
+// The cost of reading the counter is subtracted.
+//
+// Run them all with Rpc "Bench.Run" (rpc_services.h), which also logs the
+// table, or `python tools/rpc_client.py PORT bench`; tools/bench_collect.py
+// stores the results as JSON for comparing builds.  Host builds count
+// nanoseconds instead of cycles and mask nothing.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_span/span.h"
+
+namespace bench {
+
+struct Kernel {
+    const char* name;
+    // Does the work once; the result keeps the compiler from dropping it.
+    uint32_t (*run)();
+};
+
+struct Result {
+    uint32_t cold;    // first run after flushing the ART
+    uint32_t min;
+    uint32_t median;
+    uint32_t max;
+};
+
+inline constexpr size_t kMaxRuns     = 64;
+inline constexpr size_t kDefaultRuns = 32;
+
+// Size of the kernel table and its longest name, checked against it in
+// bench.cc, so Bench.Run's response size is known at compile time.
+inline constexpr size_t kKernelCount   = 5;
+inline constexpr size_t kMaxNameLength = 13;
+
+pw::span<const Kernel> Kernels();
+
+// Runs |kernel| once cold, then |runs| times (1..kMaxRuns), and returns the
+// cold time and min / median / max of the others, in cycle_counter ticks.
+Result Measure(const Kernel& kernel, size_t runs);
+
+}  // namespace bench
@@ -0,0 +1,185 @@
+// Fixed-size block allocators with intrusive free lists.
+//
+//   BlockPool<128, 16> pool;                // 16 blocks of 128 bytes, static
+//   void* block = pool.Allocate();          // nullptr when all are in use
+//   pool.Free(block);
+//
+// Allocate() and Free() are O(1): a free block stores the index of the next
+// free one in its first word, so the list costs no memory beyond the blocks.
+// Blocks never handed out yet are taken from a watermark instead of being
+// linked at construction, which keeps the constructor constexpr – a global
+// pool is constant-initialised and lives in .bss like any other buffer.
+//
+// BlockPool is for one context, e.g. the cooperative fibers (channel.h).
+// AtomicBlockPool may be used from any thread or interrupt priority: the
+// free list is a lock-free stack whose head carries a 16-bit version next to
+// the block index, so a Free()/Allocate() pair interleaved by an interrupt
+// makes the interrupted compare-and-swap fail instead of corrupting the list
+// (ABA).  On Cortex-M the CAS compiles to LDREX/STREX, as in mpsc_queue.h.
+//
+// Blocks are uninitialised and aligned to 8 bytes; only plain data belongs
+// in them.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+struct PoolStats {
+    uint16_t block_size;
+    uint16_t blocks;
+    uint16_t in_use;
+    uint16_t peak;        // highest in_use since boot
+    uint32_t allocations; // successful Allocate() calls
+    uint32_t failures;    // Allocate() calls that found the pool empty
+};
+
+namespace block_pool_internal {
+
+inline constexpr uint32_t kNone = 0xFFFF;  // end of the free list
+
+// Storage and statistics shared by both pools.  Counters are relaxed
+// atomics so that the AtomicBlockPool statistics may be read from anywhere.
+template <size_t kBlockSize, size_t kBlockCount>
+class Blocks {
+    static_assert(kBlockSize >= 4 && kBlockSize % 4 == 0, "blocks hold the free list link");
+    static_assert(kBlockCount > 0 && kBlockCount < kNone, "block index must fit 16 bits");
+
+public:
+    static constexpr size_t kSize  = kBlockSize;
+    static constexpr size_t kCount = kBlockCount;
+
+    bool Owns(const void* p) const {
+        const auto* b = static_cast<const std::byte*>(p);
+        return b >= storage_.data() && b < storage_.data() + storage_.size();
+    }
+
+    PoolStats stats() const {
+        return {static_cast<uint16_t>(kBlockSize), static_cast<uint16_t>(kBlockCount),
+                static_cast<uint16_t>(in_use_.load(std::memory_order_relaxed)),
+                static_cast<uint16_t>(peak_.load(std::memory_order_relaxed)),
+                allocations_.load(std::memory_order_relaxed),
+                failures_.load(std::memory_order_relaxed)};
+    }
+
+protected:
+    void* Block(uint32_t index) { return &storage_[index * kBlockSize]; }
+
+    uint32_t Index(const void* p) const {
+        return static_cast<uint32_t>((static_cast<const std::byte*>(p) - storage_.data()) /
+                                     kBlockSize);
+    }
+
+    // The free list link in the first word of a free block.
+    std::atomic_ref<uint32_t> Link(uint32_t index) {
+        return std::atomic_ref<uint32_t>(*reinterpret_cast<uint32_t*>(Block(index)));
+    }
+
+    void* Allocated(uint32_t index) {
+        allocations_.fetch_add(1, std::memory_order_relaxed);
+        const uint32_t n = in_use_.fetch_add(1, std::memory_order_relaxed) + 1;
+        uint32_t peak = peak_.load(std::memory_order_relaxed);
+        while (n > peak && !peak_.compare_exchange_weak(peak, n, std::memory_order_relaxed)) {}
+        return Block(index);
+    }
+
+    void* Failed() {
+        failures_.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    void Freed() { in_use_.fetch_sub(1, std::memory_order_relaxed); }
+
+private:
+    alignas(8) std::array<std::byte, kBlockSize * kBlockCount> storage_{};
+    std::atomic<uint32_t> in_use_{0};
+    std::atomic<uint32_t> peak_{0};
+    std::atomic<uint32_t> allocations_{0};
+    std::atomic<uint32_t> failures_{0};
+};
+
+}  // namespace block_pool_internal
+
+template <size_t kBlockSize, size_t kBlockCount>
+class BlockPool : public block_pool_internal::Blocks<kBlockSize, kBlockCount> {
+public:
+    constexpr BlockPool() = default;
+
+    BlockPool(const BlockPool&)            = delete;
+    BlockPool& operator=(const BlockPool&) = delete;
+
+    // A free block, or nullptr (counted as a failure).
+    void* Allocate() {
+        if (free_ != block_pool_internal::kNone) {
+            const uint32_t index = free_;
+            free_ = this->Link(index).load(std::memory_order_relaxed);
+            return this->Allocated(index);
+        }
+        if (fresh_ < kBlockCount)
+            return this->Allocated(fresh_++);
+        return this->Failed();
+    }
+
+    // |block| must come from Allocate() of this pool.
+    void Free(void* block) {
+        const uint32_t index = this->Index(block);
+        this->Link(index).store(free_, std::memory_order_relaxed);
+        free_ = index;
+        this->Freed();
+    }
+
+private:
+    uint32_t free_  = block_pool_internal::kNone;  // head of the free list
+    uint32_t fresh_ = 0;                           // blocks below were handed out
+};
+
+template <size_t kBlockSize, size_t kBlockCount>
+class AtomicBlockPool : public block_pool_internal::Blocks<kBlockSize, kBlockCount> {
+public:
+    constexpr AtomicBlockPool() = default;
+
+    AtomicBlockPool(const AtomicBlockPool&)            = delete;
+    AtomicBlockPool& operator=(const AtomicBlockPool&) = delete;
+
+    void* Allocate() {
+        uint32_t head = head_.load(std::memory_order_acquire);
+        while (First(head) != block_pool_internal::kNone) {
+            // May read a block another context has just taken; its version
+            // then no longer matches and the CAS fails.
+            const uint32_t next = this->Link(First(head)).load(std::memory_order_relaxed);
+            if (head_.compare_exchange_weak(head, Head(next, head),
+                                            std::memory_order_acquire,
+                                            std::memory_order_acquire))
+                return this->Allocated(First(head));
+        }
+        uint32_t fresh = fresh_.load(std::memory_order_relaxed);
+        while (fresh < kBlockCount) {
+            if (fresh_.compare_exchange_weak(fresh, fresh + 1, std::memory_order_relaxed))
+                return this->Allocated(fresh);
+        }
+        return this->Failed();
+    }
+
+    void Free(void* block) {
+        const uint32_t index = this->Index(block);
+        uint32_t       head  = head_.load(std::memory_order_relaxed);
+        do {
+            this->Link(index).store(First(head), std::memory_order_relaxed);
+        } while (!head_.compare_exchange_weak(head, Head(index, head),
+                                              std::memory_order_release,
+                                              std::memory_order_relaxed));
+        this->Freed();
+    }
+
+private:
+    // head_: version (bits 31..16) | index of the first free block
+    static uint32_t First(uint32_t head) { return head & 0xFFFF; }
+    static uint32_t Head(uint32_t index, uint32_t previous) {
+        return ((previous & 0xFFFF'0000) + 0x1'0000) | index;
+    }
+
+    std::atomic<uint32_t> head_{block_pool_internal::kNone};
+    std::atomic<uint32_t> fresh_{0};
+};
@@ -0,0 +1,61 @@
+// Build-time metadata embedded in a dedicated ELF section (.build_metadata).
+//
+// The struct is defined and filled in by build_metadata.cc; this header
+// exposes its layout and the flashed bytes so the firmware can report its
+// identity at runtime (Device.GetBuildInfo in rpc_services.h).
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_span/span.h"
+
+// ── Packed struct in .build_metadata ELF section ─────────────────────────────
+// Binary layout v2 (104 bytes, little-endian, no padding between fields):
+//
+//   Offset  Size  Field
+//   ------  ----  -----
+//    0       4    magic        "META"  (no null terminator; parser sentinel)
+//    4       1    version      layout version (2); v1 had an ASCII commit char here
+//    5       1    reserved     0
+//    6       2    size         sizeof(BuildMetadata), lets readers skip unknown tails
+//    8       9    commit       8-char git hash + '\0'
+//   17       1    dirty        0 = clean, 1 = working tree modified at build time
+//   18      32    branch       branch name (up to 31 chars) + '\0'
+//   50      12    date         __DATE__  "Mmm DD YYYY" + '\0'
+//   62       9    time         __TIME__  "HH:MM:SS"   + '\0'
+//   71       1    build_id_len bytes of build_id in use (20 for --build-id=sha1)
+//   72      20    build_id     GNU build ID                      (patched post-link)
+//   92       8    tokens_hash  SHA-256[0:8] of .pw_tokenizer.entries (patched post-link)
+//  100       4    crc32        CRC-32 over bytes 0..99 (LE uint32)
+//                              Verify in Python: zlib.crc32(data[:100]) & 0xFFFFFFFF
+//
+// The v1 layout (71 bytes: magic, commit, dirty, branch, date, time, crc32 over
+// the string contents) is still decoded by tools/read_build_meta.py for images
+// built before this change.
+
+struct __attribute__((packed)) BuildMetadata {
+    std::array<char, 4>     magic;
+    uint8_t                 version;
+    uint8_t                 reserved;
+    uint16_t                size;
+    std::array<char, 9>     commit;
+    uint8_t                 dirty;
+    std::array<char, 32>    branch;
+    std::array<char, 12>    date;
+    std::array<char, 9>     time;
+    uint8_t                 build_id_len;
+    std::array<uint8_t, 20> build_id;
+    std::array<uint8_t, 8>  tokens_hash;
+    uint32_t                crc32;
+};
+
+static_assert(sizeof(BuildMetadata) == 104,
+              "BuildMetadata layout changed – update tools/read_build_meta.py "
+              "and tools/patch_image.py");
+static_assert(offsetof(BuildMetadata, crc32) == 100);
+
+// The struct as stored in flash, including the fields patched after linking.
+pw::span<const std::byte> BuildMetadataBytes();
@@ -0,0 +1,48 @@
+// SDRAM sample capture – see capture.h.
+
+#include "capture.h"
+
+#include "memory_region.h"
+
+namespace capture {
+namespace {
+
+pw::span<Sample> buffer;
+size_t           count  = 0;
+size_t           limit  = 0;
+bool             active = false;
+
+}  // namespace
+
+pw::Status Initialize() {
+    buffer = memory_region::AllocateRest<Sample>(memory_region::Region::kSdram);
+    return buffer.empty() ? pw::Status::FailedPrecondition() : pw::OkStatus();
+}
+
+pw::Status Start(uint32_t max_samples) {
+    if (buffer.empty())
+        return pw::Status::FailedPrecondition();
+    count  = 0;
+    limit  = max_samples == 0 || max_samples > buffer.size() ? buffer.size() : max_samples;
+    active = true;
+    return pw::OkStatus();
+}
+
+void Stop() { active = false; }
+
+bool Add(const Sample& sample) {
+    if (!active)
+        return false;
+    buffer[count++] = sample;
+    if (count == limit)
+        active = false;
+    return true;
+}
+
+bool running() { return active; }
+
+uint32_t capacity() { return static_cast<uint32_t>(buffer.size()); }
+
+pw::span<const Sample> Samples() { return buffer.first(count); }
+
+}  // namespace capture
@@ -0,0 +1,52 @@
+// Long sample captures in external SDRAM.
+//
+//   capture::Initialize();          // after sdram::Initialize(), takes the rest of kSdram
+//   capture::Start(0);              // record until the buffer is full
+//   capture::Add(sample);           // from the sampler, every reading
+//   … later, stream the samples out with Rpc "Capture.Read" …
+//
+// The buffer holds about a million 8-byte samples, against the 16 readings
+// of one batch in internal RAM.  Add() is one 8-byte store into SDRAM and
+// never blocks, so recording costs the sampler nothing measurable; it stops
+// recording once the buffer (or the requested length) is full.  Samples stay
+// readable until the next Start().
+//
+// Single producer, single reader: call Add() from one fiber and the reading
+// functions from another (cooperative fibers, no locking needed).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace capture {
+
+struct Sample {
+    uint32_t t_ms;
+    int16_t  raw_value;
+    uint16_t jitter_us;  // saturates at 65535
+};
+
+static_assert(sizeof(Sample) == 8, "Capture.Read wire format");
+
+// Claims everything left in memory_region::Region::kSdram.  FAILED_PRECONDITION
+// if the SDRAM is not enabled or full.
+pw::Status Initialize();
+
+// Clears the buffer and records up to |max_samples| (0: capacity).
+// FAILED_PRECONDITION before Initialize().
+pw::Status Start(uint32_t max_samples);
+void Stop();
+
+// False while not recording (stopped or full).
+bool Add(const Sample& sample);
+
+bool     running();
+uint32_t capacity();
+// Recorded so far.
+pw::span<const Sample> Samples();
+
+}  // namespace capture
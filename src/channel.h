@@ -0,0 +1,57 @@
+// Bounded FIFO between modm fibers.
+//
+//   Channel<SensorReading, 16> samples;
+//   samples.TrySend(r);             // producer that must not wait (sampler)
+//   SensorReading r = samples.Receive();   // consumer, yields while empty
+//
+// Fibers are cooperative and only switch in modm::this_fiber::yield(), so the
+// ETL queue needs no locking.  Do not use a Channel from interrupt handlers;
+// they need a lock-free queue such as mpsc_queue.h.
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+
+#include <etl/queue.h>
+#include <modm/processing/fiber.hpp>
+
+template <typename T, size_t kCapacity>
+class Channel {
+public:
+    // Returns false (and leaves the channel unchanged) when it is full.
+    bool TrySend(const T& value) {
+        if (queue_.full())
+            return false;
+        queue_.push(value);
+        return true;
+    }
+
+    // Yields until there is room.
+    void Send(const T& value) {
+        while (!TrySend(value))
+            modm::this_fiber::yield();
+    }
+
+    std::optional<T> TryReceive() {
+        if (queue_.empty())
+            return std::nullopt;
+        T value = queue_.front();
+        queue_.pop();
+        return value;
+    }
+
+    // Yields until a value is available.
+    T Receive() {
+        while (queue_.empty())
+            modm::this_fiber::yield();
+        T value = queue_.front();
+        queue_.pop();
+        return value;
+    }
+
+    size_t size() const { return queue_.size(); }
+
+private:
+    etl::queue<T, kCapacity> queue_;
+};
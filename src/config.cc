@@ -0,0 +1,171 @@
+// Persistent configuration – see config.h.
+
+#include "log_config.h"
+
+#include "config.h"
+
+#include <algorithm>
+#include <optional>
+
+#include "pw_status/try.h"
+#include "pw_varint/varint.h"
+
+#undef PW_LOG_MODULE_NAME
+#define PW_LOG_MODULE_NAME "CONF"
+
+namespace config {
+namespace {
+
+constexpr std::array<uint32_t, kKeyCount> Defaults() {
+    std::array<uint32_t, kKeyCount> defaults{};
+    for (size_t id = 0; id < kKeyCount; ++id)
+        defaults[id] = kEntries[id].default_value;
+    return defaults;
+}
+
+}  // namespace
+
+namespace internal {
+constinit std::array<uint32_t, kKeyCount> values = Defaults();
+}  // namespace internal
+
+namespace {
+
+using internal::values;
+
+constexpr uint8_t kSnapshot = 1;  // FlashLog record type
+
+std::optional<flash_log::FlashLog> store;
+bool changed = false;
+
+constexpr bool Allowed(const Entry& e, uint32_t value) {
+    if (value < e.min || value > e.max)
+        return false;
+    return e.choices.empty() ||
+           std::find(e.choices.begin(), e.choices.end(), value) != e.choices.end();
+}
+
+constexpr bool DefaultsValid() {
+    for (const Entry& e : kEntries)
+        if (!Allowed(e, e.default_value))
+            return false;
+    return true;
+}
+
+static_assert(DefaultsValid(), "a default is outside its own range");
+
+// Applies one snapshot over the defaults; returns the number of keys taken.
+size_t Load(pw::span<const std::byte> payload) {
+    size_t taken = 0;
+    while (!payload.empty()) {
+        uint64_t key, value;
+        size_t   n = pw::varint::Decode(payload, &key);
+        if (n == 0)
+            break;
+        payload = payload.subspan(n);
+        n       = pw::varint::Decode(payload, &value);
+        if (n == 0)
+            break;
+        payload = payload.subspan(n);
+
+        const uint64_t id = key >> 2;
+        if (id >= kKeyCount || (key & 3) != static_cast<uint64_t>(kEntries[id].type) ||
+            value > UINT32_MAX)
+            continue;
+        if (!Check(static_cast<uint8_t>(id), static_cast<uint32_t>(value)).ok())
+            continue;
+        values[id] = static_cast<uint32_t>(value);
+        ++taken;
+    }
+    return taken;
+}
+
+}  // namespace
+
+// ── Values ────────────────────────────────────────────────────────────────────
+
+uint32_t Get(uint8_t id) { return id < kKeyCount ? values[id] : 0; }
+
+pw::Status Check(uint8_t id, uint32_t value) {
+    if (id >= kKeyCount)
+        return pw::Status::NotFound();
+    const Entry& e = kEntries[id];
+    if (value < e.min || value > e.max)
+        return pw::Status::OutOfRange();
+    if (!Allowed(e, value))
+        return pw::Status::InvalidArgument();
+    return pw::OkStatus();
+}
+
+pw::Status Set(uint8_t id, uint32_t value) {
+    PW_TRY(Check(id, value));
+    if (values[id] != value) {
+        values[id] = value;
+        changed    = true;
+    }
+    return pw::OkStatus();
+}
+
+// ── Flash ─────────────────────────────────────────────────────────────────────
+
+pw::Status Initialize(flash_log::Flash& flash) {
+    values  = Defaults();
+    changed = false;
+    store.emplace(flash);
+    const pw::Status status = store->Mount();
+    if (!status.ok()) {
+        PW_LOG_ERROR("config: mount failed (%s), using defaults", status.str());
+        return status;
+    }
+
+    // The last intact snapshot wins; ForEach() skips torn ones.
+    std::array<std::byte, flash_log::FlashLog::kMaxPayloadSize> last;
+    size_t last_size = 0;
+    size_t snapshots = 0;
+    store->ForEach([&](uint8_t type, pw::span<const std::byte> payload) {
+        if (type == kSnapshot) {
+            std::copy(payload.begin(), payload.end(), last.begin());
+            last_size = payload.size();
+            ++snapshots;
+        }
+        return true;
+    });
+    if (snapshots == 0) {
+        PW_LOG_INFO("config: no snapshot, using defaults");
+        return pw::OkStatus();
+    }
+    const size_t taken = Load(pw::span<const std::byte>(last.data(), last_size));
+    PW_LOG_INFO("config: %u of %u keys from the last of %u snapshots",
+                (unsigned int)taken, (unsigned int)kKeyCount, (unsigned int)snapshots);
+    return pw::OkStatus();
+}
+
+pw::Status Commit() {
+    if (!changed)
+        return pw::OkStatus();
+    if (!store || !store->mounted())
+        return pw::Status::FailedPrecondition();
+
+    std::array<std::byte, flash_log::FlashLog::kMaxPayloadSize> payload;
+    size_t size = 0;
+    for (size_t id = 0; id < kKeyCount; ++id) {
+        const auto key = static_cast<uint32_t>(id << 2 | static_cast<size_t>(kEntries[id].type));
+        size += pw::varint::Encode(key, pw::span(payload).subspan(size));
+        size += pw::varint::Encode(values[id], pw::span(payload).subspan(size));
+    }
+    // Cleared first: a Set() while Append() erases a sector is kept for the
+    // next Commit().
+    changed = false;
+    const pw::Status status = store->Append(kSnapshot, pw::span(payload.data(), size));
+    if (!status.ok()) {
+        changed = true;
+        return status;
+    }
+    PW_LOG_INFO("config: snapshot stored, %u bytes free in sector",
+                (unsigned int)store->free_in_sector());
+    return pw::OkStatus();
+}
+
+bool dirty() { return changed; }
+
+}  // namespace config
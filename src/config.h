@@ -0,0 +1,154 @@
+// Settings kept in internal flash across resets and changed at runtime,
+// instead of compile-time constants that need a new image per site.
+//
+//   config::Initialize(flash);                          // at boot, logs what it loaded
+//   uint32_t ms = config::Get(config::kSamplePeriodMs); // O(1), from RAM
+//   config::Set(config::kBatchSize, 8);                 // range-checked, RAM only
+//   config::Commit();                                   // to flash, if anything changed
+//
+// Keys are compile-time constants carrying their value type; Get() indexes
+// a RAM table by the key's ID.  Each key has a default, a range and, for the
+// baud rate, a list of allowed values (kEntries).  Change them with Rpc
+// "Config.Set" (rpc_services.h) or `python tools/rpc_client.py PORT config
+// NAME VALUE`.
+//
+// The store is a flash_log::FlashLog on two sectors: Commit() appends a
+// snapshot of every value, and Initialize() loads the last intact one.  A
+// snapshot only replaces the previous one once its commit word is written,
+// and when a sector is full the other one is erased for the next snapshot –
+// the newest committed snapshot always survives a power failure.  A
+// sector holds over 5000 snapshots.  Payload: varints, per key
+//
+//   (id << 2 | type), value
+//
+// Unknown keys, a changed type or a value outside today's range fall back to
+// the default, so keys can be added to the end of the table freely.
+//
+// Call Set() and Commit() from fibers only.  Commit() may erase a sector
+// (1–2 s, yields); main.cpp calls it from the processor at batch
+// boundaries, not from the UART fiber that feeds the watchdog.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "flash_log.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace config {
+
+enum class Type : uint8_t {
+    kU8  = 0,
+    kU16 = 1,
+    kU32 = 2,
+};
+
+// When a new value takes effect.
+enum class Apply : uint8_t {
+    kNow       = 0,
+    kReboot    = 1,
+    kNextBatch = 2,  // once the batch being sampled is complete
+};
+
+// Allowed baud rates: the USART's error stays below 1 % at 90 MHz APB2.
+inline constexpr std::array<uint32_t, 7> kBaudRates = {
+    9600, 19200, 38400, 57600, 115200, 230400, 460800,
+};
+
+struct Entry {
+    const char* name;
+    Type        type;
+    Apply       apply;
+    uint32_t    default_value;
+    uint32_t    min;
+    uint32_t    max;
+    pw::span<const uint32_t> choices;  // empty: any value in [min, max]
+};
+
+// Indexed by key ID; only ever append.
+inline constexpr std::array<Entry, 4> kEntries = {{
+    {"baud", Type::kU32, Apply::kReboot, 115200, 9600, 460800, kBaudRates},
+    // Max: main.cpp's kMaxBatchSize, the batch buffer's capacity.
+    {"batch_size", Type::kU16, Apply::kNextBatch, 16, 1, 64, {}},
+    {"sample_period_ms", Type::kU32, Apply::kNextBatch, 500, 10, 60'000, {}},
+    // PW_LOG_LEVEL_DEBUG..PW_LOG_LEVEL_FATAL
+    {"log_level", Type::kU8, Apply::kNow, 1, 1, 7, {}},
+}};
+
+inline constexpr size_t kKeyCount = kEntries.size();
+
+template <typename T>
+struct Key {
+    uint8_t id;
+};
+
+template <typename T>
+constexpr Type TypeOf() {
+    if constexpr (sizeof(T) == 1)
+        return Type::kU8;
+    else if constexpr (sizeof(T) == 2)
+        return Type::kU16;
+    else
+        return Type::kU32;
+}
+
+template <typename T>
+constexpr bool Matches(Key<T> key) {
+    return key.id < kKeyCount && kEntries[key.id].type == TypeOf<T>();
+}
+
+inline constexpr Key<uint32_t> kBaudRate{0};
+inline constexpr Key<uint16_t> kBatchSize{1};
+inline constexpr Key<uint32_t> kSamplePeriodMs{2};
+inline constexpr Key<uint8_t>  kLogLevel{3};
+
+static_assert(Matches(kBaudRate) && Matches(kBatchSize) && Matches(kSamplePeriodMs) &&
+              Matches(kLogLevel));
+
+// Per key: a two-byte varint for key and type, a five-byte one for the value.
+static_assert(kKeyCount * 7 <= flash_log::FlashLog::kMaxPayloadSize);
+
+// ── Values ────────────────────────────────────────────────────────────────────
+
+namespace internal {
+extern std::array<uint32_t, kKeyCount> values;
+}  // namespace internal
+
+template <typename T>
+T Get(Key<T> key) {
+    return static_cast<T>(internal::values[key.id]);
+}
+
+uint32_t Get(uint8_t id);
+
+// OK if |value| is allowed for the key (see kEntries).
+pw::Status Check(uint8_t id, uint32_t value);
+
+// NOT_FOUND for an unknown ID, OUT_OF_RANGE or INVALID_ARGUMENT (not one of
+// the choices) for a value Check() rejects.  Get() returns the new value at
+// once; the application uses it as the key's Apply says.  Only the next
+// Commit() stores it.
+pw::Status Set(uint8_t id, uint32_t value);
+
+template <typename T>
+pw::Status Set(Key<T> key, std::type_identity_t<T> value) {
+    return Set(key.id, value);
+}
+
+// ── Flash ─────────────────────────────────────────────────────────────────────
+
+// Mounts the store on |flash| (formatting it if blank) and loads the last
+// snapshot; every key keeps its default if that fails.
+pw::Status Initialize(flash_log::Flash& flash);
+
+// Appends a snapshot if a value changed since the last one.
+// FAILED_PRECONDITION without a mounted store.
+pw::Status Commit();
+
+bool dirty();
+
+}  // namespace config
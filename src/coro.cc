@@ -0,0 +1,103 @@
+// Coroutine frame pool and executor – see coro.h.
+
+#include "coro.h"
+
+#include <array>
+#include <cstdint>
+
+#ifndef DEMO_HOST_BUILD
+#include <modm/board.hpp>
+#endif
+
+namespace coro {
+namespace {
+
+// ── Frame pool ────────────────────────────────────────────────────────────────
+// Frames are only created and destroyed from thread context (coroutine calls
+// and RunReady()), so a plain bitmap suffices.
+
+static_assert(kMaxFrames <= 32, "the free-block bitmap is one word");
+
+alignas(std::max_align_t) std::array<std::byte, kFrameSize * kMaxFrames> frames;
+uint32_t used = 0;
+
+// ── Ready queue ───────────────────────────────────────────────────────────────
+// Every live coroutine owns a frame and is queued at most once, so kMaxFrames
+// entries always suffice.  Schedule() may run in an interrupt handler, so
+// both ends are guarded by a critical section on the target.  Host builds
+// have no interrupts.
+
+std::array<std::coroutine_handle<>, kMaxFrames> ready;
+size_t ready_head  = 0;
+size_t ready_count = 0;
+
+#ifdef DEMO_HOST_BUILD
+struct CriticalSection {
+    ~CriticalSection() {}  // user-provided, so guards do not count as unused
+};
+#else
+using CriticalSection = modm::atomic::Lock;
+#endif
+
+std::coroutine_handle<> PopReady() {
+    CriticalSection lock;
+    std::coroutine_handle<> handle = ready[ready_head];
+    ready_head = (ready_head + 1) % ready.size();
+    --ready_count;
+    return handle;
+}
+
+}  // namespace
+
+void* AllocateFrame(size_t size) noexcept {
+    if (size > kFrameSize)
+        return nullptr;
+    for (size_t i = 0; i < kMaxFrames; ++i) {
+        if (!(used & (1u << i))) {
+            used |= 1u << i;
+            return &frames[i * kFrameSize];
+        }
+    }
+    return nullptr;
+}
+
+void FreeFrame(void* frame) noexcept {
+    const auto offset = static_cast<size_t>(static_cast<std::byte*>(frame) - frames.data());
+    used &= ~(1u << (offset / kFrameSize));
+}
+
+size_t FramesInUse() {
+    return static_cast<size_t>(__builtin_popcount(used));
+}
+
+bool Spawn(Task task) {
+    if (!task)
+        return false;
+    Schedule(task.release());
+    return true;
+}
+
+void Schedule(std::coroutine_handle<> handle) {
+    CriticalSection lock;
+    ready[(ready_head + ready_count) % ready.size()] = handle;
+    ++ready_count;
+}
+
+size_t RunReady() {
+    size_t n;
+    {
+        CriticalSection lock;
+        n = ready_count;
+    }
+    // Coroutines scheduled while these run (e.g. by Yield) wait for the next
+    // call, so one call always terminates.
+    for (size_t i = 0; i < n; ++i) {
+        std::coroutine_handle<> handle = PopReady();
+        handle.resume();
+        if (handle.done())
+            handle.destroy();
+    }
+    return n;
+}
+
+}  // namespace coro
@@ -0,0 +1,107 @@
+// Heap-free C++20 coroutines: a fire-and-forget task type and a minimal
+// run-to-suspension executor.
+//
+//   coro::Task Blink() {
+//       while (true) {
+//           Board::LedRed::toggle();
+//           co_await coro::Yield{};
+//       }
+//   }
+//   coro::Spawn(Blink());
+//   …
+//   coro::RunReady();    // from one fiber / the main loop, repeatedly
+//
+// Coroutine frames come from a fixed pool of kMaxFrames blocks of kFrameSize
+// bytes (Task::promise_type::operator new), never from the heap.  When the
+// pool is exhausted, or a frame does not fit a block, the coroutine function
+// returns an empty Task and Spawn() rejects it.
+//
+// A task starts suspended; Spawn() schedules it.  From then on it runs
+// whenever something calls Schedule() on its handle — an awaitable such as
+// Yield or async_uart::Write(), possibly from an interrupt handler.  Tasks are
+// destroyed, and their frame returned to the pool, when they finish.
+// Awaiting another Task is not supported; compose with plain functions.
+
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdlib>
+#include <utility>
+
+namespace coro {
+
+// ── Frame pool ────────────────────────────────────────────────────────────────
+
+inline constexpr size_t kFrameSize = 256;
+inline constexpr size_t kMaxFrames = 4;
+
+// nullptr if |size| exceeds kFrameSize or every block is in use.
+void* AllocateFrame(size_t size) noexcept;
+void  FreeFrame(void* frame) noexcept;
+size_t FramesInUse();
+
+// ── Task ──────────────────────────────────────────────────────────────────────
+
+class Task {
+public:
+    struct promise_type {
+        static void* operator new(size_t size) noexcept { return AllocateFrame(size); }
+        static void  operator delete(void* frame) noexcept { FreeFrame(frame); }
+        static Task  get_return_object_on_allocation_failure() { return Task(); }
+
+        Task get_return_object() {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        // Stay suspended at the end so the executor can see done() and free it.
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        // Built with -fno-exceptions on target; nothing can reach this.
+        void unhandled_exception() { std::abort(); }
+    };
+
+    Task() = default;
+    Task(Task&& other) : handle_(std::exchange(other.handle_, {})) {}
+    Task& operator=(Task&&) = delete;
+    ~Task() {
+        if (handle_)
+            handle_.destroy();
+    }
+
+    // False if the frame could not be allocated.
+    explicit operator bool() const { return static_cast<bool>(handle_); }
+
+    // Hands ownership of the coroutine to the caller (the executor).
+    std::coroutine_handle<> release() { return std::exchange(handle_, {}); }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+// ── Executor ──────────────────────────────────────────────────────────────────
+
+// Takes ownership of |task| and schedules its first run.  Returns false if the
+// task is empty (frame pool exhausted).
+bool Spawn(Task task);
+
+// Queues |handle| to be resumed by the next RunReady().  Safe to call from
+// interrupt handlers.  A suspended coroutine must be scheduled at most once.
+void Schedule(std::coroutine_handle<> handle);
+
+// Resumes every coroutine that was scheduled before the call, each until its
+// next suspension, and destroys those that finished.  Returns how many ran.
+// Call from a single context only.
+size_t RunReady();
+
+// co_await coro::Yield{};  lets the other scheduled coroutines run and
+// continues on the next RunReady().
+struct Yield {
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) const { Schedule(handle); }
+    void await_resume() const noexcept {}
+};
+
+}  // namespace coro
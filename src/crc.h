@@ -0,0 +1,245 @@
+// Generic table-driven CRC engine, usable in constexpr contexts and at runtime.
+//
+//   constexpr uint32_t c = crc::Crc32::Compute("123456789");     // 0xCBF43926
+//   uint16_t f = crc::Crc16Ccitt::Compute(frame.data(), frame.size());
+//
+//   crc::Crc32C crc;                        // incremental
+//   crc.Update(hdr, sizeof(hdr)).Update(payload, n);
+//   uint32_t v = crc.value();
+//
+// Parameters follow the Rocksoft / CRC RevEng catalogue model: width, normal
+// (MSB-first) polynomial, initial register value, reflection of input and
+// output (always equal for the supported algorithms), and final XOR.
+//
+// The lookup tables are built at compile time.  kSlices selects the kernel:
+//   1  classic byte-at-a-time, 256 entries
+//   4  slicing-by-4, 4 × 256 entries — ~2–3× faster on Cortex-M4
+//   8  slicing-by-8, 8 × 256 entries — fastest on hosts with large caches
+// Tables only occupy flash when the engine is used at runtime; purely
+// constexpr uses (e.g. build_metadata.cc) cost nothing in the image.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+namespace crc {
+
+namespace detail {
+
+constexpr uint32_t Reflect(uint32_t v, unsigned bits) {
+    uint32_t r = 0;
+    for (unsigned i = 0; i < bits; ++i, v >>= 1)
+        r = (r << 1) | (v & 1u);
+    return r;
+}
+
+template <typename Value>
+inline constexpr unsigned kRegBits = 8 * sizeof(Value);
+
+// One byte of long division.  Reflected CRCs keep the register bit-reversed
+// in the low bits; non-reflected ones keep it left-aligned in Value so the top
+// byte is always the next one to be divided out, whatever the CRC width.
+template <typename Value, bool kReflect>
+constexpr Value Step(Value reg, uint8_t b, const std::array<Value, 256>& t0) {
+    if constexpr (kRegBits<Value> == 8)
+        return t0[static_cast<uint8_t>(reg ^ b)];
+    else if constexpr (kReflect)
+        return static_cast<Value>((reg >> 8) ^ t0[static_cast<uint8_t>(reg ^ b)]);
+    else
+        return static_cast<Value>(
+            (reg << 8) ^ t0[static_cast<uint8_t>((reg >> (kRegBits<Value> - 8)) ^ b)]);
+}
+
+template <typename Value, std::size_t kSlices>
+using Table = std::array<std::array<Value, 256>, kSlices>;
+
+// t[0] is the classic byte table; t[k][b] is the contribution of byte b
+// followed by k zero bytes, which is what slicing-by-N folds together.
+template <typename Value, bool kReflect, std::size_t kSlices>
+constexpr Table<Value, kSlices> MakeTable(Value reg_poly) {
+    Table<Value, kSlices> t{};
+    for (unsigned b = 0; b < 256; ++b) {
+        Value c = kReflect ? static_cast<Value>(b)
+                           : static_cast<Value>(b << (kRegBits<Value> - 8));
+        for (int i = 0; i < 8; ++i) {
+            if constexpr (kReflect)
+                c = static_cast<Value>((c >> 1) ^ ((c & 1u) ? reg_poly : 0u));
+            else
+                c = static_cast<Value>((c << 1) ^ ((c >> (kRegBits<Value> - 1)) ? reg_poly : 0u));
+        }
+        t[0][b] = c;
+    }
+    for (std::size_t k = 1; k < kSlices; ++k)
+        for (unsigned b = 0; b < 256; ++b)
+            t[k][b] = Step<Value, kReflect>(t[k - 1][b], 0, t[0]);
+    return t;
+}
+
+}  // namespace detail
+
+template <unsigned kWidth,
+          uint32_t kPoly,
+          uint32_t kInit,
+          bool     kReflect,
+          uint32_t kXorOut,
+          std::size_t kSlices = 1>
+class Crc {
+    static_assert(kWidth >= 8 && kWidth <= 32, "supported CRC widths are 8..32 bits");
+    static_assert(kSlices == 1 || kSlices == 4 || kSlices == 8,
+                  "kSlices must be 1, 4 or 8");
+
+public:
+    using Value = std::conditional_t<(kWidth <= 8),  uint8_t,
+                  std::conditional_t<(kWidth <= 16), uint16_t, uint32_t>>;
+
+    // Same algorithm with a different table layout (e.g. Crc32::Sliced<1> to
+    // trade speed for 3 KB less flash).
+    template <std::size_t kOtherSlices>
+    using Sliced = Crc<kWidth, kPoly, kInit, kReflect, kXorOut, kOtherSlices>;
+
+    constexpr Crc() = default;
+
+    constexpr Crc& Update(const uint8_t* data, std::size_t size) {
+        reg_ = Run(reg_, data, size);
+        return *this;
+    }
+
+    constexpr Crc& Update(std::string_view s) {
+        for (char c : s)
+            reg_ = Step(reg_, static_cast<uint8_t>(c));
+        return *this;
+    }
+
+    Crc& Update(const void* data, std::size_t size) {
+        return Update(static_cast<const uint8_t*>(data), size);
+    }
+
+    // Feeds 32-bit words MSB first, as the STM32 CRC unit does when words are
+    // written to CRC->DR.  Only meaningful for non-reflected 32-bit CRCs.
+    constexpr Crc& UpdateWords(const uint32_t* words, std::size_t count)
+        requires(kWidth == 32 && !kReflect)
+    {
+        if constexpr (kSlices > 1) {
+            constexpr std::size_t kWordsPerChunk = kSlices / 4;
+            for (; count >= kWordsPerChunk; count -= kWordsPerChunk, words += kWordsPerChunk) {
+                uint8_t chunk[kSlices] = {};
+                for (std::size_t i = 0; i < kSlices; ++i)
+                    chunk[i] = static_cast<uint8_t>(words[i / 4] >> (24 - 8 * (i % 4)));
+                reg_ = Run(reg_, chunk, kSlices);
+            }
+        }
+        for (; count; --count, ++words)
+            for (int s = 24; s >= 0; s -= 8)
+                reg_ = Step(reg_, static_cast<uint8_t>(*words >> s));
+        return *this;
+    }
+
+    constexpr Value value() const {
+        return static_cast<Value>(Output(reg_) ^ kXorOut);
+    }
+
+    static constexpr Value Compute(const uint8_t* data, std::size_t size) {
+        return Crc().Update(data, size).value();
+    }
+
+    static constexpr Value Compute(std::string_view s) {
+        return Crc().Update(s).value();
+    }
+
+    static Value Compute(const void* data, std::size_t size) {
+        return Crc().Update(data, size).value();
+    }
+
+    // CRC of the ASCII string "123456789", the catalogue's "check" value.
+    static constexpr Value Check() { return Compute(std::string_view("123456789")); }
+
+private:
+    static constexpr unsigned kRegBits = detail::kRegBits<Value>;
+    static constexpr unsigned kShift   = kRegBits - kWidth;  // non-reflected left-alignment
+
+    static constexpr Value kRegPoly =
+        kReflect ? static_cast<Value>(detail::Reflect(kPoly, kWidth))
+                 : static_cast<Value>(kPoly << kShift);
+    static constexpr Value kRegInit =
+        kReflect ? static_cast<Value>(detail::Reflect(kInit, kWidth))
+                 : static_cast<Value>(kInit << kShift);
+
+    static constexpr detail::Table<Value, kSlices> kTable =
+        detail::MakeTable<Value, kReflect, kSlices>(kRegPoly);
+
+    static constexpr uint32_t Output(Value reg) {
+        return kReflect ? reg : static_cast<uint32_t>(reg >> kShift);
+    }
+
+    static constexpr Value Step(Value reg, uint8_t b) {
+        return detail::Step<Value, kReflect>(reg, b, kTable[0]);
+    }
+
+    // Register byte i in stream order (the first byte to be divided out is 0).
+    static constexpr uint8_t RegByte(Value reg, std::size_t i) {
+        if (i >= sizeof(Value))
+            return 0;
+        return kReflect ? static_cast<uint8_t>(reg >> (8 * i))
+                        : static_cast<uint8_t>(reg >> (kRegBits - 8 - 8 * i));
+    }
+
+    static constexpr Value Run(Value reg, const uint8_t* p, std::size_t n) {
+        if constexpr (kSlices > 1) {
+            // kSlices >= sizeof(Value), so each chunk consumes the whole
+            // register and the new value is a pure XOR of table lookups.
+            for (; n >= kSlices; n -= kSlices, p += kSlices) {
+                Value next = 0;
+                for (std::size_t i = 0; i < kSlices; ++i)
+                    next ^= kTable[kSlices - 1 - i][static_cast<uint8_t>(p[i] ^ RegByte(reg, i))];
+                reg = next;
+            }
+        }
+        for (; n; --n)
+            reg = Step(reg, *p++);
+        return reg;
+    }
+
+    Value reg_ = kRegInit;
+};
+
+// ── Catalogued presets ────────────────────────────────────────────────────────
+
+/// CRC-16/CCITT-FALSE (CRC-16/IBM-3740): XMODEM-style framing, flash records.
+using Crc16Ccitt = Crc<16, 0x1021u, 0xFFFFu, false, 0x0000u, 4>;
+
+/// CRC-32/ISO-HDLC: Ethernet, gzip, PNG, Python's zlib.crc32().
+using Crc32 = Crc<32, 0x04C1'1DB7u, 0xFFFF'FFFFu, true, 0xFFFF'FFFFu, 4>;
+
+/// CRC-32C/ISCSI (Castagnoli): better error detection for short records.
+using Crc32C = Crc<32, 0x1EDC'6F41u, 0xFFFF'FFFFu, true, 0xFFFF'FFFFu, 4>;
+
+/// CRC-32/MPEG-2: the fixed algorithm of the STM32F4 hardware CRC unit.
+using Crc32Mpeg2 = Crc<32, 0x04C1'1DB7u, 0xFFFF'FFFFu, false, 0x0000'0000u, 4>;
+
+// ── Known-answer checks (catalogue "check" values) ───────────────────────────
+// Evaluated by every translation unit that includes this header, on target
+// and host alike.  The sliced variants run the 9-byte check string through one
+// full chunk plus a byte-wise tail.
+static_assert(Crc16Ccitt::Check() == 0x29B1u);
+static_assert(Crc32::Check()      == 0xCBF4'3926u);
+static_assert(Crc32C::Check()     == 0xE306'9283u);
+static_assert(Crc32Mpeg2::Check() == 0x0376'E6E7u);
+
+static_assert(Crc16Ccitt::Sliced<1>::Check() == 0x29B1u);
+static_assert(Crc16Ccitt::Sliced<8>::Check() == 0x29B1u);
+static_assert(Crc32::Sliced<1>::Check()      == 0xCBF4'3926u);
+static_assert(Crc32::Sliced<8>::Check()      == 0xCBF4'3926u);
+static_assert(Crc32C::Sliced<8>::Check()     == 0xE306'9283u);
+static_assert(Crc32Mpeg2::Sliced<8>::Check() == 0x0376'E6E7u);
+
+// CRC-8/SMBUS exercises the 8-bit register path.
+static_assert(Crc<8, 0x07u, 0x00u, false, 0x00u>::Check()    == 0xF4u);
+static_assert(Crc<8, 0x07u, 0x00u, false, 0x00u, 4>::Check() == 0xF4u);
+// CRC-16/KERMIT exercises a reflected sub-32-bit register.
+static_assert(Crc<16, 0x1021u, 0x0000u, true, 0x0000u, 4>::Check() == 0x2189u);
+
+}  // namespace crc
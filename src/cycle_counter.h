@@ -0,0 +1,51 @@
+// Free-running cycle counter for short timing measurements.
+//
+//   const uint32_t t0 = cycle_counter::Now();
+//   …
+//   const uint32_t us = cycle_counter::ElapsedUs(t0);
+//
+// Target: the DWT cycle counter at the core clock (enabled on first use).
+// Host builds (DEMO_HOST_BUILD): steady_clock nanoseconds.  Both are 32 bits
+// wide; take differences before converting so that a wrap (every ~24 s at
+// 180 MHz, ~4 s on the host) does not matter.
+
+#pragma once
+
+#include <cstdint>
+
+#ifdef DEMO_HOST_BUILD
+#include <chrono>
+#else
+#include <modm/board.hpp>
+#endif
+
+namespace cycle_counter {
+
+#ifdef DEMO_HOST_BUILD
+
+inline constexpr uint32_t kPerUs = 1000u;
+
+inline uint32_t Now() {
+    using namespace std::chrono;
+    return static_cast<uint32_t>(
+        duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+#else
+
+inline constexpr uint32_t kPerUs = Board::SystemClock::Frequency / 1'000'000u;
+
+inline uint32_t Now() {
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    return DWT->CYCCNT;
+}
+
+#endif  // DEMO_HOST_BUILD
+
+inline uint32_t ElapsedUs(uint32_t since) { return (Now() - since) / kPerUs; }
+
+}  // namespace cycle_counter
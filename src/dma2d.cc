@@ -0,0 +1,108 @@
+// Chrom-ART fills and copies – see dma2d.h.
+//
+// Registers: RM0090 section 11 (DMA2D).
+
+#include "dma2d.h"
+
+#include <atomic>
+#include <cstring>
+
+#ifndef DEMO_HOST_BUILD
+#include <modm/board.hpp>
+#include <modm/processing/fiber.hpp>
+#endif
+
+namespace dma2d {
+namespace {
+
+std::atomic<uint32_t> pixels_written{0};
+
+uint16_t* At(const Surface& surface, uint16_t x, uint16_t y) {
+    return surface.pixels + size_t{y} * surface.stride + x;
+}
+
+}  // namespace
+
+#ifdef DEMO_HOST_BUILD
+
+void Fill(const Surface& surface, Rect rect, uint16_t color) {
+    for (uint16_t row = 0; row < rect.height; ++row) {
+        uint16_t* p = At(surface, rect.x, static_cast<uint16_t>(rect.y + row));
+        for (uint16_t i = 0; i < rect.width; ++i)
+            p[i] = color;
+    }
+    pixels_written.fetch_add(uint32_t{rect.width} * rect.height, std::memory_order_relaxed);
+}
+
+void Copy(const Surface& surface, Rect from, uint16_t to_x, uint16_t to_y) {
+    for (uint16_t row = 0; row < from.height; ++row) {
+        std::memmove(At(surface, to_x, static_cast<uint16_t>(to_y + row)),
+                     At(surface, from.x, static_cast<uint16_t>(from.y + row)),
+                     size_t{from.width} * sizeof(uint16_t));
+    }
+    pixels_written.fetch_add(uint32_t{from.width} * from.height, std::memory_order_relaxed);
+}
+
+void Wait() {}
+
+#else
+
+namespace {
+
+constexpr uint32_t kMemoryToMemory   = 0;
+constexpr uint32_t kRegisterToMemory = DMA2D_CR_MODE_0 | DMA2D_CR_MODE_1;
+constexpr uint32_t kRgb565           = 2;  // FGPFCCR.CM / OPFCCR.CM
+
+// Waits for the previous transfer; the first one turns the clock on.
+void Acquire() {
+    Wait();
+    if (!(RCC->AHB1ENR & RCC_AHB1ENR_DMA2DEN)) {
+        RCC->AHB1ENR |= RCC_AHB1ENR_DMA2DEN;
+        __DSB();
+    }
+}
+
+// Output side of a transfer, common to both modes; the caller has set up
+// its own registers after Acquire().
+void Start(uint32_t mode, const Surface& surface, uint16_t x, uint16_t y,
+           uint16_t width, uint16_t height) {
+    DMA2D->IFCR   = DMA2D_IFCR_CTCIF | DMA2D_IFCR_CTEIF;
+    DMA2D->OPFCCR = kRgb565;
+    DMA2D->OMAR   = reinterpret_cast<uint32_t>(At(surface, x, y));
+    DMA2D->OOR    = surface.stride - width;
+    DMA2D->NLR    = uint32_t{width} << DMA2D_NLR_PL_Pos | height;
+    DMA2D->CR     = mode | DMA2D_CR_START;
+    pixels_written.fetch_add(uint32_t{width} * height, std::memory_order_relaxed);
+}
+
+}  // namespace
+
+void Fill(const Surface& surface, Rect rect, uint16_t color) {
+    if (rect.width == 0 || rect.height == 0)
+        return;
+    Acquire();
+    DMA2D->OCOLR = color;
+    Start(kRegisterToMemory, surface, rect.x, rect.y, rect.width, rect.height);
+}
+
+void Copy(const Surface& surface, Rect from, uint16_t to_x, uint16_t to_y) {
+    if (from.width == 0 || from.height == 0)
+        return;
+    Acquire();
+    DMA2D->FGMAR   = reinterpret_cast<uint32_t>(At(surface, from.x, from.y));
+    DMA2D->FGOR    = surface.stride - from.width;
+    DMA2D->FGPFCCR = kRgb565;
+    Start(kMemoryToMemory, surface, to_x, to_y, from.width, from.height);
+}
+
+void Wait() {
+    // A transfer error (bad address) also clears START, so this cannot hang.
+    while (DMA2D->CR & DMA2D_CR_START)
+        modm::this_fiber::yield();
+}
+
+#endif  // DEMO_HOST_BUILD
+
+uint32_t PixelsWritten() { return pixels_written.load(std::memory_order_relaxed); }
+
+}  // namespace dma2d
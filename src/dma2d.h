@@ -0,0 +1,53 @@
+// Rectangle fills and copies in RGB565 framebuffers by the Chrom-ART
+// accelerator (DMA2D).
+//
+//   dma2d::Fill(fb, {0, 0, 240, 320}, 0x0000);        // register-to-memory
+//   dma2d::Copy(fb, {4, 0, 236, 256}, 0, 0);           // memory-to-memory
+//   dma2d::Wait();
+//
+// Each call waits for the previous transfer, starts its own and returns
+// while the DMA2D is still moving pixels; Wait() yields to the other fibers
+// until the last one has finished.  One transfer costs a few register
+// writes, so the CPU is free however large the rectangle is; for single
+// pixels it is not faster than a store, but it keeps all drawing ordered.
+//
+// Host builds (DEMO_HOST_BUILD) do the same on the CPU, so pictures rendered
+// there are bit-identical to the board's.
+
+#pragma once
+
+#include <cstdint>
+
+namespace dma2d {
+
+// Pixels, row-major; |stride| is in pixels and may exceed |width|.
+struct Surface {
+    uint16_t* pixels;
+    uint16_t  width;
+    uint16_t  height;
+    uint16_t  stride;
+};
+
+struct Rect {
+    uint16_t x;
+    uint16_t y;
+    uint16_t width;
+    uint16_t height;
+};
+
+// |rect| must lie inside |surface|; empty rectangles are ignored.
+void Fill(const Surface& surface, Rect rect, uint16_t color);
+
+// Moves |from| to the same-sized rectangle at (|to_x|, |to_y|) of |surface|.
+// The DMA2D streams lines top to bottom and pixels left to right, so
+// overlapping rectangles are only allowed when the destination starts
+// before the source (scrolling left or up).
+void Copy(const Surface& surface, Rect from, uint16_t to_x, uint16_t to_y);
+
+void Wait();
+
+// Pixels written by Fill() and Copy() since boot: the work a frame costs,
+// independent of clock and bus speeds.
+uint32_t PixelsWritten();
+
+}  // namespace dma2d
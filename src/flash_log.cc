@@ -0,0 +1,206 @@
+// Append-only flash record log – see flash_log.h.
+
+#include "flash_log.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "crc.h"
+#include "pw_status/try.h"
+
+namespace flash_log {
+namespace {
+
+constexpr uint32_t kMagic     = 0x474F'4C46;  // "FLOG"
+constexpr uint32_t kVersion   = 1;
+constexpr uint32_t kErased    = 0xFFFF'FFFF;
+constexpr uint32_t kCommitted = 0;
+
+constexpr size_t Align(size_t n) { return (n + 3) & ~size_t{3}; }
+
+// ── Record header word ────────────────────────────────────────────────────────
+// The check byte catches garbage and bit rot; a header torn by a power failure
+// has nothing written behind it, so even one that passes the check is harmless.
+
+constexpr uint8_t Check(uint16_t length, uint8_t type) {
+    return static_cast<uint8_t>((length & 0xFF) ^ (length >> 8) ^ type ^ 0x5A);
+}
+
+constexpr uint32_t MakeHeader(uint16_t length, uint8_t type) {
+    return length | (uint32_t{type} << 16) | (uint32_t{Check(length, type)} << 24);
+}
+
+constexpr uint16_t HeaderLength(uint32_t header) { return static_cast<uint16_t>(header); }
+constexpr uint8_t  HeaderType(uint32_t header) { return static_cast<uint8_t>(header >> 16); }
+
+constexpr bool HeaderValid(uint32_t header) {
+    return header != kErased && HeaderLength(header) <= FlashLog::kMaxPayloadSize &&
+           static_cast<uint8_t>(header >> 24) == Check(HeaderLength(header), HeaderType(header));
+}
+
+uint32_t RecordCrc(uint32_t header, pw::span<const std::byte> payload) {
+    return crc::Crc32C().Update(&header, sizeof(header)).Update(payload.data(), payload.size()).value();
+}
+
+// ── Sector header ─────────────────────────────────────────────────────────────
+
+// False for erased, torn or foreign sectors.  Sequence 0 is never written, so
+// a header torn before its last word always fails the ~sequence check.
+bool ReadSectorHeader(const Flash& flash, size_t sector, uint32_t& sequence) {
+    std::array<uint32_t, 4> words;
+    flash.Read(sector, 0, pw::as_writable_bytes(pw::span(words)));
+    sequence = words[2];
+    return words[0] == kMagic && words[1] == kVersion && words[3] == ~words[2] && words[2] != 0;
+}
+
+pw::Status ProgramRecord(Flash& flash, size_t sector, size_t at, uint8_t type,
+                         pw::span<const std::byte> payload) {
+    const uint32_t header = MakeHeader(static_cast<uint16_t>(payload.size()), type);
+    PW_TRY(flash.Program(sector, at, header));
+    PW_TRY(flash.Program(sector, at + 8, RecordCrc(header, payload)));
+    for (size_t i = 0; i < payload.size(); i += 4) {
+        uint32_t word = kErased;
+        std::memcpy(&word, payload.data() + i, std::min<size_t>(4, payload.size() - i));
+        if (word != kErased)
+            PW_TRY(flash.Program(sector, at + FlashLog::kRecordHeaderSize + i, word));
+    }
+    return flash.Program(sector, at + 4, kCommitted);
+}
+
+}  // namespace
+
+// ── Mount ─────────────────────────────────────────────────────────────────────
+
+pw::Status FlashLog::Mount() {
+    mounted_ = false;
+    sectors_ = 0;
+    const size_t count = flash_.sector_count();
+    if (count < 2 || count > kMaxSectors || flash_.sector_size() % 4 != 0 ||
+        flash_.sector_size() < kSectorHeaderSize + kRecordHeaderSize + kMaxPayloadSize)
+        return pw::Status::InvalidArgument();
+
+    // Insertion sort by sequence; there are at most kMaxSectors.
+    std::array<uint32_t, kMaxSectors> sequences{};
+    for (size_t sector = 0; sector < count; ++sector) {
+        uint32_t sequence;
+        if (!ReadSectorHeader(flash_, sector, sequence))
+            continue;
+        size_t i = sectors_++;
+        for (; i > 0 && sequences[i - 1] > sequence; --i) {
+            sequences[i] = sequences[i - 1];
+            order_[i]    = order_[i - 1];
+        }
+        sequences[i] = sequence;
+        order_[i]    = static_cast<uint8_t>(sector);
+    }
+
+    if (sectors_ == 0) {
+        sequence_ = 0;
+        PW_TRY(OpenSector(0));
+        mounted_ = true;
+        return pw::OkStatus();
+    }
+
+    sequence_ = sequences[sectors_ - 1];
+    const size_t active = order_[sectors_ - 1];
+    size_t   offset = kSectorHeaderSize;
+    uint32_t header = kErased;
+    while (const size_t size = RecordAt(active, offset, header))
+        offset += size;
+    // Never append behind a damaged header: the records after it could not be
+    // found again.
+    write_offset_ = header == kErased ? offset : flash_.sector_size();
+    mounted_      = true;
+    return pw::OkStatus();
+}
+
+// ── Append ────────────────────────────────────────────────────────────────────
+
+pw::Status FlashLog::Append(uint8_t type, pw::span<const std::byte> payload) {
+    if (payload.size() > kMaxPayloadSize || type == kInvalidType)
+        return pw::Status::InvalidArgument();
+    if (!mounted_)
+        return pw::Status::FailedPrecondition();
+    if (appending_)
+        return pw::Status::Unavailable();
+    appending_ = true;
+    struct Done {
+        bool& flag;
+        ~Done() { flag = false; }
+    } done{appending_};
+
+    const size_t size = kRecordHeaderSize + Align(payload.size());
+    if (write_offset_ + size > flash_.sector_size())
+        PW_TRY(OpenSector((order_[sectors_ - 1] + 1u) % flash_.sector_count()));
+
+    const size_t   sector = order_[sectors_ - 1];
+    const size_t   at     = write_offset_;
+    write_offset_ += size;
+    const pw::Status status = ProgramRecord(flash_, sector, at, type, payload);
+    if (!status.ok())
+        write_offset_ = flash_.sector_size();  // the header may be torn, see Mount()
+    return status;
+}
+
+// Erases |sector|, writes its header and makes it the active sector.
+pw::Status FlashLog::OpenSector(size_t sector) {
+    // Whatever the sector held is gone from here on, even if the erase fails.
+    const auto end = std::remove(order_.begin(), order_.begin() + sectors_, sector);
+    sectors_       = static_cast<size_t>(end - order_.begin());
+    write_offset_  = flash_.sector_size();
+
+    PW_TRY(flash_.Erase(sector));
+    const uint32_t sequence = sequence_ + 1;
+    PW_TRY(flash_.Program(sector, 0, kMagic));
+    PW_TRY(flash_.Program(sector, 4, kVersion));
+    PW_TRY(flash_.Program(sector, 8, sequence));
+    PW_TRY(flash_.Program(sector, 12, ~sequence));
+
+    order_[sectors_++] = static_cast<uint8_t>(sector);
+    sequence_          = sequence;
+    write_offset_      = kSectorHeaderSize;
+    return pw::OkStatus();
+}
+
+// ── Reading ───────────────────────────────────────────────────────────────────
+
+size_t FlashLog::RecordAt(size_t sector, size_t offset, uint32_t& header) const {
+    header = kErased;
+    if (offset + kRecordHeaderSize > flash_.sector_size())
+        return 0;
+    header = flash_.ReadWord(sector, offset);
+    if (!HeaderValid(header))
+        return 0;
+    const size_t size = kRecordHeaderSize + Align(HeaderLength(header));
+    return offset + size <= flash_.sector_size() ? size : 0;
+}
+
+bool FlashLog::Next(Cursor& cursor, Record& record) const {
+    while (cursor.rank < sectors_) {
+        const size_t sector = order_[cursor.rank];
+        const bool   active = cursor.rank == sectors_ - 1;
+        uint32_t     header;
+        const size_t size = active && cursor.offset >= write_offset_
+                                ? 0
+                                : RecordAt(sector, cursor.offset, header);
+        if (size == 0) {
+            ++cursor.rank;
+            cursor.offset = kSectorHeaderSize;
+            continue;
+        }
+        const size_t at = cursor.offset;
+        cursor.offset += size;
+
+        if (flash_.ReadWord(sector, at + 4) != kCommitted)
+            continue;
+        record.type = HeaderType(header);
+        record.size = HeaderLength(header);
+        const pw::span payload(record.payload.data(), record.size);
+        flash_.Read(sector, at + kRecordHeaderSize, payload);
+        if (flash_.ReadWord(sector, at + 8) == RecordCrc(header, payload))
+            return true;
+    }
+    return false;
+}
+
+}  // namespace flash_log
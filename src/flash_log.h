@@ -0,0 +1,147 @@
+// Append-only, wear-levelled record log in NOR flash.
+//
+//   flash_log::FlashLog log(flash);
+//   PW_TRY(log.Mount());
+//   PW_TRY(log.Append(kType, payload));
+//   log.ForEach([](uint8_t type, pw::span<const std::byte> payload) { …; return true; });
+//
+// The log occupies every sector of a Flash backend and fills them in
+// circular order; when the active sector is full the next one is erased
+// (dropping the oldest records) and becomes active, so all sectors wear
+// evenly.
+//
+// Sector layout (little-endian words):
+//
+//   magic "FLOG" | version | sequence | ~sequence | record | record | … | erased
+//
+// The sequence number grows by one per sector opened; Mount() orders the
+// sectors by it and finds the active one from these 16-byte headers alone.
+// Only inside the active sector does it walk the record headers (one word
+// per record, payloads are not read) to find the end.
+//
+// Record layout:
+//
+//   Offset  Size  Field
+//   ------  ----  -----
+//    0       4    header   payload length (u16) | type (u8) | check (u8)
+//    4       4    commit   0xFFFFFFFF while incomplete, 0 once committed
+//    8       4    crc32c   CRC-32C over header word and payload
+//   12       n    payload, padded with 0xFF to a word boundary
+//
+// Append() programs header, CRC and payload, and the commit word last.  A
+// power failure at any point leaves either a committed, CRC-valid record or
+// one that ForEach() skips; a torn header ends the sector for writing, and
+// the next Append() moves on to a fresh sector.  Sector headers are written
+// right after the erase, so a torn erase or header simply marks the sector
+// as free.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace flash_log {
+
+// ── Flash backend ─────────────────────────────────────────────────────────────
+// NOR semantics: Erase() sets a whole sector to 0xFF, Program() can only
+// clear bits of one aligned 32-bit word.  Offsets are relative to a sector.
+
+class Flash {
+public:
+    virtual ~Flash() = default;
+
+    virtual size_t sector_count() const = 0;
+    virtual size_t sector_size() const  = 0;
+
+    virtual void       Read(size_t sector, size_t offset, pw::span<std::byte> out) const = 0;
+    virtual pw::Status Program(size_t sector, size_t offset, uint32_t word) = 0;
+    virtual pw::Status Erase(size_t sector) = 0;
+
+    uint32_t ReadWord(size_t sector, size_t offset) const {
+        uint32_t word;
+        Read(sector, offset, pw::as_writable_bytes(pw::span(&word, 1)));
+        return word;
+    }
+};
+
+// ── Log ───────────────────────────────────────────────────────────────────────
+
+class FlashLog {
+public:
+    static constexpr size_t  kMaxSectors       = 8;
+    static constexpr size_t  kMaxPayloadSize   = 64;
+    static constexpr size_t  kSectorHeaderSize = 16;
+    static constexpr size_t  kRecordHeaderSize = 12;
+    static constexpr uint8_t kInvalidType      = 0xFF;  // reads as erased flash
+
+    explicit FlashLog(Flash& flash) : flash_(flash) {}
+
+    FlashLog(const FlashLog&)            = delete;
+    FlashLog& operator=(const FlashLog&) = delete;
+
+    // Finds the sectors and the end of the log; formats blank (or entirely
+    // unreadable) flash.  Must succeed before Append() / ForEach().
+    pw::Status Mount();
+
+    // INVALID_ARGUMENT for an oversized payload or kInvalidType,
+    // FAILED_PRECONDITION before Mount(), UNAVAILABLE while another Append()
+    // is erasing a sector (backends may yield during an erase), or the
+    // backend's error.
+    pw::Status Append(uint8_t type, pw::span<const std::byte> payload);
+
+    // Calls fn(type, payload) for every committed, intact record, oldest
+    // first, until fn returns false.  Returns the number of calls.
+    template <typename Fn>
+    size_t ForEach(Fn&& fn) const {
+        size_t calls = 0;
+        Cursor cursor;
+        Record record;
+        while (Next(cursor, record)) {
+            ++calls;
+            if (!fn(record.type, pw::span<const std::byte>(record.payload.data(), record.size)))
+                break;
+        }
+        return calls;
+    }
+
+    bool     mounted() const { return mounted_; }
+    // True while an Append() is under way, which may be erasing the oldest
+    // sector (and yielding): ForEach() from another fiber must wait.
+    bool     busy() const { return appending_; }
+    // Bytes still free in the active sector.
+    size_t   free_in_sector() const { return flash_.sector_size() - write_offset_; }
+    // Sequence number of the active sector; grows by one per sector erase.
+    uint32_t sequence() const { return sequence_; }
+
+private:
+    struct Cursor {
+        size_t rank   = 0;                  // index into order_
+        size_t offset = kSectorHeaderSize;  // within that sector
+    };
+
+    struct Record {
+        uint8_t                                 type = 0;
+        size_t                                  size = 0;
+        std::array<std::byte, kMaxPayloadSize> payload{};
+    };
+
+    bool Next(Cursor& cursor, Record& record) const;
+    // Size of the record at |offset| of |sector|, 0 at the end of the data.
+    size_t RecordAt(size_t sector, size_t offset, uint32_t& header) const;
+    pw::Status OpenSector(size_t sector);
+
+    Flash&   flash_;
+    bool     mounted_      = false;
+    bool     appending_    = false;
+    // Sectors holding data, oldest first; the last one is active.
+    std::array<uint8_t, kMaxSectors> order_{};
+    size_t   sectors_      = 0;
+    size_t   write_offset_ = 0;
+    uint32_t sequence_     = 0;
+};
+
+}  // namespace flash_log
@@ -0,0 +1,109 @@
+// HDLC-lite framing – see hdlc.h.
+
+#include "hdlc.h"
+
+#include "pw_sys_io/sys_io.h"
+
+namespace hdlc {
+
+// ── Encoder ───────────────────────────────────────────────────────────────────
+
+FrameWriter::FrameWriter(uint8_t address) {
+    status_ = pw::sys_io::WriteByte(std::byte{kFlag});
+    const uint8_t header[] = {
+        static_cast<uint8_t>(((address & kMaxAddress) << 1) | 1u),
+        kUiControl,
+    };
+    for (uint8_t b : header)
+        Put(b);
+}
+
+FrameWriter& FrameWriter::Write(pw::span<const std::byte> data) {
+    for (std::byte b : data)
+        Put(static_cast<uint8_t>(b));
+    return *this;
+}
+
+pw::Status FrameWriter::Finish() {
+    const uint32_t fcs = fcs_.value();
+    for (int shift = 0; shift < 32; shift += 8)
+        PutEscaped(static_cast<uint8_t>(fcs >> shift));
+    status_.Update(pw::sys_io::WriteByte(std::byte{kFlag}));
+    return status_;
+}
+
+void FrameWriter::Put(uint8_t b) {
+    fcs_.Update(&b, 1);
+    PutEscaped(b);
+}
+
+void FrameWriter::PutEscaped(uint8_t b) {
+    if (b == kFlag || b == kEscape) {
+        status_.Update(pw::sys_io::WriteByte(std::byte{kEscape}));
+        b ^= kEscapeXor;
+    }
+    status_.Update(pw::sys_io::WriteByte(std::byte{b}));
+}
+
+// ── Decoder ───────────────────────────────────────────────────────────────────
+
+std::optional<Frame> Decoder::Process(std::byte byte) {
+    auto b = static_cast<uint8_t>(byte);
+
+    if (b == kFlag) {
+        // A flag both ends the current frame and may open the next one.
+        std::optional<Frame> frame;
+        if (state_ == State::kFrame && size_ > 0)
+            frame = Complete();
+        else if (state_ == State::kEscaped || state_ == State::kOverflow)
+            ++dropped_;
+        size_  = 0;
+        state_ = State::kFrame;
+        return frame;
+    }
+
+    switch (state_) {
+        case State::kInterFrame:
+        case State::kOverflow:
+            return std::nullopt;
+        case State::kFrame:
+            if (b == kEscape) {
+                state_ = State::kEscaped;
+                return std::nullopt;
+            }
+            break;
+        case State::kEscaped:
+            b ^= kEscapeXor;
+            state_ = State::kFrame;
+            break;
+    }
+
+    if (size_ == buffer_.size()) {
+        state_ = State::kOverflow;
+        return std::nullopt;
+    }
+    buffer_[size_++] = std::byte{b};
+    return std::nullopt;
+}
+
+std::optional<Frame> Decoder::Complete() {
+    if (size_ < kFrameOverhead) {
+        ++dropped_;
+        return std::nullopt;
+    }
+    const auto* data = reinterpret_cast<const uint8_t*>(buffer_.data());
+    const size_t body = size_ - 4;
+    const uint32_t fcs = uint32_t{data[body]}
+                       | uint32_t{data[body + 1]} << 8
+                       | uint32_t{data[body + 2]} << 16
+                       | uint32_t{data[body + 3]} << 24;
+    // Only single-byte addresses and UI frames are used on this link.
+    if (crc::Crc32::Compute(data, body) != fcs || (data[0] & 1u) == 0 ||
+        data[1] != kUiControl) {
+        ++dropped_;
+        return std::nullopt;
+    }
+    return Frame{static_cast<uint8_t>(data[0] >> 1), buffer_.subspan(2, body - 2)};
+}
+
+}  // namespace hdlc
@@ -0,0 +1,93 @@
+// HDLC-lite framing for binary traffic on the shared log UART.
+//
+// Frames use the same encoding as Pigweed's pw_hdlc, so its Python decoder
+// (pw_hdlc.decode.FrameDecoder) and tools/hdlc.py both read them:
+//
+//   0x7E | address | 0x03 | payload … | FCS (CRC-32, LE) | 0x7E
+//
+// The address is a one-byte "one-terminated" varint ((addr << 1) | 1, so
+// addresses 0..127), 0x03 marks an unnumbered-information frame, and the FCS
+// is crc::Crc32 (zlib.crc32) over address, control and payload.  0x7E / 0x7D
+// inside a frame are sent as 0x7D followed by the byte XOR 0x20.
+//
+// Tokenized log lines ("$…\n") never contain 0x7E, so frames and logs can be
+// interleaved on the same port; the decoder skips everything between frames.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "crc.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace hdlc {
+
+inline constexpr uint8_t kFlag       = 0x7E;
+inline constexpr uint8_t kEscape     = 0x7D;
+inline constexpr uint8_t kEscapeXor  = 0x20;
+inline constexpr uint8_t kUiControl  = 0x03;
+inline constexpr uint8_t kMaxAddress = 0x7F;
+
+// Bytes a frame occupies besides its payload: address, control and FCS.
+inline constexpr size_t kFrameOverhead = 1 + 1 + 4;
+
+// ── Encoder ───────────────────────────────────────────────────────────────────
+// Streams one UI frame to pw::sys_io without buffering it, so the payload may
+// be written in several pieces straight from where it lives:
+//
+//   hdlc::FrameWriter w(kAddress);
+//   w.Write(header);
+//   w.Write(BuildMetadataBytes());
+//   w.Finish();
+
+class FrameWriter {
+public:
+    explicit FrameWriter(uint8_t address);
+
+    FrameWriter& Write(pw::span<const std::byte> data);
+    FrameWriter& Write(std::byte b) { return Write(pw::span<const std::byte>(&b, 1)); }
+
+    // Appends the FCS and the closing flag.
+    pw::Status Finish();
+
+private:
+    void Put(uint8_t b);         // counted in the FCS
+    void PutEscaped(uint8_t b);  // sent as is (after escaping)
+
+    crc::Crc32 fcs_;
+    pw::Status status_;
+};
+
+// ── Decoder ───────────────────────────────────────────────────────────────────
+// Fed one byte at a time; the buffer must hold address, control, payload and
+// FCS of the largest frame accepted.  Frames that overflow it or fail the FCS
+// check are dropped and counted.
+
+struct Frame {
+    uint8_t                   address;
+    pw::span<const std::byte> payload;  // valid until the next Process() call
+};
+
+class Decoder {
+public:
+    explicit constexpr Decoder(pw::span<std::byte> buffer) : buffer_(buffer) {}
+
+    std::optional<Frame> Process(std::byte b);
+
+    uint32_t dropped() const { return dropped_; }
+
+private:
+    std::optional<Frame> Complete();
+
+    enum class State : uint8_t { kInterFrame, kFrame, kEscaped, kOverflow };
+
+    pw::span<std::byte> buffer_;
+    size_t              size_    = 0;
+    State               state_   = State::kInterFrame;
+    uint32_t            dropped_ = 0;
+};
+
+}  // namespace hdlc
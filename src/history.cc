@@ -0,0 +1,63 @@
+// Batch results and events in flash – see history.h.
+
+#include "log_config.h"
+
+#include "history.h"
+
+#include <array>
+#include <optional>
+
+#include "cycle_counter.h"
+#include "pw_status/try.h"
+#include "stats.h"
+
+#undef PW_LOG_MODULE_NAME
+#define PW_LOG_MODULE_NAME "HIST"
+
+namespace history {
+namespace {
+
+std::optional<flash_log::FlashLog> store;
+
+pw::Status Append(RecordType type, pw::span<const std::byte> payload) {
+    if (!store || !store->mounted())
+        return pw::Status::FailedPrecondition();
+    return store->Append(static_cast<uint8_t>(type), payload);
+}
+
+}  // namespace
+
+pw::Status Initialize(flash_log::Flash& flash) {
+    store.emplace(flash);
+    const uint32_t   t0     = cycle_counter::Now();
+    const pw::Status status = store->Mount();
+    const uint32_t   us     = cycle_counter::ElapsedUs(t0);
+    if (!status.ok()) {
+        PW_LOG_ERROR("history: mount failed (%s)", status.str());
+        return status;
+    }
+    PW_LOG_INFO("history: mounted in %u us, sector sequence %u, %u bytes free",
+                (unsigned int)us, (unsigned int)store->sequence(),
+                (unsigned int)store->free_in_sector());
+    return RecordEvent(Event::kBoot, store->sequence());
+}
+
+pw::Status RecordBatch(const BatchSummary& summary) {
+    std::array<std::byte, kMaxBatchSize> payload;
+    const size_t size = EncodeBatch(summary, payload);
+    return Append(RecordType::kBatch, pw::span(payload.data(), size));
+}
+
+pw::Status RecordEvent(Event event, uint32_t value) {
+    std::array<std::byte, 3 * 5> payload;
+    size_t size = 0;
+    for (const uint32_t v : {static_cast<uint32_t>(event), value, stats::UptimeMs()})
+        size += pw::varint::Encode(v, pw::span(payload).subspan(size));
+    return Append(RecordType::kEvent, pw::span(payload.data(), size));
+}
+
+const flash_log::FlashLog* Log() {
+    return store && store->mounted() ? &*store : nullptr;
+}
+
+}  // namespace history
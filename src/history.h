@@ -0,0 +1,88 @@
+// Batch results and events kept in internal flash across resets.
+//
+//   history::Initialize(flash);              // once at boot, logs what it found
+//   history::RecordBatch(summary);           // after every processed batch
+//   history::RecordEvent(history::Event::kLogLevel, level);
+//
+// Records go to a flash_log::FlashLog (flash_log.h); the oldest sector is
+// dropped when the log is full.  Read back with Rpc "History.Read"
+// (rpc_services.h) or `python tools/rpc_client.py PORT history`.
+//
+// Payloads are sequences of varints (pw_varint; signed values zigzag-encoded),
+// so a typical batch summary takes about 12 bytes instead of 28:
+//
+//   Type      Payload
+//   --------  ------------------------------------------------------------
+//   kBatch    batch, t_ms, mean (s), min (s), max (s), jitter_max_us,
+//             jitter_mean_us
+//   kEvent    event, value, uptime_ms
+//
+// Fields are only ever appended; readers ignore trailing varints they do not
+// know.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "flash_log.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_varint/varint.h"
+
+namespace history {
+
+enum class RecordType : uint8_t {
+    kBatch = 1,
+    kEvent = 2,
+};
+
+enum class Event : uint8_t {
+    kBoot     = 1,  // value: FlashLog::sequence() (sectors erased so far)
+    kLogLevel = 2,  // value: new log level (Log.SetLevel)
+    kWatchdog = 3,  // value: starved watchdog::Task + 1, 0 if none was
+};
+
+struct BatchSummary {
+    uint32_t batch;
+    uint32_t t_ms;
+    int32_t  mean;
+    int32_t  min;
+    int32_t  max;
+    uint32_t jitter_max_us;
+    uint32_t jitter_mean_us;
+};
+
+// ── Encoding ──────────────────────────────────────────────────────────────────
+// Header-only so host tools can produce realistic payloads without the logger.
+
+inline constexpr size_t kMaxBatchSize = 7 * 5;  // seven 32-bit varints
+
+// Returns the encoded size; |out| must hold kMaxBatchSize bytes.
+inline size_t EncodeBatch(const BatchSummary& s, pw::span<std::byte> out) {
+    size_t n = 0;
+    for (const uint32_t v : {s.batch, s.t_ms})
+        n += pw::varint::Encode(v, out.subspan(n));
+    for (const int32_t v : {s.mean, s.min, s.max})
+        n += pw::varint::Encode(v, out.subspan(n));
+    for (const uint32_t v : {s.jitter_max_us, s.jitter_mean_us})
+        n += pw::varint::Encode(v, out.subspan(n));
+    return n;
+}
+
+static_assert(kMaxBatchSize <= flash_log::FlashLog::kMaxPayloadSize);
+
+// ── Recording ─────────────────────────────────────────────────────────────────
+
+// Mounts the log on |flash| (formatting it if blank), logs how long that
+// took and records Event::kBoot.  Recording before, or after a failed
+// Initialize() returns FAILED_PRECONDITION.
+pw::Status Initialize(flash_log::Flash& flash);
+
+pw::Status RecordBatch(const BatchSummary& summary);
+pw::Status RecordEvent(Event event, uint32_t value);
+
+// The mounted log, or nullptr before a successful Initialize().
+const flash_log::FlashLog* Log();
+
+}  // namespace history
@@ -0,0 +1,65 @@
+// Whole-image integrity check.
+//
+// tools/patch_image.py runs after every link and fills the ImageCheck trailer
+// (section .image_check) with the load address, length and CRC-32 of the
+// complete flash image.  At boot, image_check::Verify() recomputes the CRC
+// over the flashed bytes and compares.
+//
+// The CRC is CRC-32/MPEG-2 (poly 0x04C11DB7, init 0xFFFFFFFF, no reflection,
+// no final XOR) over 32-bit little-endian words — the native algorithm of the
+// STM32F4 CRC unit, which processes one word per AHB write.  Host builds
+// (DEMO_HOST_BUILD) use a slicing-by-8 software kernel with the same result.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_status/status.h"
+
+namespace image_check {
+
+// ── Trailer in .image_check ───────────────────────────────────────────────────
+// Binary layout (16 bytes, little-endian, word-aligned):
+//
+//   Offset  Size  Field
+//   ------  ----  -----
+//    0       4    magic    "IMGC"
+//    4       4    base     load address of the first image byte
+//    8       4    length   image size in bytes (multiple of 4)
+//   12       4    crc32    CRC over [base, base+length) with this field as 0
+//
+// base / length / crc32 are zero until the post-link step has run (e.g. when
+// the ELF was linked by hand without the CMake POST_BUILD commands).
+
+struct ImageCheck {
+    char     magic[4];
+    uint32_t base;
+    uint32_t length;
+    uint32_t crc32;
+};
+
+static_assert(sizeof(ImageCheck) == 16,
+              "ImageCheck layout changed – update tools/patch_image.py");
+
+inline constexpr uint32_t kCrcInit = 0xFFFF'FFFFu;
+
+// CRC-32/MPEG-2 of |count| words.  The word at |zeroed| (if it lies inside the
+// range) is fed as 0 instead of its stored value, which lets the check cover
+// the trailer that holds the expected CRC.
+uint32_t ComputeCrc(const uint32_t* words,
+                    size_t          count,
+                    const uint32_t* zeroed = nullptr);
+
+struct Result {
+    pw::Status status;       // OK, DataLoss (mismatch) or FailedPrecondition (unpatched)
+    uint32_t   expected;     // CRC stored by the post-link step
+    uint32_t   actual;       // CRC computed over the flashed image
+    uint32_t   length;       // bytes covered
+    uint32_t   duration_us;  // time spent in ComputeCrc
+};
+
+// Checks the running image against the trailer placed in .image_check.
+Result Verify();
+
+}  // namespace image_check
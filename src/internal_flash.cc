@@ -0,0 +1,101 @@
+// Internal flash backend for the flash log – see internal_flash.h.
+//
+// Register sequences follow RM0090 section 3.6 (flash program / erase).
+
+#include "internal_flash.h"
+
+#include <cstring>
+
+#include <modm/board.hpp>
+#include <modm/processing/fiber.hpp>
+
+namespace internal_flash {
+namespace {
+
+constexpr uint32_t kKey1 = 0x4567'0123;
+constexpr uint32_t kKey2 = 0xCDEF'89AB;
+
+constexpr uint32_t kErrors = FLASH_SR_PGSERR | FLASH_SR_PGPERR | FLASH_SR_PGAERR |
+                             FLASH_SR_WRPERR | FLASH_SR_OPERR;
+
+// Sectors 17–23 are the 128 KB sectors of bank 2.
+constexpr uintptr_t kSector17 = 0x0812'0000;
+
+// From Unlock() until Finish() has read the flags in FLASH_SR.  The flags are
+// shared by both partitions: another fiber's operation must not start, and
+// clear them, between the end of an erase (BSY) and its Finish().
+bool operation_running = false;
+
+void Unlock() {
+    operation_running = true;
+    if (FLASH->CR & FLASH_CR_LOCK) {
+        FLASH->KEYR = kKey1;
+        FLASH->KEYR = kKey2;
+    }
+    FLASH->SR = kErrors | FLASH_SR_EOP;
+}
+
+// Ends the operation, locks the controller again and reports its errors.
+// The data cache may still hold the old contents of the changed words
+// (RM0090 3.5.2), so it is reset as well; that only costs its 8 lines.
+pw::Status Finish() {
+    const uint32_t sr = FLASH->SR;
+    FLASH->SR  = kErrors | FLASH_SR_EOP;
+    FLASH->CR  = FLASH_CR_LOCK;
+    FLASH->ACR &= ~FLASH_ACR_DCEN;
+    FLASH->ACR |= FLASH_ACR_DCRST;
+    FLASH->ACR &= ~FLASH_ACR_DCRST;
+    FLASH->ACR |= FLASH_ACR_DCEN;
+    operation_running = false;
+    return (sr & kErrors) ? pw::Status::Internal() : pw::OkStatus();
+}
+
+// Until the other partition's program or erase is done and its errors are
+// collected; touching bank 2 before that would stall the CPU, every fiber
+// with it.
+void WaitIdle() {
+    while (operation_running || (FLASH->SR & FLASH_SR_BSY))
+        modm::this_fiber::yield();
+}
+
+}  // namespace
+
+uintptr_t InternalFlash::Address(size_t sector, size_t offset) const {
+    return kSector17 + (first_sector_ + sector - 17) * kSectorSize + offset;
+}
+
+// Bank 2 sectors 12–23 are numbered 16–27 in FLASH_CR.SNB.
+uint32_t InternalFlash::Snb(size_t sector) const {
+    return static_cast<uint32_t>(16 + (first_sector_ + sector - 12));
+}
+
+void InternalFlash::Read(size_t sector, size_t offset, pw::span<std::byte> out) const {
+    WaitIdle();
+    std::memcpy(out.data(), reinterpret_cast<const void*>(Address(sector, offset)), out.size());
+}
+
+pw::Status InternalFlash::Program(size_t sector, size_t offset, uint32_t word) {
+    if (sector >= sector_count_ || offset % 4 != 0 || offset + 4 > kSectorSize)
+        return pw::Status::OutOfRange();
+    WaitIdle();
+    Unlock();
+    FLASH->CR = FLASH_CR_PSIZE_1 | FLASH_CR_PG;
+    *reinterpret_cast<volatile uint32_t*>(Address(sector, offset)) = word;
+    __DSB();
+    while (FLASH->SR & FLASH_SR_BSY) {}
+    return Finish();
+}
+
+pw::Status InternalFlash::Erase(size_t sector) {
+    if (sector >= sector_count_)
+        return pw::Status::OutOfRange();
+    WaitIdle();
+    Unlock();
+    FLASH->CR  = FLASH_CR_PSIZE_1 | FLASH_CR_SER | (Snb(sector) << FLASH_CR_SNB_Pos);
+    FLASH->CR |= FLASH_CR_STRT;
+    while (FLASH->SR & FLASH_SR_BSY)
+        modm::this_fiber::yield();
+    return Finish();
+}
+
+}  // namespace internal_flash
@@ -0,0 +1,67 @@
+// A run of the STM32F429's 128 KB flash sectors as a flash_log::Flash
+// backend.
+//
+// The last six sectors (6 × 128 KB at 0x0814'0000, bank 2) are reserved for
+// data by the linker script (lbuild.xml: linkerscript.flash_reserved), so the
+// image can grow to 1.25 MB:
+//
+//   Sectors  Address      Used by
+//   -------  -----------  -------------------------------
+//   18–19    0x0814'0000  configuration store (config.h)
+//   20–23    0x0818'0000  batch history (history.h)
+//
+// The code runs from bank 1 and keeps executing while bank 2 programs or
+// erases (read-while-write).  Bank 2 itself cannot be read meanwhile: an
+// access stalls the CPU until the operation ends.  Read(), Program() and
+// Erase() therefore first yield until no operation is running (FLASH_SR.BSY)
+// and its error flags, which both partitions share, have been read, so a
+// fiber that reads one partition while another fiber erases the other waits
+// for up to kMaxEraseMs without stalling the rest.  The fiber that waits
+// checks in with the watchdog that much later; its deadline must allow for
+// it (main.cpp: the log drain, as History.Read and Log.SetLevel run in the
+// UART fiber).
+//
+// Programming is word-wise (PSIZE x32, needs VDD ≥ 2.7 V as on the
+// Discovery board) and takes ~16 µs per word; Program() busy-waits.  A sector
+// erase takes 1–2 s, during which Erase() yields to the other fibers.
+
+#pragma once
+
+#include "flash_log.h"
+
+namespace internal_flash {
+
+class InternalFlash final : public flash_log::Flash {
+public:
+    static constexpr size_t kSectorSize = 128 * 1024;
+
+    // |count| sectors from |first_sector| on, all within the reserved ones.
+    constexpr InternalFlash(size_t first_sector, size_t count)
+        : first_sector_(first_sector), sector_count_(count) {}
+
+    size_t sector_count() const override { return sector_count_; }
+    size_t sector_size() const override { return kSectorSize; }
+
+    void       Read(size_t sector, size_t offset, pw::span<std::byte> out) const override;
+    pw::Status Program(size_t sector, size_t offset, uint32_t word) override;
+    pw::Status Erase(size_t sector) override;
+
+private:
+    uintptr_t Address(size_t sector, size_t offset) const;
+    // FLASH_CR.SNB of |sector|.
+    uint32_t Snb(size_t sector) const;
+
+    size_t first_sector_;
+    size_t sector_count_;
+};
+
+// Longest 128 KB sector erase (RM0090 / datasheet tERASE128KB, x32).
+inline constexpr uint32_t kMaxEraseMs = 2000;
+
+// The partitions of the reserved sectors.
+inline constexpr size_t kConfigSector   = 18;
+inline constexpr size_t kConfigSectors  = 2;
+inline constexpr size_t kHistorySector  = 20;
+inline constexpr size_t kHistorySectors = 4;
+
+}  // namespace internal_flash
@@ -0,0 +1,170 @@
+// LTDC + ILI9341 display – see lcd.h.
+//
+// Controller set-up and panel timings follow ST's STM32F429I-Discovery BSP
+// (ili9341.c, stm32f429i_discovery_lcd.c); registers: RM0090 section 16
+// (LTDC) and 6.3.23 (PLLSAI).
+
+#include "lcd.h"
+
+#include <chrono>
+#include <initializer_list>
+
+#include "memory_region.h"
+
+#ifndef DEMO_HOST_BUILD
+#include <modm/board.hpp>
+
+#include "pin_mux.h"
+#endif
+
+namespace lcd {
+namespace {
+
+dma2d::Surface framebuffer{};
+
+#ifndef DEMO_HOST_BUILD
+
+using namespace modm::platform;
+using namespace modm::literals;
+
+// ── ILI9341 over SPI5 ─────────────────────────────────────────────────────────
+
+using Spi = SpiMaster5;
+using Cs  = GpioC2;
+using Dcx = GpioD13;  // low: command, high: parameter
+
+void Send(uint8_t command, std::initializer_list<uint8_t> parameters = {}) {
+    Cs::reset();
+    Dcx::reset();
+    Spi::transferBlocking(command);
+    Dcx::set();
+    for (uint8_t p : parameters)
+        Spi::transferBlocking(p);
+    Cs::set();
+}
+
+void InitializeController() {
+    Cs::setOutput(modm::Gpio::High);
+    Dcx::setOutput(modm::Gpio::High);
+    Spi::connect<GpioF7::Sck, GpioF9::Mosi>();
+    Spi::initialize<Board::SystemClock, 5.625_MHz>();
+
+    Send(0xCA, {0xC3, 0x08, 0x50});                    // undocumented, as ST sends it
+    Send(0xCF, {0x00, 0xC1, 0x30});                    // power control B
+    Send(0xED, {0x64, 0x03, 0x12, 0x81});              // power-on sequence
+    Send(0xE8, {0x85, 0x00, 0x78});                    // driver timing A
+    Send(0xCB, {0x39, 0x2C, 0x00, 0x34, 0x02});        // power control A
+    Send(0xF7, {0x20});                                // pump ratio
+    Send(0xEA, {0x00, 0x00});                          // driver timing B
+    Send(0xB1, {0x00, 0x1B});                          // frame rate
+    Send(0xB6, {0x0A, 0xA2});                          // display function
+    Send(0xC0, {0x10});                                // power control 1
+    Send(0xC1, {0x10});                                // power control 2
+    Send(0xC5, {0x45, 0x15});                          // VCOM 1
+    Send(0xC7, {0x90});                                // VCOM 2
+    Send(0x36, {0xC8});                                // memory access: mirrored, BGR
+    Send(0xF2, {0x00});                                // 3-gamma off
+    Send(0xB0, {0xC2});                                // RGB interface, DE mode
+    Send(0xB6, {0x0A, 0xA7, 0x27, 0x04});              // display function
+    Send(0x2A, {0x00, 0x00, 0x00, 0xEF});              // columns 0–239
+    Send(0x2B, {0x00, 0x00, 0x01, 0x3F});              // rows 0–319
+    Send(0xF6, {0x01, 0x00, 0x06});                    // RGB interface, no GRAM
+    Send(0x2C);
+    modm::delay(std::chrono::milliseconds(200));
+    Send(0x26, {0x01});                                // gamma curve 1
+    Send(0xE0, {0x0F, 0x29, 0x24, 0x0C, 0x0E, 0x09, 0x4E, 0x78,
+                0x3C, 0x09, 0x13, 0x05, 0x17, 0x11, 0x00});
+    Send(0xE1, {0x00, 0x16, 0x1B, 0x04, 0x11, 0x07, 0x31, 0x33,
+                0x42, 0x05, 0x0C, 0x0A, 0x28, 0x2F, 0x0F});
+    Send(0x11);                                        // sleep out
+    modm::delay(std::chrono::milliseconds(200));
+    Send(0x29);                                        // display on
+    Send(0x2C);
+}
+
+// ── LTDC ──────────────────────────────────────────────────────────────────────
+
+// Panel timings in pixel clocks / lines.
+constexpr uint32_t kHsync = 10, kHbp = 20, kHfp = 10;
+constexpr uint32_t kVsync = 2,  kVbp = 2,  kVfp = 4;
+
+constexpr uint32_t kHseHz = 8'000'000;  // board crystal
+
+// 6 MHz: PLLSAI at 192 MHz, R / 4, then / 8.  The PLLs share PLLM with the
+// system clock, so N is derived from the input frequency modm configured.
+void StartPixelClock() {
+    const uint32_t pllm     = (RCC->PLLCFGR & RCC_PLLCFGR_PLLM) >> RCC_PLLCFGR_PLLM_Pos;
+    const uint32_t input_hz = kHseHz / pllm;
+    const uint32_t n        = 192'000'000 / input_hz;
+    RCC->PLLSAICFGR = n << RCC_PLLSAICFGR_PLLSAIN_Pos |
+                      7u << RCC_PLLSAICFGR_PLLSAIQ_Pos |
+                      4u << RCC_PLLSAICFGR_PLLSAIR_Pos;
+    RCC->DCKCFGR = (RCC->DCKCFGR & ~RCC_DCKCFGR_PLLSAIDIVR) | RCC_DCKCFGR_PLLSAIDIVR_1;
+    RCC->CR |= RCC_CR_PLLSAION;
+    while (!(RCC->CR & RCC_CR_PLLSAIRDY)) {}
+}
+
+void InitializeLtdc() {
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN | RCC_AHB1ENR_GPIOBEN | RCC_AHB1ENR_GPIOCEN |
+                    RCC_AHB1ENR_GPIODEN | RCC_AHB1ENR_GPIOFEN | RCC_AHB1ENR_GPIOGEN;
+    RCC->APB2ENR |= RCC_APB2ENR_LTDCEN;
+    __DSB();
+
+    // RGB666 bus, sync signals and pixel clock.
+    constexpr uint32_t kLtdc = 14, kLtdcAlt = 9;
+    pin_mux::SetAlternate(GPIOA, 0b0001'1000'0101'1000, kLtdc);     // B5, VSYNC, G2, R4, R5
+    pin_mux::SetAlternate(GPIOB, 0b0000'1111'0000'0000, kLtdc);     // B6, B7, G4, G5
+    pin_mux::SetAlternate(GPIOB, 0b0000'0000'0000'0011, kLtdcAlt);  // R3, R6
+    pin_mux::SetAlternate(GPIOC, 0b0000'0100'1100'0000, kLtdc);     // HSYNC, G6, R2
+    pin_mux::SetAlternate(GPIOD, 0b0000'0000'0100'1000, kLtdc);     // G7, B2
+    pin_mux::SetAlternate(GPIOF, 0b0000'0100'0000'0000, kLtdc);     // DE
+    pin_mux::SetAlternate(GPIOG, 0b0000'1000'1100'0000, kLtdc);     // R7, CLK, B3
+    pin_mux::SetAlternate(GPIOG, 0b0001'0100'0000'0000, kLtdcAlt);  // G3, B4
+
+    StartPixelClock();
+
+    // Accumulated positions, each register holding the last clock of its area.
+    constexpr uint32_t kActiveX = kHsync + kHbp, kActiveY = kVsync + kVbp;
+    LTDC->SSCR = (kHsync - 1) << 16 | (kVsync - 1);
+    LTDC->BPCR = (kActiveX - 1) << 16 | (kActiveY - 1);
+    LTDC->AWCR = (kActiveX + kWidth - 1) << 16 | (kActiveY + kHeight - 1);
+    LTDC->TWCR = (kActiveX + kWidth + kHfp - 1) << 16 | (kActiveY + kHeight + kVfp - 1);
+    LTDC->BCCR = 0;
+    // Sync and DE active low, pixel clock inverted.
+    LTDC->GCR  = LTDC_GCR_PCPOL;
+
+    LTDC_Layer1->WHPCR  = (kActiveX + kWidth - 1) << 16 | kActiveX;
+    LTDC_Layer1->WVPCR  = (kActiveY + kHeight - 1) << 16 | kActiveY;
+    LTDC_Layer1->PFCR   = 2;  // RGB565
+    LTDC_Layer1->CACR   = 0xFF;
+    LTDC_Layer1->CFBAR  = reinterpret_cast<uint32_t>(framebuffer.pixels);
+    LTDC_Layer1->CFBLR  = uint32_t{framebuffer.stride} * 2 << 16 | (kWidth * 2 + 3);
+    LTDC_Layer1->CFBLNR = kHeight;
+    LTDC_Layer1->CR     = LTDC_LxCR_LEN;
+    LTDC->SRCR          = LTDC_SRCR_IMR;
+    LTDC->GCR          |= LTDC_GCR_LTDCEN;
+}
+
+#endif  // DEMO_HOST_BUILD
+
+}  // namespace
+
+pw::Status Initialize() {
+    const pw::span<uint16_t> pixels = memory_region::Allocate<uint16_t>(
+        memory_region::Region::kSdram, size_t{kWidth} * kHeight);
+    if (pixels.empty())
+        return pw::Status::FailedPrecondition();
+    framebuffer = {pixels.data(), kWidth, kHeight, kWidth};
+    dma2d::Fill(framebuffer, {0, 0, kWidth, kHeight}, 0x0000);
+    dma2d::Wait();
+
+#ifndef DEMO_HOST_BUILD
+    InitializeController();
+    InitializeLtdc();
+#endif
+    return pw::OkStatus();
+}
+
+const dma2d::Surface& Framebuffer() { return framebuffer; }
+
+}  // namespace lcd
@@ -0,0 +1,37 @@
+// The board's 2.4" 240 × 320 TFT, refreshed by the LTDC from a framebuffer in
+// external SDRAM.
+//
+//   lcd::Initialize();                      // after memory_region::EnableSdram()
+//   dma2d::Fill(lcd::Framebuffer(), …);     // draw; visible on the next refresh
+//
+// The ILI9341 controller is switched to its RGB interface once over SPI5;
+// from then on the LTDC streams the framebuffer (RGB565, portrait, 150 KB)
+// at ~65 Hz without CPU involvement.  That costs ~10 MB/s of SDRAM
+// bandwidth, which shows in memory_bench's SDRAM figures.  Drawing is not
+// synchronised to the refresh, so a rectangle may appear one frame late
+// or, rarely, half drawn for one frame.
+//
+// Host builds (DEMO_HOST_BUILD) only allocate the framebuffer; see
+// host/ppm.h for looking at it.
+
+#pragma once
+
+#include <cstdint>
+
+#include "dma2d.h"
+#include "pw_status/status.h"
+
+namespace lcd {
+
+inline constexpr uint16_t kWidth  = 240;
+inline constexpr uint16_t kHeight = 320;
+
+// Takes the framebuffer from memory_region::Region::kSdram (call before
+// capture::Initialize() claims the rest), clears it and turns the display
+// on.  FAILED_PRECONDITION without SDRAM.
+pw::Status Initialize();
+
+// Null pixels before a successful Initialize().
+const dma2d::Surface& Framebuffer();
+
+}  // namespace lcd
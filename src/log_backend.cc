@@ -1,6 +1,7 @@
 /**
- * pw_sys_io backend for the STM32F429I-DISCO – routes all Pigweed I/O through
- * modm's buffered UART on the ST-Link virtual COM port.
+ * pw_sys_io backend for the STM32F429I-DISCO – output goes to the Data
+ * transport (transport.h: modm's buffered UART on the ST-Link virtual COM
+ * port), input comes from that UART.
  *
  * Pigweed's pw_log_basic calls pw::sys_io::WriteLine() to emit each formatted
  * log line.  This file provides the three primitive functions that the
@@ -13,37 +14,50 @@
  * The facade itself builds ReadBytes/WriteBytes on top of those, and
  * log_basic.cc calls sys_io::WriteLine which is implemented here because the
  * facade only provides ReadBytes/WriteBytes but not WriteLine.
+ *
+ * Input feeds the RPC server (rpc.cc, polled by the UART fiber); received bytes
+ * are buffered by modm's UART RX interrupt (buffer size set in lbuild.xml).
  */
 
 #include "pw_sys_io/sys_io.h"
 
 #include <modm/board.hpp>
 
+#include "transport.h"
+
 namespace pw::sys_io {
 
 // ── Output ────────────────────────────────────────────────────────────────────
 
+// Yields to the other fibers while the transport is busy (transport.cc).
 Status WriteByte(std::byte b) {
-    Board::stlink::Uart::write(static_cast<uint8_t>(b));
+    transport::Data::Write(pw::span<const std::byte>(&b, 1));
     return OkStatus();
 }
 
 StatusWithSize WriteLine(std::string_view s) {
     for (char c : s) {
-        Board::stlink::Uart::write(static_cast<uint8_t>(c));
+        WriteByte(static_cast<std::byte>(c));
     }
-    Board::stlink::Uart::write('\n');
+    WriteByte(std::byte{'\n'});
     return StatusWithSize(s.size() + 1);
 }
 
-// ── Input (not used; stubs satisfy the linker) ────────────────────────────────
+// ── Input ─────────────────────────────────────────────────────────────────────
 
-Status ReadByte(std::byte*) {
-    return Status::Unimplemented();
+Status ReadByte(std::byte* dest) {
+    while (!TryReadByte(dest).ok()) {
+    }
+    return OkStatus();
 }
 
-Status TryReadByte(std::byte*) {
-    return Status::Unavailable();
+Status TryReadByte(std::byte* dest) {
+    uint8_t c;
+    if (!Board::stlink::Uart::read(c)) {
+        return Status::Unavailable();
+    }
+    *dest = static_cast<std::byte>(c);
+    return OkStatus();
 }
 
 }  // namespace pw::sys_io
@@ -0,0 +1,24 @@
+// pw_log for this firmware's sources: the compact message format, then
+// pw_log/log.h itself.
+//
+//   #include "log_config.h"             // instead of "pw_log/log.h"
+//   …
+//   #undef PW_LOG_MODULE_NAME           // after the last include
+//   #define PW_LOG_MODULE_NAME "HIST"
+//
+// The default tokenized format (■msg♦…■module♦…■file♦…) is replaced by
+// "[MODULE] message".  pw_log_tokenized/config.h only defines its own with
+// #ifndef, so this must be seen before anything includes pw_log/log.h; a
+// file that gets it earlier through another header fails to compile.  The
+// format is part of every token, so all files share it.  The module name is
+// set per file after the includes, where no header can override it again.
+
+#pragma once
+
+#ifdef PW_LOG_TOKENIZED_FORMAT_STRING
+#error "include log_config.h before anything that includes pw_log/log.h"
+#endif
+
+#define PW_LOG_TOKENIZED_FORMAT_STRING(module, message) "[" module "] " message
+
+#include "pw_log/log.h"
@@ -0,0 +1,42 @@
+// Runtime log control: verbosity and output of the tokenized log handler.
+//
+// pw_log compiles in every statement at or above PW_LOG_LEVEL; this adds a
+// threshold that can be raised and lowered at runtime (Log.SetLevel RPC, see
+// rpc_services.h).  The tokenized log handler (log_tokenized_handler.cc)
+// drops messages below the threshold, queues the rest, and Drainer() sends
+// them to the Log transport (transport.h, normally the UART).
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "coro.h"
+
+namespace log_control {
+
+// pw_log level numbers: PW_LOG_LEVEL_DEBUG (1) … PW_LOG_LEVEL_FATAL (7).
+// The default passes everything that was compiled in.
+void    SetLevel(uint8_t level);
+uint8_t Level();
+
+uint32_t Emitted();   // messages written to the Log transport
+uint32_t Filtered();  // messages dropped by the level threshold
+uint32_t Dropped();   // messages lost because the queue was full
+
+// Queued messages are sent by one consumer at a time: normally the Drainer()
+// coroutine, or Drain() (crash handler, host shutdown).  A flag enforces it:
+// Drainer() waits while Drain() runs, even if Drain() yields in the
+// transport, and Drain() does nothing while Drainer() is popping (an
+// interrupt handler that preempted it).  Logging itself is allowed from
+// anywhere, including interrupt handlers.
+
+// Writes every queued message to the Log transport, byte by byte, and returns
+// how many; 0 without draining if Drainer() is in the middle of a message.
+size_t Drain();
+
+// Coroutine that sends queued messages through transport::Log forever; spawn
+// it once with coro::Spawn() and keep calling coro::RunReady().
+coro::Task Drainer();
+
+}  // namespace log_control
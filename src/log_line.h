@@ -0,0 +1,63 @@
+// The text form of a tokenized log message: '$', the Base64 of token ++
+// encoded arguments, '\n' – what pw_tokenizer.detokenize reads from a serial
+// port.
+//
+//   log_line::Encode(data, size, [&](char c) { line[n++] = c; });
+//
+// Header-only: log_tokenized_handler.cc encodes every message sent to a text
+// transport with it, and the benchmarks (bench.h) time it without the logger.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace log_line {
+
+// Characters Encode() writes for a message of |size_bytes|.
+constexpr size_t Size(size_t size_bytes) { return 2 + 4 * ((size_bytes + 2) / 3); }
+
+// Writes '$' + Base64(|data|) + '\n', one character at a time through |put|.
+template <typename Put>
+void Encode(const uint8_t data[], size_t size_bytes, Put&& put) {
+    // RFC 4648 alphabet, indexed by a 6-bit group.
+    static constexpr char kTable[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    auto put64 = [&](uint32_t idx) { put(kTable[idx & 0x3F]); };
+
+    // '$' marks the start of a Pigweed tokenized message.
+    put('$');
+
+    // Encode |data| as standard Base64, 3 input bytes → 4 output chars.
+    size_t i = 0;
+    for (; i + 2 < size_bytes; i += 3) {
+        const uint32_t g = (static_cast<uint32_t>(data[i])     << 16) |
+                           (static_cast<uint32_t>(data[i + 1]) <<  8) |
+                            static_cast<uint32_t>(data[i + 2]);
+        put64(g >> 18);
+        put64(g >> 12);
+        put64(g >>  6);
+        put64(g);
+    }
+
+    // Remaining 1 or 2 bytes, padded with '=' to a 4-char group.
+    if (i < size_bytes) {
+        const uint32_t g = (static_cast<uint32_t>(data[i]) << 16) |
+                           (i + 1 < size_bytes
+                                ? static_cast<uint32_t>(data[i + 1]) << 8
+                                : 0u);
+        put64(g >> 18);
+        put64(g >> 12);
+        if (i + 1 < size_bytes) {
+            put64(g >> 6);
+        } else {
+            put('=');
+        }
+        put('=');
+    }
+
+    // Newline terminates the message on the wire.
+    put('\n');
+}
+
+}  // namespace log_line
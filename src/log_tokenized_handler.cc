@@ -10,6 +10,11 @@
  *
  *   '$' <base64(token ++ encoded_args)> '\n'
  *
+ * Binary transports (transport.h kBinary: the ITM log port) get the message
+ * unencoded, decoded on the host by tools/swo_decode.py:
+ *
+ *   0xA5 <length, u16 little endian> <token ++ encoded_args>
+ *
  * To decode on the host:
  *
  *   # 1. Extract token database from the ELF (run once after each build):
@@ -19,69 +24,147 @@
  *   # 2. Live decode from serial port:
  *   python -m pw_tokenizer.detokenize \
  *       --database tokens.csv serial --device /dev/ttyACM0 --baud 115200
+ *
+ * Messages below the runtime threshold of log_control.h are dropped here.
+ *
+ * The handler does not write to the UART itself: it copies the message into a
+ * lock-free MPSC queue (mpsc_queue.h) and the log_control::Drainer()
+ * coroutine emits whole messages to the Log transport (transport.h), with
+ * the UART encoding the next one while DMA sends the previous one
+ * (async_uart.h).  PW_LOG_* is therefore safe in interrupt
+ * handlers – a message logged by an ISR can never land in the middle of one
+ * being sent from thread context.
  */
 
 #include "pw_log_tokenized/handler.h"
 
-#include <modm/board.hpp>
+#include <array>
+#include <atomic>
+
+#include "log_control.h"
+#include "log_line.h"
+#include "mpsc_queue.h"
+#include "pw_log/levels.h"
+#include "pw_log_tokenized/metadata.h"
+#include "transport.h"
+#include "watchdog.h"
 
 namespace {
 
-// Emit a single byte to the ST-Link virtual COM port.
-inline void Emit(uint8_t b) {
-    Board::stlink::Uart::write(b);
+std::atomic<uint8_t>  min_level{PW_LOG_LEVEL_DEBUG};
+std::atomic<uint32_t> emitted{0};
+std::atomic<uint32_t> filtered{0};
+
+// Holds about 80 typical messages (token + a few varint arguments).
+using LogQueue = MpscRecordQueue<2048>;
+constinit LogQueue queue;
+
+// Emit a single byte through the Log transport.
+inline void Emit(char c) {
+    const std::byte b{static_cast<uint8_t>(c)};
+    transport::Log::Write(pw::span<const std::byte>(&b, 1));
 }
 
-// Emit the Base64 character for a 6-bit index (RFC 4648 alphabet).
-inline void EmitBase64(uint8_t idx) {
-    static constexpr char kTable[] =
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-    Emit(static_cast<uint8_t>(kTable[idx & 0x3F]));
+// kFrameMarker | length | message, for binary transports.
+template <typename Put>
+void FrameMessage(const uint8_t data[], size_t size_bytes, Put&& put) {
+    put(static_cast<char>(transport::kFrameMarker));
+    put(static_cast<char>(size_bytes & 0xFF));
+    put(static_cast<char>(size_bytes >> 8));
+    for (size_t i = 0; i < size_bytes; ++i)
+        put(static_cast<char>(data[i]));
 }
 
+// The encoding transport::Log expects.
+template <typename Put>
+void Encode(pw::span<const std::byte> message, Put&& put) {
+    const auto* data = reinterpret_cast<const uint8_t*>(message.data());
+    if constexpr (transport::Log::kBinary)
+        FrameMessage(data, message.size(), put);
+    else
+        log_line::Encode(data, message.size(), put);
+}
+
+// Held by the one consumer while it pops: Drainer() around each Pop(),
+// Drain() for the whole drain.  MpscRecordQueue allows a single consumer.
+std::atomic<bool> consumer_busy{false};
+
+// Encoded lines for the Drainer() coroutine.  Two, because WriteAsync() may
+// return while DMA is still reading the previous one.
+constexpr size_t kMaxLineSize = log_line::Size(LogQueue::kMaxPayloadSize);
+std::array<std::array<std::byte, kMaxLineSize>, 2> lines;
+
 }  // namespace
 
+// ── log_control.h ─────────────────────────────────────────────────────────────
+
+namespace log_control {
+
+void SetLevel(uint8_t level) { min_level.store(level, std::memory_order_relaxed); }
+uint8_t Level() { return min_level.load(std::memory_order_relaxed); }
+uint32_t Emitted() { return emitted.load(std::memory_order_relaxed); }
+uint32_t Filtered() { return filtered.load(std::memory_order_relaxed); }
+uint32_t Dropped() { return queue.dropped(); }
+
+size_t Drain() {
+    if (consumer_busy.exchange(true, std::memory_order_acquire))
+        return 0;
+    const size_t count =
+        queue.Drain([](uint32_t /*metadata*/, pw::span<const std::byte> message) {
+            Encode(message, Emit);
+            emitted.fetch_add(1, std::memory_order_relaxed);
+        });
+    consumer_busy.store(false, std::memory_order_release);
+    return count;
+}
+
+coro::Task Drainer() {
+    for (size_t next = 0;; next ^= 1) {
+        std::array<std::byte, kMaxLineSize>& line = lines[next];
+        size_t length = 0;
+        for (;;) {
+            // Drain() owns the queue: wait until it is done.
+            if (!consumer_busy.exchange(true, std::memory_order_acquire)) {
+                const bool popped =
+                    queue.Pop([&](uint32_t /*metadata*/, pw::span<const std::byte> message) {
+                        Encode(message,
+                               [&](char c) { line[length++] = static_cast<std::byte>(c); });
+                    });
+                consumer_busy.store(false, std::memory_order_release);
+                if (popped)
+                    break;
+            }
+            watchdog::CheckIn(watchdog::Task::kLogDrain);
+            co_await coro::Yield{};
+        }
+        watchdog::CheckIn(watchdog::Task::kLogDrain);
+        // Starts the transfer and continues; the other buffer is free again
+        // as soon as this returns.
+        co_await transport::Log::WriteAsync(pw::span<const std::byte>(line.data(), length));
+        emitted.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+}  // namespace log_control
+
+// ── Handler ───────────────────────────────────────────────────────────────────
+
 // Called by pw_log_tokenized for every log statement.
 //
 // |metadata|  – packed level / line / flags / module token
-//               (decode with pw::log_tokenized::Metadata if needed)
+//               (the level is compared with the log_control threshold)
 // |data|      – binary payload: 4-byte little-endian token followed by
 //               varint-encoded printf arguments
 // |size_bytes| – byte length of |data|
-extern "C" void pw_log_tokenized_HandleLog(uint32_t /*metadata*/,
+extern "C" void pw_log_tokenized_HandleLog(uint32_t metadata,
                                            const uint8_t data[],
                                            size_t size_bytes) {
-    // '$' marks the start of a Pigweed tokenized message.
-    Emit('$');
-
-    // Encode |data| as standard Base64, 3 input bytes → 4 output chars.
-    size_t i = 0;
-    for (; i + 2 < size_bytes; i += 3) {
-        const uint32_t g = (static_cast<uint32_t>(data[i])     << 16) |
-                           (static_cast<uint32_t>(data[i + 1]) <<  8) |
-                            static_cast<uint32_t>(data[i + 2]);
-        EmitBase64(g >> 18);
-        EmitBase64(g >> 12);
-        EmitBase64(g >>  6);
-        EmitBase64(g);
-    }
-
-    // Remaining 1 or 2 bytes, padded with '=' to a 4-char group.
-    if (i < size_bytes) {
-        const uint32_t g = (static_cast<uint32_t>(data[i]) << 16) |
-                           (i + 1 < size_bytes
-                                ? static_cast<uint32_t>(data[i + 1]) << 8
-                                : 0u);
-        EmitBase64(g >> 18);
-        EmitBase64(g >> 12);
-        if (i + 1 < size_bytes) {
-            EmitBase64(g >> 6);
-        } else {
-            Emit('=');
-        }
-        Emit('=');
+    if (pw::log_tokenized::Metadata(metadata).level() <
+        min_level.load(std::memory_order_relaxed)) {
+        filtered.fetch_add(1, std::memory_order_relaxed);
+        return;
     }
-
-    // Newline terminates the message on the wire.
-    Emit('\n');
+    // A full queue counts the message as dropped (log_control::Dropped()).
+    queue.Push(metadata, pw::span<const std::byte>(reinterpret_cast<const std::byte*>(data),
+                                                size_bytes));
 }
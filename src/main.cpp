@@ -9,21 +9,53 @@
  *       --database tokens.csv <build>/stm32f429i_demo
  *   python -m pw_tokenizer.detokenize \
  *       --database tokens.csv serial --device /dev/ttyACM0 --baud 115200
+ *
+ * After boot the application runs as five cooperative modm fibers:
+ *
+ *   sampler ──Channel<SensorReading>──▶ processor ──Channel<batch #>──▶ status LED
+ *      └──────────Channel<ChartEntry>───────┴──▶ display (LCD strip chart)
+ *   UART: drains the log queue, answers RPC requests and feeds the watchdog
+ *
+ * The sampler wakes on an absolute 500 ms schedule and never waits for the
+ * others; long operations (per-reading logging, UART output) yield.  Build
+ * with -DDEMO_SUPERLOOP=ON for the previous sequential loop, which reports
+ * the same jitter statistics for comparison.
  */
 
 #include <modm/board.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <optional>
+
 // ── Pigweed ──────────────────────────────────────────────────────────────────
-// Override the default tokenized log format (■msg♦…■module♦…■file♦…) with a
-// compact "[MODULE] message" string.  Must be defined before pw_log/log.h pulls
-// in pw_log_tokenized/config.h which guards this macro with #ifndef.
-#define PW_LOG_TOKENIZED_FORMAT_STRING(module, message) "[" module "] " message
-#include "pw_log/log.h"
-#include "pw_assert/check.h"
+// Compact "[MODULE] message" format, see log_config.h.
+#include "log_config.h"
 #include "pw_build_info/build_id.h"
 #include "pw_status/status.h"
 #include "pw_span/span.h"
+#include "async_uart.h"
+#include "batch.h"
+#include "capture.h"
+#include "channel.h"
+#include "config.h"
+#include "coro.h"
+#include "cycle_counter.h"
 #include "git_info.h"
+#include "history.h"
+#include "image_check.h"
+#include "internal_flash.h"
+#include "lcd.h"
+#include "log_control.h"
+#include "memory_bench.h"
+#include "memory_region.h"
+#include "rpc_services.h"
+#include "sdram.h"
+#include "stats.h"
+#include "strip_chart.h"
+#include "transport.h"
+#include "watchdog.h"
 
 // ── ETL ───────────────────────────────────────────────────────────────────────
 #include <etl/vector.h>
@@ -42,48 +74,343 @@ using namespace modm::platform;
 // Data types
 // ─────────────────────────────────────────────────────────────────────────────
 
-struct SensorReading {
-    uint32_t timestamp_ms;
-    int16_t  raw_value;
+using batch::SensorReading;
+
+// Capacity of the batch buffers.  The batch size and sample period in use
+// come from the configuration store (config.h); the sampler takes over new
+// values between two batches (ApplyCadence()).
+constexpr size_t kMaxBatchSize = 64;
+static_assert(config::kEntries[config::kBatchSize.id].max == kMaxBatchSize);
+
+std::chrono::milliseconds sample_period{500};
+size_t                    batch_size = 16;
+
+// Deadlines follow the sample period: a reading is due every period; the
+// processor's slowest batch erases a history and a config sector (up to
+// internal_flash::kMaxEraseMs each), during which the UART fiber goes on
+// kicking.  The superloop busy-waits for an erase without kicking, so both
+// its tasks check in around each erase (Run()) and wait for one at most; a
+// longer stall is the IWDG's to catch, and a deadline past its timeout would
+// never fire first.
+#ifdef DEMO_SUPERLOOP
+constexpr uint32_t kLoopSlackMs = internal_flash::kMaxEraseMs + 1000;
+static_assert(kLoopSlackMs < watchdog::kTimeoutMs,
+              "the IWDG would reset the board before the supervisor notices");
+#endif
+
+void WatchTasks() {
+    const auto period_ms = static_cast<uint32_t>(sample_period.count());
+#ifdef DEMO_SUPERLOOP
+    watchdog::Watch(watchdog::Task::kSampler, period_ms + kLoopSlackMs);
+    watchdog::Watch(watchdog::Task::kProcessor, period_ms + kLoopSlackMs);
+#else
+    watchdog::Watch(watchdog::Task::kSampler, period_ms + 1000);
+    watchdog::Watch(watchdog::Task::kProcessor, period_ms + 5000);
+#endif
+}
+
+// Takes over a batch size and sample period changed with Config.Set.  Called
+// by the sampler right after the last reading of a batch, so no reading is
+// lost or split off and every batch has one length and one period.
+void ApplyCadence() {
+    if (batch::TakeCadence(sample_period, batch_size))
+        WatchTasks();
+}
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Sampling – shared by the fiber and the superloop variant
+// ─────────────────────────────────────────────────────────────────────────────
+
+// Takes the next (simulated) reading and measures how far the interval since
+// the previous one deviates from sample_period.  The worst value
+// since boot is published as stats::Gauge::kJitterMaxUs.  While a capture is
+// running (capture.h) every reading is also recorded in SDRAM.  Every
+// batch_size-th reading ends a batch.
+class Sampler {
+public:
+    SensorReading Take() {
+        const auto now = modm::PreciseClock::now();
+        Board::LedGreen::toggle();
+        ++index_;
+
+        uint32_t jitter_us = 0;
+        if (index_ > 1) {
+            const auto interval = std::chrono::duration_cast<std::chrono::microseconds>(now - last_);
+            const auto error    = (interval - sample_period).count();
+            jitter_us = static_cast<uint32_t>(error < 0 ? -error : error);
+        }
+        last_ = now;
+        if (jitter_us > stats::Get(stats::Gauge::kJitterMaxUs))
+            stats::Set(stats::Gauge::kJitterMaxUs, jitter_us);
+        stats::Increment(stats::Counter::kSamples);
+
+        in_batch_ = in_batch_ + 1 < batch_size ? in_batch_ + 1 : 0;
+        const SensorReading reading = {
+            stats::UptimeMs(),
+            static_cast<int16_t>(static_cast<int16_t>(index_ % 100u) - 50),
+            jitter_us,
+            in_batch_ == 0,
+        };
+        capture::Add({reading.timestamp_ms, reading.raw_value,
+                      static_cast<uint16_t>(std::min<uint32_t>(jitter_us, UINT16_MAX))});
+        return reading;
+    }
+
+private:
+    uint32_t                       index_    = 0;
+    size_t                         in_batch_ = 0;
+    modm::PreciseClock::time_point last_{};
+};
+
+Sampler sampler;
+
+// Encoding a log message is the longest step of a batch; let the sampler in
+// after each one.
+void Yield() { modm::this_fiber::yield(); }
+
+// Logs and processes one full batch and keeps its summary in flash.
+history::BatchSummary HandleBatch(pw::span<const SensorReading> batch) {
+    return batch::Handle(batch, Yield);
+}
+
+// Stores configuration changes made over RPC since the last batch.  Not from
+// the UART fiber, which answers the RPC: a sector erase (1–2 s) there would
+// stall the log drainer and starve the watchdog.
+void CommitConfig() {
+    const pw::Status status = config::Commit();
+    if (!status.ok())
+        PW_LOG_WARN("config: not stored (%s), retrying after the next batch", status.str());
+}
+
+// ── LCD strip chart ───────────────────────────────────────────────────────────
+
+// A reading or a batch summary to plot.
+struct ChartEntry {
+    bool    batch;
+    int16_t value;  // reading, or batch mean
+    int16_t min;
+    int16_t max;
 };
 
+ChartEntry ReadingEntry(const SensorReading& r) { return {false, r.raw_value, 0, 0}; }
+
+ChartEntry BatchEntry(const history::BatchSummary& s) {
+    return {true, static_cast<int16_t>(s.mean), static_cast<int16_t>(s.min),
+            static_cast<int16_t>(s.max)};
+}
+
+// Empty without SDRAM for the framebuffer.
+std::optional<strip_chart::StripChart> chart;
+
+// Scrolls the chart by one column (DMA2D, see strip_chart.h) and publishes
+// the time it took as stats::Gauge::kDisplayUs.
+void Plot(const ChartEntry& entry) {
+    if (!chart)
+        return;
+    if (entry.batch)
+        chart->AddBatch(entry.value, entry.min, entry.max);
+    else
+        chart->AddSample(entry.value);
+    stats::Set(stats::Gauge::kDisplayUs, chart->last_update_us());
+}
+
+#ifdef DEMO_SUPERLOOP
+
+// ─────────────────────────────────────────────────────────────────────────────
+// Sequential loop (DEMO_SUPERLOOP): processing, logging and the LED flash all
+// delay the next sample.  Kept to measure what the fibers below buy.
+// ─────────────────────────────────────────────────────────────────────────────
+
+// Waits |duration| while answering RPC requests (rpc_services.h) and running
+// the coroutines, among them the log drainer (log_control.h).
+void ServiceFor(std::chrono::milliseconds duration) {
+    const auto deadline = modm::Clock::now() + duration;
+    while (modm::Clock::now() < deadline) {
+        coro::RunReady();
+        rpc_services::Server().Poll();
+        watchdog::Service();
+    }
+}
+
+// Sampler and processor are one loop here; it checks in for both after each
+// reading and after each step that may erase a sector (WatchTasks()).
+void CheckInLoop() {
+    watchdog::CheckIn(watchdog::Task::kSampler);
+    watchdog::CheckIn(watchdog::Task::kProcessor);
+}
+
+[[noreturn]] void Run() {
+    etl::vector<SensorReading, kMaxBatchSize> readings;
+    while (true) {
+        ServiceFor(sample_period);
+        readings.push_back(sampler.Take());
+        CheckInLoop();
+        Plot(ReadingEntry(readings.back()));
+
+        if (readings.back().batch_end) {
+            Plot(BatchEntry(
+                HandleBatch(pw::span<const SensorReading>(readings.data(), readings.size()))));
+            readings.clear();
+            CheckInLoop();
+
+            // Rote LED kurz an als Verarbeitungs-Bestätigung
+            Board::LedRed::set();
+            ServiceFor(100ms);
+            Board::LedRed::reset();
+            // After a ServiceFor(): a sector erase here and one in HandleBatch()
+            // would otherwise outlast the watchdog together.
+            CommitConfig();
+            CheckInLoop();
+            ApplyCadence();
+        }
+    }
+}
+
+#else
+
 // ─────────────────────────────────────────────────────────────────────────────
-// Processing function – uses pw_status and pw_span
+// Fibers (modm:processing:fiber)
 // ─────────────────────────────────────────────────────────────────────────────
+// Stacks are sized for the deepest call each fiber makes: PW_LOG_* encoding in
+// the processor and the sampler (ApplyCadence()), an RPC reply plus Base64
+// output, or Bench.Run's timing table, in the UART fiber.  The batch buffer
+// is static, not on a stack.
 
-pw::Status ProcessBatch(pw::span<const SensorReading> batch) {
-    if (batch.empty()) {
-        PW_LOG_WARN("ProcessBatch called with an empty span");
-        return pw::Status::InvalidArgument();
+constexpr size_t kFiberCount = 5;
+
+// At least one batch of headroom: the sampler only drops readings
+// (kOverruns) if the processor falls a whole batch behind.
+Channel<SensorReading, kMaxBatchSize> samples;
+Channel<uint32_t, 4>                  batches_done;
+// Best effort: entries are dropped rather than delaying sampler or processor
+// while the display is behind.
+Channel<ChartEntry, kMaxBatchSize>    chart_entries;
+
+modm::Fiber<1024> sampler_fiber([] {
+    auto next = modm::PreciseClock::now();
+    while (true) {
+        next += sample_period;
+        modm::this_fiber::sleep_until(next);
+        const SensorReading reading = sampler.Take();
+        watchdog::CheckIn(watchdog::Task::kSampler);
+        if (!samples.TrySend(reading))
+            stats::Increment(stats::Counter::kOverruns);
+        chart_entries.TrySend(ReadingEntry(reading));
+        if (reading.batch_end)
+            ApplyCadence();
     }
+});
 
-    int32_t sum = 0;
-    for (const SensorReading& r : batch) {
-        sum += r.raw_value;
-        // Fix: %-6lu -> %-6u (uint32_t ist unter Clang/ARM 'unsigned int')
-        PW_LOG_DEBUG("  t=%-6u  raw=%d", (unsigned int)r.timestamp_ms, r.raw_value);
+modm::Fiber<1536> processor_fiber([] {
+    static etl::vector<SensorReading, kMaxBatchSize> readings;
+    while (true) {
+        readings.push_back(samples.Receive());
+        watchdog::CheckIn(watchdog::Task::kProcessor);
+        // The buffer only fills up if the sampler dropped the batch's last
+        // reading as an overrun.
+        if (!readings.back().batch_end && !readings.full())
+            continue;
+        const history::BatchSummary summary =
+            HandleBatch(pw::span<const SensorReading>(readings.data(), readings.size()));
+        readings.clear();
+        batches_done.TrySend(summary.batch);
+        chart_entries.TrySend(BatchEntry(summary));
+        CommitConfig();
     }
+});
 
-    const int32_t mean = sum / static_cast<int32_t>(batch.size());
+// Waits in dma2d::Wait() while the DMA2D scrolls the chart.
+modm::Fiber<512> display_fiber([] {
+    while (true)
+        Plot(chart_entries.Receive());
+});
 
-    // Pigweed kümmert sich um alles: Formatierung, Typ-Sicherheit und Logging.
-    PW_LOG_INFO("batch mean=%d  n=%u", (int)mean, (unsigned int)batch.size());
-    return pw::OkStatus();
+// Rote LED kurz an als Verarbeitungs-Bestätigung
+modm::Fiber<256> led_fiber([] {
+    while (true) {
+        batches_done.Receive();
+        Board::LedRed::set();
+        modm::this_fiber::sleep_for(100ms);
+        Board::LedRed::reset();
+    }
+});
+
+// Coroutine executor (coro.h: the log drainer) and RPC server: the only fiber
+// that writes to the UART, so log lines and HDLC frames never interleave;
+// also feeds the watchdog (watchdog.h) while every task checks in.  Also
+// measures the cost of a context switch: when every other fiber merely checks
+// its wait condition, one yield goes once around all kFiberCount fibers.  The
+// minimum over all round trips is that best case.
+modm::Fiber<2048> uart_fiber([] {
+    uint32_t best = UINT32_MAX;
+    while (true) {
+        coro::RunReady();
+        rpc_services::Server().Poll();
+        watchdog::Service();
+
+        const uint32_t t0 = cycle_counter::Now();
+        modm::this_fiber::yield();
+        const uint32_t round_trip = cycle_counter::Now() - t0;
+        if (round_trip < best) {
+            best = round_trip;
+            stats::Set(stats::Gauge::kSwitchCycles, best / kFiberCount);
+        }
+    }
+});
+
+[[noreturn]] void Run() {
+    modm::fiber::Scheduler::run();
+    // run() only returns once every fiber has finished, and ours never do.
+    std::abort();
 }
 
+#endif  // DEMO_SUPERLOOP
+
 // ─────────────────────────────────────────────────────────────────────────────
 // main
 // ─────────────────────────────────────────────────────────────────────────────
 
+// modm computes the baud rate divider at compile time: one instance per rate
+// config::kBaudRates allows.
+void InitializeUart(uint32_t baud) {
+    using Uart = Board::stlink::Uart;
+    switch (baud) {
+        case 9600:   Uart::initialize<Board::SystemClock, 9600_Bd>();   break;
+        case 19200:  Uart::initialize<Board::SystemClock, 19200_Bd>();  break;
+        case 38400:  Uart::initialize<Board::SystemClock, 38400_Bd>();  break;
+        case 57600:  Uart::initialize<Board::SystemClock, 57600_Bd>();  break;
+        case 230400: Uart::initialize<Board::SystemClock, 230400_Bd>(); break;
+        case 460800: Uart::initialize<Board::SystemClock, 460800_Bd>(); break;
+        default:     Uart::initialize<Board::SystemClock, 115200_Bd>(); break;
+    }
+}
+
 int main() {
     // Initialisiert Clocks (180MHz), FPU und LEDs
     Board::initialize();
 
+    // ── Configuration in internal flash (sectors 18–19) ────────────────────
+    // Loaded first: it holds the baud rate.  Its log messages wait in the
+    // log queue until the UART is up.
+    static internal_flash::InternalFlash config_flash(internal_flash::kConfigSector,
+                                                      internal_flash::kConfigSectors);
+    config::Initialize(config_flash).IgnoreError();  // logs its own errors
+    log_control::SetLevel(config::Get(config::kLogLevel));
+    sample_period = std::chrono::milliseconds(config::Get(config::kSamplePeriodMs));
+    batch_size    = config::Get(config::kBatchSize);
+
     // UART1 Konfiguration (Namespace modm::platform via using oben)
     // Nutze den Alias, den das Discovery-Board Profil bereitstellt:
     // UART-Initialisierung über den Board-spezifischen Pfad
     Board::stlink::Uart::connect<GpioA9::Tx, GpioA10::Rx>();
-    Board::stlink::Uart::initialize<Board::SystemClock, 115200_Bd>();
+    InitializeUart(config::Get(config::kBaudRate));
+
+    // Log output leaves through DMA, driven by the drainer coroutine; until
+    // the scheduler below runs, messages wait in the log queue.
+    async_uart::Initialize();
+    transport::Initialize();
+    coro::Spawn(log_control::Drainer());
+    const watchdog::ResetCause reset = watchdog::Initialize();  // logs it
 
     PW_LOG_INFO("=========================================");
     PW_LOG_INFO(" STM32F429I-DISCO  modm + Pigweed + ETL ");
@@ -116,46 +443,78 @@ int main() {
                 git_info::kBranch);
     PW_LOG_INFO("Built: %s %s", __DATE__, __TIME__);
 
-    // Fix: %lu -> %u für Board-Frequenz
-    PW_LOG_INFO("System clock: %u Hz", (unsigned int)Board::SystemClock::Frequency);
-
-    // ETL static vector: zero heap usage
-    etl::vector<SensorReading, 16> readings;
-    PW_LOG_INFO("ETL reading buffer capacity: %u", (unsigned int)readings.capacity());
-
-    uint32_t tick_ms     = 0;
-    uint32_t batch_count = 0;
-
-    while (true) {
-        // ── Heartbeat ───────────────────────────────────────────────────────
-        Board::LedGreen::toggle();
-        modm::delay(500ms);
-        tick_ms += 500;
-
-        // ── Simulate a sensor reading ────────────────────────────────────────
-        const int16_t value = static_cast<int16_t>((tick_ms / 500u) % 100u) - 50;
+    // ── Whole-image integrity check ─────────────────────────────────────────
+    // tools/patch_image.py stores the CRC of the flash image in .image_check
+    // after linking; the hardware CRC unit recomputes it over the flashed bytes.
+    {
+        const image_check::Result ic = image_check::Verify();
+        if (ic.status.ok()) {
+            PW_LOG_INFO("Image CRC: 0x%08x OK (%u bytes in %u us)",
+                        (unsigned int)ic.actual,
+                        (unsigned int)ic.length,
+                        (unsigned int)ic.duration_us);
+        } else if (ic.status.IsFailedPrecondition()) {
+            PW_LOG_WARN("Image CRC: trailer not patched, check skipped");
+        } else {
+            PW_LOG_ERROR("Image CRC: MISMATCH stored=0x%08x computed=0x%08x (%u bytes in %u us)",
+                         (unsigned int)ic.expected,
+                         (unsigned int)ic.actual,
+                         (unsigned int)ic.length,
+                         (unsigned int)ic.duration_us);
+        }
+    }
 
-        if (!readings.full()) {
-            readings.push_back({tick_ms, value});
+    // ── External SDRAM: LCD framebuffer, capture buffer, memory benchmark ──
+    {
+        const pw::Status status = sdram::Initialize();
+        if (status.ok()) {
+            memory_region::EnableSdram();
+        } else {
+            PW_LOG_ERROR("SDRAM: self-test failed, capture and LCD disabled");
         }
+        memory_bench::Initialize();
+        if (lcd::Initialize().ok()) {
+            chart.emplace(lcd::Framebuffer());
+            chart->Redraw();
+        }
+        if (capture::Initialize().ok())
+            PW_LOG_INFO("SDRAM: %u KB, capture buffer %u samples",
+                        (unsigned int)(memory_region::Capacity(memory_region::Region::kSdram) / 1024),
+                        (unsigned int)capture::capacity());
+    }
 
-        // ── Process a full batch ─────────────────────────────────────────────
-        if (readings.full()) {
-            ++batch_count;
-            // Fix: %lu -> %u für Batch-Counter und Zeit
-            PW_LOG_INFO("--- Batch #%u (t=%u ms) ---", (unsigned int)batch_count, (unsigned int)tick_ms);
+    // ── Batch history in internal flash (sectors 20–23) ────────────────────
+    // Mounting reads only the sector headers and the active sector's record
+    // headers; a blank or foreign region is formatted.
+    static internal_flash::InternalFlash flash(internal_flash::kHistorySector,
+                                               internal_flash::kHistorySectors);
+    history::Initialize(flash).IgnoreError();  // logs its own errors
+    if (reset.watchdog) {
+        history::RecordEvent(history::Event::kWatchdog,
+                             reset.starved ? static_cast<uint32_t>(*reset.starved) + 1 : 0)
+            .IgnoreError();
+    }
 
-            const pw::Status status = ProcessBatch(
-                pw::span<const SensorReading>(readings.data(), readings.size()));
+    // Fix: %lu -> %u für Board-Frequenz
+    PW_LOG_INFO("System clock: %u Hz", (unsigned int)Board::SystemClock::Frequency);
 
-            PW_CHECK_OK(status, "ProcessBatch failed");
+    // ETL static vector: zero heap usage
+    PW_LOG_INFO("ETL reading buffer capacity: %u", (unsigned int)kMaxBatchSize);
+    PW_LOG_INFO("Sampling: %u ms, batches of %u, UART %u Bd",
+                (unsigned int)sample_period.count(), (unsigned int)batch_size,
+                (unsigned int)config::Get(config::kBaudRate));
+#ifdef DEMO_SUPERLOOP
+    PW_LOG_INFO("Scheduling: sequential loop");
+#else
+    PW_LOG_INFO("Scheduling: %u fibers", (unsigned int)kFiberCount);
+#endif
 
-            readings.clear();
+    // ── Watchdog: from here on every task must keep checking in ────────────
+    // The drainer runs on every pass of the UART fiber, which may wait out a
+    // bank 2 erase in History.Read or Log.SetLevel (internal_flash.h).
+    WatchTasks();
+    watchdog::Watch(watchdog::Task::kLogDrain, 1000 + internal_flash::kMaxEraseMs);
+    watchdog::Start();
 
-            // Rote LED kurz an als Verarbeitungs-Bestätigung
-            Board::LedRed::set();
-            modm::delay(100ms);
-            Board::LedRed::reset();
-        }
-    }
+    Run();
 }
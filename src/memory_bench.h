@@ -0,0 +1,50 @@
+// Bandwidth and latency of a memory region, in CPU cycles (cycle_counter.h).
+//
+//   const memory_bench::Result r = memory_bench::Run(buffer);
+//
+// Three passes over |buffer|:
+//
+//   write    sequential 32-bit stores           cycles per KB
+//   read     sequential 32-bit loads            cycles per KB
+//   latency  dependent loads in random order    cycles per load
+//            (a pointer chase over a random cyclic permutation, so neither
+//            the FMC's read FIFO nor SDRAM row hits can hide the access time)
+//
+// The Cortex-M4 has no data cache, so internal SRAM reads at ~1 cycle per
+// word and the SDRAM pays the FMC and CAS latency on every random access.
+// Run it on both regions with Rpc "Memory.Bench" (rpc_services.h) or
+// `python tools/rpc_client.py PORT mem-bench`.  Interrupts stay enabled;
+// take the best of a few runs.  Host builds count nanoseconds instead of
+// cycles.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "memory_region.h"
+#include "pw_span/span.h"
+
+namespace memory_bench {
+
+struct Result {
+    uint32_t write_cycles_per_kb;
+    uint32_t read_cycles_per_kb;
+    uint32_t latency_cycles;
+};
+
+// |buffer| is overwritten; at least 1 KB gives stable numbers.
+Result Run(pw::span<uint32_t> buffer);
+
+// ── Per region ────────────────────────────────────────────────────────────────
+
+inline constexpr size_t kBufferWords = 4096;  // 16 KB
+
+// Reserves kBufferWords in every region that has room.  Call before
+// capture::Initialize() claims the rest of the SDRAM.
+void Initialize();
+
+// Run() on the buffer reserved in |region|; all zeros without one.
+Result Run(memory_region::Region region);
+
+}  // namespace memory_bench
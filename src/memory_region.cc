@@ -0,0 +1,76 @@
+// Region-aware bump allocator – see memory_region.h.
+
+#include "memory_region.h"
+
+#include <array>
+
+#include "sdram.h"
+
+namespace memory_region {
+namespace {
+
+struct Arena {
+    const char* name;
+    uintptr_t   base;
+    size_t      capacity;
+    size_t      used;
+};
+
+constexpr size_t kSramSize = 32 * 1024;
+
+alignas(8) std::array<std::byte, kSramSize> sram;
+
+#ifdef DEMO_HOST_BUILD
+alignas(64) std::array<std::byte, sdram::kSize> sdram_array;
+
+uintptr_t SdramBase() { return reinterpret_cast<uintptr_t>(sdram_array.data()); }
+#else
+uintptr_t SdramBase() { return sdram::kBase; }
+#endif
+
+std::array<Arena, static_cast<size_t>(Region::kCount)> arenas = {{
+    {"sram", reinterpret_cast<uintptr_t>(sram.data()), kSramSize, 0},
+    {"sdram", 0, 0, 0},
+}};
+
+Arena& Get(Region region) { return arenas[static_cast<size_t>(region)]; }
+
+// Offset of the next block with |alignment| in |a|.
+size_t AlignedUsed(const Arena& a, size_t alignment) {
+    const uintptr_t next = (a.base + a.used + alignment - 1) & ~(uintptr_t{alignment} - 1);
+    return static_cast<size_t>(next - a.base);
+}
+
+}  // namespace
+
+void EnableSdram() {
+    Arena& a   = Get(Region::kSdram);
+    a.base     = SdramBase();
+    a.capacity = sdram::kSize;
+    a.used     = 0;
+}
+
+void* AllocateBytes(Region region, size_t size, size_t alignment) {
+    Arena&       a     = Get(region);
+    const size_t start = AlignedUsed(a, alignment);
+    if (start > a.capacity || size > a.capacity - start)
+        return nullptr;
+    a.used = start + size;
+    return reinterpret_cast<void*>(a.base + start);
+}
+
+size_t Available(Region region, size_t alignment) {
+    const Arena& a     = Get(region);
+    const size_t start = AlignedUsed(a, alignment);
+    return start < a.capacity ? a.capacity - start : 0;
+}
+
+size_t Capacity(Region region) { return Get(region).capacity; }
+
+size_t Used(Region region) { return Get(region).used; }
+
+const char* Name(Region region) { return Get(region).name; }
+
+void Reset(Region region) { Get(region).used = 0; }
+
+}  // namespace memory_region
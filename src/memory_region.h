@@ -0,0 +1,69 @@
+// Buffers placed by memory region: fast internal SRAM or the 8 MB external
+// SDRAM (sdram.h).
+//
+//   pw::span<Sample> buf = memory_region::Allocate<Sample>(Region::kSdram, n);
+//   if (buf.empty()) …   // region exhausted (or SDRAM not initialised)
+//
+// Each region is a bump allocator: allocations live until Reset() of that
+// region, which is meant for a single owner of the whole region (e.g. a
+// capture buffer being re-sized).  Memory is handed out uninitialised, so
+// only plain data types are allowed.  Never touches the heap.
+//
+//   Region  Size    Access                        Use for
+//   ------  ------  ----------------------------  --------------------------
+//   kSram   32 KB   0 wait states, CPU and DMA    hot buffers, DMA sources
+//   kSdram  8 MB    FMC at HCLK / 2, slower in    long captures, frame
+//                   bandwidth and much slower in  buffers
+//                   latency (memory_bench.h)
+//
+// Host builds (DEMO_HOST_BUILD) back both regions with static arrays.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "pw_span/span.h"
+
+namespace memory_region {
+
+enum class Region : uint8_t {
+    kSram,
+    kSdram,
+    kCount,
+};
+
+// Call once sdram::Initialize() has succeeded; until then kSdram is empty.
+void EnableSdram();
+
+// |size| bytes aligned to |alignment| (a power of two), or nullptr.
+void* AllocateBytes(Region region, size_t size, size_t alignment);
+
+// Bytes a request with |alignment| could still get.
+size_t Available(Region region, size_t alignment = 1);
+
+size_t      Capacity(Region region);
+size_t      Used(Region region);
+const char* Name(Region region);
+
+// Releases every allocation in |region|.
+void Reset(Region region);
+
+// |count| uninitialised Ts, or an empty span.
+template <typename T>
+pw::span<T> Allocate(Region region, size_t count) {
+    static_assert(std::is_trivially_default_constructible_v<T> &&
+                      std::is_trivially_destructible_v<T>,
+                  "memory regions hold plain data only");
+    void* p = AllocateBytes(region, count * sizeof(T), alignof(T));
+    return p != nullptr ? pw::span<T>(static_cast<T*>(p), count) : pw::span<T>();
+}
+
+// Everything left in |region|, as T.
+template <typename T>
+pw::span<T> AllocateRest(Region region) {
+    return Allocate<T>(region, Available(region, alignof(T)) / sizeof(T));
+}
+
+}  // namespace memory_region
@@ -0,0 +1,148 @@
+// Lock-free multi-producer / single-consumer queue of variable-length records.
+//
+// Producers (any thread, any interrupt priority) reserve space by advancing
+// the head with one compare-and-swap, copy their record in, then publish it by
+// setting the commit bit of its header.  The single consumer pops records in
+// reservation order; it stops at the first record that is reserved but not yet
+// committed, so a producer interrupted half-way never lets a later record
+// overtake it and the consumer never sees a partial record.
+//
+// Layout: a power-of-two ring of 32-bit words.  Every record starts on a word
+// boundary with
+//
+//   header (u32)   bit 31 commit, bit 30 padding, bits 15..0 payload length
+//   tag    (u32)   caller-defined (the log handler stores the log metadata)
+//   payload …      padded to the next word
+//
+// Records never wrap: if one does not fit before the end of the ring, the
+// reservation also covers the rest of the ring, which is published as a
+// padding record and skipped by the consumer.  The consumer zeroes everything
+// it has consumed before releasing it, so a freshly reserved header always
+// reads as "not committed" until its producer sets the bit.
+//
+// Push() fails (and counts a drop) instead of waiting when the ring is full, so
+// it is safe in interrupt handlers; on Cortex-M the CAS compiles to LDREX/STREX
+// and retries only if an interrupt pushed in between.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_span/span.h"
+
+template <size_t kCapacityBytes>
+class MpscRecordQueue {
+    static_assert(kCapacityBytes >= 64 && (kCapacityBytes & (kCapacityBytes - 1)) == 0,
+                  "capacity must be a power of two of at least 64 bytes");
+
+public:
+    static constexpr size_t kRecordHeaderSize = 8;  // header + tag
+    // Larger records could never be stored once the ring is fragmented.
+    static constexpr size_t kMaxPayloadSize = kCapacityBytes / 4 - kRecordHeaderSize;
+
+    constexpr MpscRecordQueue() = default;
+
+    MpscRecordQueue(const MpscRecordQueue&)            = delete;
+    MpscRecordQueue& operator=(const MpscRecordQueue&) = delete;
+
+    // Copies one record in.  Returns false, and counts a drop, if the ring is
+    // full or |payload| is longer than kMaxPayloadSize.
+    bool Push(uint32_t tag, pw::span<const std::byte> payload) {
+        if (payload.size() > kMaxPayloadSize) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        const uint32_t size = Align(kRecordHeaderSize + payload.size());
+
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        uint32_t pad;
+        do {
+            const uint32_t to_end = kCapacityBytes - (head & kMask);
+            pad = to_end < size ? to_end : 0;
+            if (head + pad + size - tail_.load(std::memory_order_acquire) > kCapacityBytes) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        } while (!head_.compare_exchange_weak(head, head + pad + size,
+                                              std::memory_order_relaxed,
+                                              std::memory_order_relaxed));
+
+        if (pad != 0)
+            Header(head).store(kCommitBit | kPaddingBit | pad, std::memory_order_release);
+
+        const uint32_t at = (head + pad) & kMask;
+        std::memcpy(&Bytes()[at + 4], &tag, sizeof(tag));
+        std::memcpy(&Bytes()[at + kRecordHeaderSize], payload.data(), payload.size());
+        Header(at).store(kCommitBit | static_cast<uint32_t>(payload.size()),
+                         std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: calls fn(tag, payload) for the oldest committed record and
+    // frees it.  Returns false if there is none (empty, or the oldest record is
+    // still being written).  |payload| is only valid during the call.
+    template <typename Fn>
+    bool Pop(Fn&& fn) {
+        for (;;) {
+            const uint32_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail == head_.load(std::memory_order_acquire))
+                return false;
+
+            const uint32_t header = Header(tail).load(std::memory_order_acquire);
+            if ((header & kCommitBit) == 0)
+                return false;
+
+            const uint32_t at = tail & kMask;
+            uint32_t size = header & kLengthMask;
+            const bool padding = (header & kPaddingBit) != 0;
+            if (!padding) {
+                uint32_t tag;
+                std::memcpy(&tag, &Bytes()[at + 4], sizeof(tag));
+                fn(tag, pw::span<const std::byte>(&Bytes()[at + kRecordHeaderSize], size));
+                size = Align(kRecordHeaderSize + size);
+            }
+
+            std::memset(&Bytes()[at], 0, size);
+            tail_.store(tail + size, std::memory_order_release);
+            if (!padding)
+                return true;
+        }
+    }
+
+    // Pops everything committed so far; returns the number of records.
+    template <typename Fn>
+    size_t Drain(Fn&& fn) {
+        size_t n = 0;
+        while (Pop(fn))
+            ++n;
+        return n;
+    }
+
+    uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint32_t kMask       = kCapacityBytes - 1;
+    static constexpr uint32_t kCommitBit  = 1u << 31;
+    static constexpr uint32_t kPaddingBit = 1u << 30;
+    static constexpr uint32_t kLengthMask = 0xFFFF;
+
+    static_assert(kCapacityBytes <= kLengthMask + 1, "padding length must fit the header");
+
+    static constexpr uint32_t Align(size_t n) { return static_cast<uint32_t>((n + 3) & ~size_t{3}); }
+
+    std::byte* Bytes() { return reinterpret_cast<std::byte*>(words_.data()); }
+
+    std::atomic_ref<uint32_t> Header(uint32_t position) {
+        return std::atomic_ref<uint32_t>(words_[(position & kMask) / 4]);
+    }
+
+    alignas(std::atomic_ref<uint32_t>::required_alignment)
+    std::array<uint32_t, kCapacityBytes / 4> words_{};
+    std::atomic<uint32_t> head_{0};     // next byte to reserve (free-running)
+    std::atomic<uint32_t> tail_{0};     // next byte to consume (free-running)
+    std::atomic<uint32_t> dropped_{0};
+};
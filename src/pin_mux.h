@@ -0,0 +1,27 @@
+// Alternate-function setup for whole groups of pins, for peripherals whose
+// signals modm has no connect<>() for (FMC SDRAM, LTDC).  Target only.
+
+#pragma once
+
+#include <cstdint>
+
+#include <modm/board.hpp>
+
+namespace pin_mux {
+
+// Puts every pin set in |pins| of |port| into alternate function |af|:
+// push-pull, very high speed, no pull resistor.  The port clock must be on.
+inline void SetAlternate(GPIO_TypeDef* port, uint16_t pins, uint32_t af) {
+    for (uint32_t pin = 0; pin < 16; ++pin) {
+        if (!(pins & (1u << pin)))
+            continue;
+        port->MODER    = (port->MODER & ~(3u << 2 * pin)) | (2u << 2 * pin);
+        port->OSPEEDR |= 3u << 2 * pin;
+        port->OTYPER  &= ~(1u << pin);
+        port->PUPDR   &= ~(3u << 2 * pin);
+        volatile uint32_t& afr = port->AFR[pin / 8];
+        afr = (afr & ~(0xFu << 4 * (pin % 8))) | (af << 4 * (pin % 8));
+    }
+}
+
+}  // namespace pin_mux
@@ -10,52 +10,62 @@
  *                                      ...);
  *
  * On assertion failure this implementation:
- *   1. Emits the failure details over UART1.
- *   2. Turns both LEDs on as a visual indicator.
- *   3. Disables interrupts and spins forever (safe-halt).
+ *   1. Disables interrupts and stops DMA output (transport::EnterCrashMode()):
+ *      the UART transfer in flight finishes, then every write is polled and
+ *      never yields, so no other fiber or handler runs from here on.
+ *   2. Sends the log messages still queued (log_control::Drain()), so the
+ *      lead-up to the failure is not lost.
+ *   3. Emits the failure details to the Text transport (UART1 by default)
+ *      and waits until they have left.
+ *   4. Turns both LEDs on as a visual indicator.
+ *   5. Spins (safe-halt) until the watchdog (watchdog.h), no longer fed,
+ *      resets the board.
  */
 
 #include "pw_assert_basic/assert_basic.h"
 
 #include <cstdarg>
+#include <cstring>
 
 #include <modm/board.hpp>
 
+#include "log_control.h"
+#include "transport.h"
+
 // ─────────────────────────────────────────────────────────────────────────────
-// Helpers (duplicated from log_backend.cc to keep each file self-contained)
+// Helpers – output goes to the Text transport (transport.h), after the
+// messages drained before it
 // ─────────────────────────────────────────────────────────────────────────────
 
 namespace {
 
-inline void UartWrite(const char* str) {
-    while (str && *str) {
-        Board::stlink::Uart::write(static_cast<uint8_t>(*str++));
-    }
+inline void WriteN(const char* buf, size_t len) {
+    transport::Text::Write(
+        pw::span<const std::byte>(reinterpret_cast<const std::byte*>(buf), len));
 }
 
-inline void UartWriteN(const char* buf, size_t len) {
-    for (size_t i = 0; i < len; ++i) {
-        Board::stlink::Uart::write(static_cast<uint8_t>(buf[i]));
-    }
+inline void Write(const char* str) {
+    if (str)
+        WriteN(str, std::strlen(str));
 }
 
-inline void UartWriteInt(int value) {
+inline void WriteInt(int value) {
     if (value < 0) {
-        Board::stlink::Uart::write('-');
+        WriteN("-", 1);
         value = -value;
     }
     char buf[12];
     int  pos = 11;
     buf[pos] = '\0';
     if (value == 0) {
-        Board::stlink::Uart::write('0');
+        WriteN("0", 1);
         return;
     }
     while (value > 0) {
         buf[--pos] = static_cast<char>('0' + value % 10);
         value /= 10;
     }
-    UartWrite(buf + pos);
+    Write(buf + pos);
 }
 
 }  // namespace
@@ -70,39 +80,44 @@ void pw_assert_basic_HandleFailure(const char* file_name,
                                    const char* function_name,
                                    const char* message,
                                    ...) {
-    UartWriteN("\r\n", 2);
-    UartWrite("!!! ASSERTION FAILED !!!\r\n");
+    transport::EnterCrashMode();
+    log_control::Drain();
+
+    WriteN("\r\n", 2);
+    Write("!!! ASSERTION FAILED !!!\r\n");
 
     if (file_name) {
-        UartWrite("  file:     ");
-        UartWrite(file_name);
-        UartWrite(":");
-        UartWriteInt(line_number);
-        UartWriteN("\r\n", 2);
+        Write("  file:     ");
+        Write(file_name);
+        Write(":");
+        WriteInt(line_number);
+        WriteN("\r\n", 2);
     }
 
     if (function_name) {
-        UartWrite("  function: ");
-        UartWrite(function_name);
-        UartWriteN("\r\n", 2);
+        Write("  function: ");
+        Write(function_name);
+        WriteN("\r\n", 2);
     }
 
     if (message && *message) {
-        UartWrite("  message:  ");
+        Write("  message:  ");
         // Simple varargs formatting: just print the format string as-is for
         // the demo.  A production project would use pw_string::Format here.
-        UartWrite(message);
-        UartWriteN("\r\n", 2);
+        Write(message);
+        WriteN("\r\n", 2);
     }
 
-    UartWrite("  Halting MCU.\r\n");
+    Write("  Halting MCU.\r\n");
+    transport::Log::Flush();
+    transport::Text::Flush();
 
     // Turn both LEDs on as a visual indicator of the fault
     Board::LedGreen::set();
     Board::LedRed::set();
 
-    // Disable all interrupts and spin – safe halt for bare metal
-    __disable_irq();
+    // Interrupts are already off: spin – safe halt for bare metal, ended by
+    // the IWDG reset if the watchdog has been started
     while (true) {
         __NOP();
     }
@@ -0,0 +1,64 @@
+// RPC server – see rpc.h for the frame layout.
+
+#include "rpc.h"
+
+#include <bit>
+
+#include "pw_sys_io/sys_io.h"
+
+namespace rpc {
+
+pw::Status Writer::Write(pw::span<const std::byte> data) {
+    if (buffer_.size() - size_ < data.size())
+        return pw::Status::ResourceExhausted();
+    std::memcpy(buffer_.data() + size_, data.data(), data.size());
+    size_ += data.size();
+    return pw::OkStatus();
+}
+
+void Server::Poll() {
+    std::byte b;
+    while (pw::sys_io::TryReadByte(&b).ok()) {
+        const std::optional<hdlc::Frame> frame = decoder_.Process(b);
+        if (frame && frame->address == kAddress)
+            Handle(frame->payload);
+    }
+}
+
+const Method* Server::Find(uint32_t id) const {
+    for (const Method& m : methods_)
+        if (m.id == id)
+            return &m;
+    return nullptr;
+}
+
+void Server::Handle(pw::span<const std::byte> payload) {
+    Reader   header(payload);
+    uint32_t method_id;
+    uint8_t  call_id;
+    if (!header.Read(method_id).ok() || !header.Read(call_id).ok())
+        return;  // too short to be answered
+
+    ++calls_;
+    response_.clear();
+
+    pw::Status status = pw::Status::NotFound();
+    if (const Method* method = Find(method_id)) {
+        Reader request(header.remaining());
+        status = method->handler(request, response_);
+    }
+    if (!status.ok()) {
+        ++errors_;
+        response_.clear();
+    }
+
+    const auto id_bytes = std::bit_cast<std::array<std::byte, 4>>(method_id);
+    hdlc::FrameWriter w(kAddress);
+    w.Write(id_bytes);
+    w.Write(std::byte{call_id});
+    w.Write(std::byte(static_cast<uint8_t>(status.code())));
+    w.Write(response_.data());
+    w.Finish().IgnoreError();  // nobody to report a UART error to
+}
+
+}  // namespace rpc
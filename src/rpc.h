@@ -0,0 +1,139 @@
+// Compact request/response RPC over HDLC frames (hdlc.h) on the log UART.
+//
+// Frame payloads (fixed layout, little-endian like both ends of the link):
+//
+//   Request:   method id (u32) | call id (u8) | request …
+//   Response:  method id (u32) | call id (u8) | status (u8) | response …
+//
+// Method IDs are pw_tokenizer tokens of "Service.Method" strings
+// (PW_TOKENIZE_STRING), so they cost 4 bytes on the wire, need no string
+// table in flash and show up in the build's token database.  The call id is
+// chosen by the client and echoed back to pair responses with requests.
+// Status is a pw::Status code; a failed call carries no response data, and an
+// unknown method id is answered with NOT_FOUND.
+//
+// Methods live in a constant table handed to the Server; requests and
+// responses use fixed buffers inside the Server, so nothing is allocated at
+// runtime.  rpc_services.h has the table of this firmware; tools/rpc_client.py
+// is the host side.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "hdlc.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+
+namespace rpc {
+
+// pw_rpc's default HDLC address, so Pigweed's console tools find the frames.
+inline constexpr uint8_t kAddress = 'R';
+
+inline constexpr size_t kRequestHeaderSize  = 4 + 1;      // method id, call id
+inline constexpr size_t kResponseHeaderSize = 4 + 1 + 1;  // … plus status
+inline constexpr size_t kMaxRequestSize     = 32;         // request body bytes
+inline constexpr size_t kMaxResponseSize    = 160;        // response body bytes
+
+// ── Request / response bodies ─────────────────────────────────────────────────
+
+class Reader {
+public:
+    explicit Reader(pw::span<const std::byte> data) : data_(data) {}
+
+    template <typename T>
+    pw::Status Read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (remaining().size() < sizeof(T))
+            return pw::Status::OutOfRange();
+        std::memcpy(&value, data_.data() + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return pw::OkStatus();
+    }
+
+    pw::span<const std::byte> remaining() const { return data_.subspan(pos_); }
+
+private:
+    pw::span<const std::byte> data_;
+    size_t                    pos_ = 0;
+};
+
+class Writer {
+public:
+    // RESOURCE_EXHAUSTED (and nothing written) if |data| does not fit.
+    pw::Status Write(pw::span<const std::byte> data);
+
+    template <typename T>
+    pw::Status Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        return Write(pw::span<const std::byte>(reinterpret_cast<const std::byte*>(&value),
+                                               sizeof(T)));
+    }
+
+    pw::span<const std::byte> data() const { return {buffer_.data(), size_}; }
+    void clear() { size_ = 0; }
+
+private:
+    std::array<std::byte, kMaxResponseSize> buffer_{};
+    size_t                                  size_ = 0;
+};
+
+// ── Service table ─────────────────────────────────────────────────────────────
+
+using Handler = pw::Status (*)(Reader& request, Writer& response);
+
+struct Method {
+    uint32_t id;       // PW_TOKENIZE_STRING("Service.Method")
+    Handler  handler;
+};
+
+// For static_asserts on method tables: two names hashing to the same token
+// would make one of the methods unreachable.
+constexpr bool HasUniqueIds(pw::span<const Method> methods) {
+    for (size_t i = 0; i < methods.size(); ++i)
+        for (size_t j = i + 1; j < methods.size(); ++j)
+            if (methods[i].id == methods[j].id)
+                return false;
+    return true;
+}
+
+// ── Server ────────────────────────────────────────────────────────────────────
+
+class Server {
+public:
+    // constexpr so that a global Server is constant-initialised (no static
+    // constructor, no guard variable).
+    explicit constexpr Server(pw::span<const Method> methods)
+        : methods_(methods), decoder_(rx_buffer_) {}
+
+    Server(const Server&)            = delete;
+    Server& operator=(const Server&) = delete;
+
+    // Reads everything pw::sys_io has received so far and answers complete
+    // requests.  Call regularly from one fiber; never blocks on input.
+    void Poll();
+
+    pw::span<const Method> methods() const { return methods_; }
+
+    uint32_t calls()          const { return calls_; }
+    uint32_t errors()         const { return errors_; }   // non-OK responses
+    uint32_t dropped_frames() const { return decoder_.dropped(); }
+
+private:
+    void Handle(pw::span<const std::byte> payload);
+    const Method* Find(uint32_t id) const;
+
+    pw::span<const Method> methods_;
+    std::array<std::byte, hdlc::kFrameOverhead + kRequestHeaderSize + kMaxRequestSize>
+                           rx_buffer_{};
+    hdlc::Decoder          decoder_;
+    Writer                 response_;
+    uint32_t               calls_  = 0;
+    uint32_t               errors_ = 0;
+};
+
+}  // namespace rpc
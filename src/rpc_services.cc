@@ -0,0 +1,288 @@
+// RPC methods of this firmware – see rpc_services.h for the message layouts.
+
+#include "log_config.h"
+
+#include "rpc_services.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "bench.h"
+#include "build_metadata.h"
+#include "capture.h"
+#include "config.h"
+#include "cycle_counter.h"
+#include "history.h"
+#include "log_control.h"
+#include "memory_bench.h"
+#include "pw_build_info/build_id.h"
+#include "pw_log/levels.h"
+#include "pw_status/try.h"
+#include "pw_tokenizer/tokenize.h"
+#include "stats.h"
+
+#undef PW_LOG_MODULE_NAME
+#define PW_LOG_MODULE_NAME "RPC"
+
+namespace rpc_services {
+namespace {
+
+// ── Device ────────────────────────────────────────────────────────────────────
+
+pw::Status GetBuildInfo(rpc::Reader&, rpc::Writer& response) {
+    const pw::span<const std::byte> build_id = pw::build_info::BuildId();
+    PW_TRY(response.Write(BuildMetadataBytes()));
+    PW_TRY(response.Write(static_cast<uint8_t>(build_id.size())));
+    return response.Write(build_id);
+}
+
+// ── Log ───────────────────────────────────────────────────────────────────────
+
+pw::Status SetLogLevel(rpc::Reader& request, rpc::Writer& response) {
+    uint8_t level;
+    PW_TRY(request.Read(level));
+    if (level != 0 && (level < PW_LOG_LEVEL_DEBUG || level > PW_LOG_LEVEL_FATAL))
+        return pw::Status::InvalidArgument();
+
+    PW_TRY(response.Write(log_control::Level()));
+    if (level != 0 && level != log_control::Level()) {
+        // As Config.Set: stored with the next batch, so it survives a reset.
+        PW_TRY(config::Set(config::kLogLevel, level));
+        log_control::SetLevel(config::Get(config::kLogLevel));
+        // Best effort: fails while the processor is erasing a flash sector.
+        history::RecordEvent(history::Event::kLogLevel, level).IgnoreError();
+    }
+    return pw::OkStatus();
+}
+
+// ── Config ────────────────────────────────────────────────────────────────────
+
+pw::Status GetConfig(rpc::Reader& request, rpc::Writer& response) {
+    uint8_t id;
+    PW_TRY(request.Read(id));
+    if (id >= config::kKeyCount)
+        return pw::Status::NotFound();
+    const config::Entry& e = config::kEntries[id];
+    PW_TRY(response.Write(config::Get(id)));
+    PW_TRY(response.Write(e.default_value));
+    PW_TRY(response.Write(e.min));
+    PW_TRY(response.Write(e.max));
+    return response.Write(static_cast<uint8_t>(e.apply));
+}
+
+pw::Status SetConfig(rpc::Reader& request, rpc::Writer& response) {
+    uint8_t  id;
+    uint32_t value;
+    PW_TRY(request.Read(id));
+    PW_TRY(request.Read(value));
+    const uint32_t previous = config::Get(id);
+    PW_TRY(config::Set(id, value));
+    if (id == config::kLogLevel.id)
+        log_control::SetLevel(config::Get(config::kLogLevel));
+    PW_TRY(response.Write(previous));
+    return response.Write(static_cast<uint8_t>(config::kEntries[id].apply));
+}
+
+// ── History ───────────────────────────────────────────────────────────────────
+
+// Walks the log from its oldest record on every call; fine for reading it
+// out once, too slow for polling.
+pw::Status ReadHistory(rpc::Reader& request, rpc::Writer& response) {
+    uint32_t first;
+    PW_TRY(request.Read(first));
+    const flash_log::FlashLog* log = history::Log();
+    if (log == nullptr)
+        return pw::Status::FailedPrecondition();
+    // The processor is dropping the oldest sector; a walk now could yield
+    // in the middle of it (internal_flash.h) and read a half-erased log.
+    if (log->busy())
+        return pw::Status::Unavailable();
+
+    uint32_t   index  = 0;
+    pw::Status status = pw::OkStatus();
+    log->ForEach([&](uint8_t type, pw::span<const std::byte> payload) {
+        if (index++ < first)
+            return true;
+        if (response.data().size() + 2 + payload.size() > rpc::kMaxResponseSize)
+            return false;
+        status.Update(response.Write(type));
+        status.Update(response.Write(static_cast<uint8_t>(payload.size())));
+        status.Update(response.Write(payload));
+        return status.ok();
+    });
+    return status;
+}
+
+// ── Stats ─────────────────────────────────────────────────────────────────────
+
+struct Snapshot {
+    uint32_t uptime_ms;
+    uint32_t samples;
+    uint32_t batches;
+    uint32_t log_emitted;
+    uint32_t log_filtered;
+    uint32_t rpc_calls;
+    uint32_t rpc_errors;
+    uint32_t rpc_dropped_frames;
+    uint32_t log_dropped;
+    uint32_t overruns;
+    uint32_t jitter_max_us;
+    uint32_t switch_cycles;
+    uint32_t display_us;
+};
+
+Snapshot TakeSnapshot() {
+    const rpc::Server& server = Server();
+    return {
+        stats::UptimeMs(),
+        stats::Get(stats::Counter::kSamples),
+        stats::Get(stats::Counter::kBatches),
+        log_control::Emitted(),
+        log_control::Filtered(),
+        server.calls(),
+        server.errors(),
+        server.dropped_frames(),
+        log_control::Dropped(),
+        stats::Get(stats::Counter::kOverruns),
+        stats::Get(stats::Gauge::kJitterMaxUs),
+        stats::Get(stats::Gauge::kSwitchCycles),
+        stats::Get(stats::Gauge::kDisplayUs),
+    };
+}
+
+pw::Status GetStats(rpc::Reader&, rpc::Writer& response) {
+    return response.Write(TakeSnapshot());
+}
+
+pw::Status DumpStats(rpc::Reader&, rpc::Writer&) {
+    const Snapshot s = TakeSnapshot();
+    PW_LOG_INFO("uptime %u ms, %u samples, %u batches",
+                (unsigned int)s.uptime_ms, (unsigned int)s.samples, (unsigned int)s.batches);
+    PW_LOG_INFO("log: %u emitted, %u filtered (level %u), %u dropped",
+                (unsigned int)s.log_emitted, (unsigned int)s.log_filtered,
+                (unsigned int)log_control::Level(), (unsigned int)s.log_dropped);
+    PW_LOG_INFO("rpc: %u calls, %u errors, %u dropped frames",
+                (unsigned int)s.rpc_calls, (unsigned int)s.rpc_errors,
+                (unsigned int)s.rpc_dropped_frames);
+    PW_LOG_INFO("timing: jitter max %u us, fiber switch %u cycles, %u overruns",
+                (unsigned int)s.jitter_max_us, (unsigned int)s.switch_cycles,
+                (unsigned int)s.overruns);
+    PW_LOG_INFO("display: last update %u us", (unsigned int)s.display_us);
+    return pw::OkStatus();
+}
+
+// ── Capture ───────────────────────────────────────────────────────────────────
+
+pw::Status StartCapture(rpc::Reader& request, rpc::Writer& response) {
+    uint32_t max_samples;
+    PW_TRY(request.Read(max_samples));
+    PW_TRY(capture::Start(max_samples));
+    return response.Write(max_samples == 0 ? capture::capacity()
+                                           : std::min(max_samples, capture::capacity()));
+}
+
+pw::Status StopCapture(rpc::Reader&, rpc::Writer& response) {
+    capture::Stop();
+    return response.Write(static_cast<uint32_t>(capture::Samples().size()));
+}
+
+pw::Status ReadCapture(rpc::Reader& request, rpc::Writer& response) {
+    uint32_t first;
+    PW_TRY(request.Read(first));
+    const pw::span<const capture::Sample> samples = capture::Samples();
+    PW_TRY(response.Write(static_cast<uint32_t>(samples.size())));
+    PW_TRY(response.Write(static_cast<uint8_t>(capture::running())));
+    for (size_t i = first; i < samples.size(); ++i) {
+        if (response.data().size() + sizeof(capture::Sample) > rpc::kMaxResponseSize)
+            break;
+        PW_TRY(response.Write(samples[i]));
+    }
+    return pw::OkStatus();
+}
+
+// ── Memory ────────────────────────────────────────────────────────────────────
+
+pw::Status BenchMemory(rpc::Reader&, rpc::Writer& response) {
+    PW_TRY(response.Write(memory_bench::Run(memory_region::Region::kSram)));
+    return response.Write(memory_bench::Run(memory_region::Region::kSdram));
+}
+
+// ── Bench ─────────────────────────────────────────────────────────────────────
+
+// Blocks the UART fiber for a few milliseconds; interrupts are masked for
+// one run at a time only (tens of microseconds, less than a UART byte).
+pw::Status RunBench(rpc::Reader& request, rpc::Writer& response) {
+    uint8_t runs;
+    PW_TRY(request.Read(runs));
+    if (runs > bench::kMaxRuns)
+        return pw::Status::OutOfRange();
+    if (runs == 0)
+        runs = bench::kDefaultRuns;
+
+    PW_TRY(response.Write(cycle_counter::kPerUs));
+    PW_LOG_INFO("bench: %u runs, %u ticks per us", (unsigned int)runs,
+                (unsigned int)cycle_counter::kPerUs);
+    PW_LOG_INFO("  %-13s %8s %8s %8s %8s", "kernel", "cold", "min", "median", "max");
+    for (const bench::Kernel& kernel : bench::Kernels()) {
+        const bench::Result r    = bench::Measure(kernel, runs);
+        const size_t        size = std::strlen(kernel.name);
+        PW_LOG_INFO("  %-13s %8u %8u %8u %8u", kernel.name, (unsigned int)r.cold,
+                    (unsigned int)r.min, (unsigned int)r.median, (unsigned int)r.max);
+        PW_TRY(response.Write(static_cast<uint8_t>(size)));
+        PW_TRY(response.Write(pw::as_bytes(pw::span(kernel.name, size))));
+        PW_TRY(response.Write(r));
+    }
+    return pw::OkStatus();
+}
+
+// ── Rpc ───────────────────────────────────────────────────────────────────────
+
+pw::Status ListMethods(rpc::Reader&, rpc::Writer& response);
+
+// ── Service table ─────────────────────────────────────────────────────────────
+
+constexpr rpc::Method kMethods[] = {
+    {PW_TOKENIZE_STRING("Device.GetBuildInfo"), GetBuildInfo},
+    {PW_TOKENIZE_STRING("Log.SetLevel"),        SetLogLevel},
+    {PW_TOKENIZE_STRING("Stats.Get"),           GetStats},
+    {PW_TOKENIZE_STRING("Stats.Dump"),          DumpStats},
+    {PW_TOKENIZE_STRING("Rpc.ListMethods"),     ListMethods},
+    {PW_TOKENIZE_STRING("History.Read"),        ReadHistory},
+    {PW_TOKENIZE_STRING("Capture.Start"),       StartCapture},
+    {PW_TOKENIZE_STRING("Capture.Stop"),        StopCapture},
+    {PW_TOKENIZE_STRING("Capture.Read"),        ReadCapture},
+    {PW_TOKENIZE_STRING("Memory.Bench"),        BenchMemory},
+    {PW_TOKENIZE_STRING("Config.Get"),          GetConfig},
+    {PW_TOKENIZE_STRING("Config.Set"),          SetConfig},
+    {PW_TOKENIZE_STRING("Bench.Run"),           RunBench},
+};
+
+static_assert(rpc::HasUniqueIds(kMethods), "RPC method names hash to the same token");
+static_assert(sizeof(kMethods) / sizeof(kMethods[0]) * 4 <= rpc::kMaxResponseSize,
+              "Rpc.ListMethods response does not fit");
+static_assert(sizeof(Snapshot) <= rpc::kMaxResponseSize);
+static_assert(2 + flash_log::FlashLog::kMaxPayloadSize <= rpc::kMaxResponseSize,
+              "History.Read cannot return the largest record");
+static_assert(2 * sizeof(memory_bench::Result) <= rpc::kMaxResponseSize);
+static_assert(sizeof(cycle_counter::kPerUs) +
+                      bench::kKernelCount *
+                          (1 + bench::kMaxNameLength + sizeof(bench::Result)) <=
+                  rpc::kMaxResponseSize,
+              "Bench.Run response does not fit");
+
+pw::Status ListMethods(rpc::Reader&, rpc::Writer& response) {
+    for (const rpc::Method& m : kMethods)
+        PW_TRY(response.Write(m.id));
+    return pw::OkStatus();
+}
+
+constinit rpc::Server server(kMethods);
+
+}  // namespace
+
+rpc::Server& Server() {
+    return server;
+}
+
+}  // namespace rpc_services
@@ -0,0 +1,68 @@
+// RPC methods of this firmware (frame layout in rpc.h, host side in
+// tools/rpc_client.py).  All values are little-endian.
+//
+//   Method               Request                 Response
+//   -------------------  ----------------------  -------------------------------
+//   Device.GetBuildInfo  –                       BuildMetadata as flashed (104 B,
+//                                                build_metadata.h) | build ID
+//                                                length (u8) | GNU build ID
+//   Log.SetLevel         level (u8), 0 = query   previous level (u8)
+//   Stats.Get            –                       uptime_ms, samples, batches,
+//                                                log_emitted, log_filtered,
+//                                                rpc_calls, rpc_errors,
+//                                                rpc_dropped_frames,
+//                                                log_dropped, overruns,
+//                                                jitter_max_us, switch_cycles,
+//                                                display_us (u32 each)
+//   Stats.Dump           –                       – (the counters are logged)
+//   Rpc.ListMethods      –                       method ids (u32 each)
+//   History.Read         first record (u32),     records from |first| on, as
+//                        0 = oldest              many as fit: type (u8) |
+//                                                length (u8) | payload
+//                                                (history.h); empty past the end
+//   Capture.Start        max samples (u32),      samples it will record (u32)
+//                        0 = buffer capacity
+//   Capture.Stop         –                       samples recorded (u32)
+//   Capture.Read         first sample (u32)      samples recorded (u32) |
+//                                                recording (u8) | samples from
+//                                                |first| on, as many as fit:
+//                                                t_ms (u32), raw_value (s16),
+//                                                jitter_us (u16) (capture.h)
+//   Memory.Bench         –                       SRAM, then SDRAM: write and
+//                                                read cycles per KB, cycles
+//                                                per random load (u32 each,
+//                                                memory_bench.h)
+//   Config.Get           key id (u8)             value, default, min, max (u32
+//                                                each) | apply (u8: 0 now,
+//                                                1 at the next boot, 2 after
+//                                                the current batch) (config.h)
+//   Config.Set           key id (u8), value      previous value (u32) | apply
+//                        (u32)                   (u8)
+//   Bench.Run            runs (u8), 0 = 32       ticks per us (u32) | per
+//                                                kernel: name length (u8) |
+//                                                name | cold, min, median,
+//                                                max ticks (u32 each)
+//                                                (bench.h); also logged
+//
+// Log.SetLevel rejects levels outside PW_LOG_LEVEL_DEBUG..PW_LOG_LEVEL_FATAL
+// with INVALID_ARGUMENT; a change is recorded in the history.  History.Read
+// returns FAILED_PRECONDITION if the flash log could not be mounted,
+// UNAVAILABLE while the history erases a sector (up to 2 s; retry), and
+// Capture.Start if the SDRAM could not be initialised.  Config.Get and
+// Config.Set return NOT_FOUND for an unknown key; Config.Set returns
+// OUT_OF_RANGE or INVALID_ARGUMENT for a value the key does not allow, and
+// stores a new value in flash at the next batch boundary.  Log.SetLevel
+// sets the log level key the same way, so both apply at once and after
+// every boot.  Bench.Run returns OUT_OF_RANGE for more than 64 runs.  New
+// fields are only ever appended to a response.
+
+#pragma once
+
+#include "rpc.h"
+
+namespace rpc_services {
+
+// The server answering on the ST-Link UART; poll it from the UART fiber.
+rpc::Server& Server();
+
+}  // namespace rpc_services
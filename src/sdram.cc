@@ -0,0 +1,127 @@
+// FMC / SDRAM bring-up – see sdram.h.
+//
+// Register sequence: RM0090 section 37.7.3 (SDRAM initialization).
+
+#include "sdram.h"
+
+#ifndef DEMO_HOST_BUILD
+#include <modm/board.hpp>
+
+#include "pin_mux.h"
+#endif
+
+namespace sdram {
+
+#ifdef DEMO_HOST_BUILD
+
+pw::Status Initialize() { return pw::OkStatus(); }
+
+#else
+
+namespace {
+
+// ── Controller ────────────────────────────────────────────────────────────────
+
+// SDTR fields, in SD clock cycles (the register holds value − 1).
+constexpr uint32_t Timing(uint32_t mrd, uint32_t xsr, uint32_t ras, uint32_t rc,
+                          uint32_t wr, uint32_t rp, uint32_t rcd) {
+    return (mrd - 1) << 0 | (xsr - 1) << 4 | (ras - 1) << 8 | (rc - 1) << 12 |
+           (wr - 1) << 16 | (rp - 1) << 20 | (rcd - 1) << 24;
+}
+
+// SDCMR.MODE
+enum class Command : uint32_t {
+    kClockEnable  = 1,
+    kPrechargeAll = 2,
+    kAutoRefresh  = 3,
+    kLoadMode     = 4,
+};
+
+void Send(Command command, uint32_t refreshes = 1, uint32_t mode_register = 0) {
+    while (FMC_Bank5_6->SDSR & FMC_SDSR_BUSY) {}
+    FMC_Bank5_6->SDCMR = static_cast<uint32_t>(command) | FMC_SDCMR_CTB2 |
+                         (refreshes - 1) << FMC_SDCMR_NRFS_Pos |
+                         mode_register << FMC_SDCMR_MRD_Pos;
+}
+
+// Mode register: burst length 1, sequential, CAS latency 3, single write
+// bursts.
+constexpr uint32_t kModeRegister = 0x0230;
+
+// 64 ms / 4096 rows = 15.6 µs at 90 MHz, minus the 20-cycle safety margin
+// RM0090 asks for.
+constexpr uint32_t kRefreshCount = 1386;
+
+// ── Self-test ─────────────────────────────────────────────────────────────────
+
+// Walking ones: each of D0–D15 alone, in both halfwords of the 32-bit access
+// (the FMC splits it in two, so a stuck column A0 shows up here as well).
+bool DataLinesWork(volatile uint32_t* word) {
+    for (uint32_t bit = 1; bit != 0; bit <<= 1) {
+        *word = bit;
+        if (*word != bit)
+            return false;
+    }
+    return true;
+}
+
+// Word 0 and every power-of-two word offset get their own value.  A stuck or
+// shorted row, column or bank line makes two of them the same word, and the
+// one written first reads back wrong.
+bool AddressLinesWork(volatile uint32_t* base) {
+    constexpr size_t kWords = kSize / 4;
+    base[0] = 0;
+    for (size_t offset = 1; offset < kWords; offset <<= 1)
+        base[offset] = static_cast<uint32_t>(offset);
+    if (base[0] != 0)
+        return false;
+    for (size_t offset = 1; offset < kWords; offset <<= 1) {
+        if (base[offset] != offset)
+            return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+pw::Status Initialize() {
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOBEN | RCC_AHB1ENR_GPIOCEN | RCC_AHB1ENR_GPIODEN |
+                    RCC_AHB1ENR_GPIOEEN | RCC_AHB1ENR_GPIOFEN | RCC_AHB1ENR_GPIOGEN;
+    RCC->AHB3ENR |= RCC_AHB3ENR_FMCEN;
+    __DSB();
+
+    // All FMC signals the board routes to the SDRAM.
+    constexpr uint32_t kFmc = 12;
+    pin_mux::SetAlternate(GPIOB, 0b0000'0000'0110'0000, kFmc);  // SDCKE1, SDNE1
+    pin_mux::SetAlternate(GPIOC, 0b0000'0000'0000'0001, kFmc);  // SDNWE
+    pin_mux::SetAlternate(GPIOD, 0b1100'0111'0000'0011, kFmc);  // D0–D3, D13–D15
+    pin_mux::SetAlternate(GPIOE, 0b1111'1111'1000'0011, kFmc);  // NBL0, NBL1, D4–D12
+    pin_mux::SetAlternate(GPIOF, 0b1111'1000'0011'1111, kFmc);  // A0–A9, SDNRAS
+    pin_mux::SetAlternate(GPIOG, 0b1000'0001'0011'0011, kFmc);  // A10, A11, BA0, BA1, SDCLK, SDNCAS
+
+    // SDCLK, read burst and pipe delay live in SDCR1 whatever bank is used;
+    // likewise TRC and TRP in SDTR1.
+    FMC_Bank5_6->SDCR[0] = FMC_SDCR1_SDCLK_1 | FMC_SDCR1_RPIPE_0;
+    FMC_Bank5_6->SDCR[1] = FMC_SDCR1_NR_0 |    // 12 row address bits
+                           FMC_SDCR1_MWID_0 |  // 16-bit data bus
+                           FMC_SDCR1_NB |      // 4 internal banks
+                           FMC_SDCR1_CAS;      // CAS latency 3; 8 column bits
+    FMC_Bank5_6->SDTR[0] = Timing(2, 7, 4, 7, 2, 2, 2);
+    FMC_Bank5_6->SDTR[1] = Timing(2, 7, 4, 7, 2, 2, 2);
+
+    Send(Command::kClockEnable);
+    modm::delay(std::chrono::microseconds(100));
+    Send(Command::kPrechargeAll);
+    Send(Command::kAutoRefresh, 4);
+    Send(Command::kLoadMode, 1, kModeRegister);
+    FMC_Bank5_6->SDRTR = kRefreshCount << FMC_SDRTR_COUNT_Pos;
+    while (FMC_Bank5_6->SDSR & FMC_SDSR_BUSY) {}
+
+    volatile uint32_t* const base = reinterpret_cast<volatile uint32_t*>(kBase);
+    return DataLinesWork(base) && AddressLinesWork(base) ? pw::OkStatus()
+                                                         : pw::Status::DataLoss();
+}
+
+#endif  // DEMO_HOST_BUILD
+
+}  // namespace sdram
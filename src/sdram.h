@@ -0,0 +1,29 @@
+// External SDRAM of the DISCO-F429ZI: 8 MB (IS42S16400J, 16 bit, 4 banks)
+// on FMC SDRAM bank 2, mapped at 0xD000'0000.
+//
+//   PW_TRY(sdram::Initialize());   // once at boot, before any access
+//
+// Timing follows ST's board support package for this board at a 90 MHz SD
+// clock (HCLK / 2), CAS latency 3.  Initialize() finishes with a walking-ones
+// test of the data lines and a test of the address lines (one write to each
+// power-of-two offset) and returns DATA_LOSS if either fails.  It does not
+// test the cells themselves.
+//
+// Host builds (DEMO_HOST_BUILD) back the region with a static array; see
+// memory_region.h, which hands it out.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_status/status.h"
+
+namespace sdram {
+
+inline constexpr uintptr_t kBase = 0xD000'0000;
+inline constexpr size_t    kSize = 8 * 1024 * 1024;
+
+pw::Status Initialize();
+
+}  // namespace sdram
@@ -0,0 +1,65 @@
+// Application counters and gauges – see stats.h.
+
+#include "stats.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+#ifdef DEMO_HOST_BUILD
+#include <chrono>
+#else
+#include <modm/board.hpp>
+#endif
+
+namespace stats {
+namespace {
+
+std::array<std::atomic<uint32_t>, static_cast<size_t>(Counter::kCount)> counters{};
+std::array<std::atomic<uint32_t>, static_cast<size_t>(Gauge::kCount)>   gauges{};
+
+#ifdef DEMO_HOST_BUILD
+const auto kStart = std::chrono::steady_clock::now();
+
+std::atomic<bool>     virtual_clock{false};
+std::atomic<uint32_t> virtual_ms{0};
+#endif
+
+}  // namespace
+
+void Increment(Counter c) {
+    counters[static_cast<size_t>(c)].fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t Get(Counter c) {
+    return counters[static_cast<size_t>(c)].load(std::memory_order_relaxed);
+}
+
+void Set(Gauge g, uint32_t value) {
+    gauges[static_cast<size_t>(g)].store(value, std::memory_order_relaxed);
+}
+
+uint32_t Get(Gauge g) {
+    return gauges[static_cast<size_t>(g)].load(std::memory_order_relaxed);
+}
+
+uint32_t UptimeMs() {
+#ifdef DEMO_HOST_BUILD
+    if (virtual_clock.load(std::memory_order_relaxed))
+        return virtual_ms.load(std::memory_order_relaxed);
+    using namespace std::chrono;
+    return static_cast<uint32_t>(
+        duration_cast<milliseconds>(steady_clock::now() - kStart).count());
+#else
+    return static_cast<uint32_t>(modm::Clock::now().time_since_epoch().count());
+#endif
+}
+
+#ifdef DEMO_HOST_BUILD
+void SetUptimeMs(uint32_t ms) {
+    virtual_ms.store(ms, std::memory_order_relaxed);
+    virtual_clock.store(true, std::memory_order_relaxed);
+}
+#endif
+
+}  // namespace stats
@@ -0,0 +1,42 @@
+// Application counters and gauges, readable at runtime through the Stats RPC
+// service (rpc_services.h).  Increment() and Set() are relaxed atomic
+// operations, so they may be called from interrupt handlers as well as from
+// the application fibers.
+
+#pragma once
+
+#include <cstdint>
+
+namespace stats {
+
+enum class Counter : uint8_t {
+    kSamples,  // sensor readings taken
+    kBatches,  // batches processed by ProcessBatch()
+    kOverruns, // readings lost because the processor fell a batch behind
+    kCount,
+};
+
+void Increment(Counter c);
+uint32_t Get(Counter c);
+
+// Last measured values (not accumulated).
+enum class Gauge : uint8_t {
+    kJitterMaxUs,     // worst sampling period error since boot, µs
+    kSwitchCycles,    // cost of one fiber context switch, CPU cycles
+    kDisplayUs,       // last LCD strip chart update, µs
+    kCount,
+};
+
+void Set(Gauge g, uint32_t value);
+uint32_t Get(Gauge g);
+
+// Milliseconds since boot (host builds: since process start).
+uint32_t UptimeMs();
+
+#ifdef DEMO_HOST_BUILD
+// Makes UptimeMs() return |ms| from now on, instead of following the
+// steady clock: the virtual clock of the capture replay (host/replay.cc).
+void SetUptimeMs(uint32_t ms);
+#endif
+
+}  // namespace stats
@@ -0,0 +1,100 @@
+// Incrementally drawn strip chart – see strip_chart.h.
+
+#include "strip_chart.h"
+
+#include <algorithm>
+
+#include "cycle_counter.h"
+
+namespace strip_chart {
+namespace {
+
+constexpr uint16_t kPlotTop     = 0;
+constexpr uint16_t kPlotHeight  = 256;  // 2 rows per unit
+constexpr uint16_t kSeparatorY  = 259;
+constexpr uint16_t kBatchTop    = 264;
+constexpr uint16_t kBatchHeight = StripChart::kHeight - kBatchTop;
+
+constexpr uint16_t kNewColumn = StripChart::kWidth - kStep;
+
+// Row of |value| in a panel, kMaxValue at the top.
+uint16_t Row(int16_t value, uint16_t top, uint16_t height) {
+    const int32_t v = std::clamp(value, kMinValue, kMaxValue);
+    return static_cast<uint16_t>(top + (kMaxValue - v) * (height - 1) / (kMaxValue - kMinValue));
+}
+
+}  // namespace
+
+void StripChart::AddSample(int16_t value) {
+    const uint32_t t0 = cycle_counter::Now();
+    samples_.Push(value);
+    const size_t n = samples_.size();
+    Scroll(kPlotTop, kPlotHeight);
+    DrawSampleColumn(kNewColumn, n > 1 ? &samples_[n - 2] : nullptr, &samples_[n - 1]);
+    dma2d::Wait();
+    last_update_us_ = cycle_counter::ElapsedUs(t0);
+}
+
+void StripChart::AddBatch(int16_t mean, int16_t min, int16_t max) {
+    const uint32_t t0 = cycle_counter::Now();
+    batches_.Push({mean, min, max});
+    Scroll(kBatchTop, kBatchHeight);
+    DrawBatchColumn(kNewColumn, &batches_[batches_.size() - 1]);
+    dma2d::Wait();
+    last_update_us_ = cycle_counter::ElapsedUs(t0);
+}
+
+void StripChart::Redraw() {
+    dma2d::Fill(surface_, {0, 0, kWidth, kHeight}, kBackground);
+    dma2d::Fill(surface_, {0, kSeparatorY, kWidth, 2}, kGrid);
+
+    // Column c shows entry size() − kColumns + c, if there is one.
+    for (size_t c = 0; c < kColumns; ++c) {
+        const uint16_t x = static_cast<uint16_t>(c * kStep);
+
+        const size_t n = samples_.size();
+        if (n + c >= kColumns) {
+            const size_t i = n + c - kColumns;
+            DrawSampleColumn(x, i > 0 ? &samples_[i - 1] : nullptr, &samples_[i]);
+        } else {
+            DrawSampleColumn(x, nullptr, nullptr);
+        }
+
+        const size_t m = batches_.size();
+        DrawBatchColumn(x, m + c >= kColumns ? &batches_[m + c - kColumns] : nullptr);
+    }
+    dma2d::Wait();
+}
+
+void StripChart::DrawSampleColumn(uint16_t x, const int16_t* previous, const int16_t* value) {
+    dma2d::Fill(surface_, {x, kPlotTop, kStep, kPlotHeight}, kBackground);
+    dma2d::Fill(surface_, {x, Row(0, kPlotTop, kPlotHeight), 1, 1}, kGrid);
+    if (value == nullptr)
+        return;
+    const uint16_t y = Row(*value, kPlotTop, kPlotHeight);
+    if (previous != nullptr) {
+        // Vertical step from the previous reading.
+        const uint16_t from = Row(*previous, kPlotTop, kPlotHeight);
+        const uint16_t top  = std::min(from, y);
+        dma2d::Fill(surface_, {x, top, 1, static_cast<uint16_t>(std::max(from, y) - top + 1)},
+                    kTrace);
+    }
+    dma2d::Fill(surface_, {x, y, kStep, 1}, kTrace);
+}
+
+void StripChart::DrawBatchColumn(uint16_t x, const Batch* batch) {
+    dma2d::Fill(surface_, {x, kBatchTop, kStep, kBatchHeight}, kBackground);
+    if (batch == nullptr)
+        return;
+    // One pixel gap between neighbouring bars.
+    const uint16_t top    = Row(batch->max, kBatchTop, kBatchHeight);
+    const uint16_t bottom = Row(std::min(batch->min, batch->max), kBatchTop, kBatchHeight);
+    dma2d::Fill(surface_, {x, top, kStep - 1, static_cast<uint16_t>(bottom - top + 1)}, kRange);
+    dma2d::Fill(surface_, {x, Row(batch->mean, kBatchTop, kBatchHeight), kStep - 1, 1}, kMean);
+}
+
+void StripChart::Scroll(uint16_t top, uint16_t height) {
+    dma2d::Copy(surface_, {kStep, top, kWidth - kStep, height}, 0, top);
+}
+
+}  // namespace strip_chart
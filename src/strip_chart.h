@@ -0,0 +1,110 @@
+// Scrolling strip chart of the sensor readings and batch statistics, drawn
+// incrementally into an RGB565 framebuffer (lcd.h).
+//
+//   strip_chart::StripChart chart(lcd::Framebuffer());
+//   chart.Redraw();                     // once
+//   chart.AddSample(reading.raw_value); // every reading
+//   chart.AddBatch(mean, min, max);     // every batch
+//
+//   ┌──────────────────────────┐  y 0
+//   │      ╭╮    readings      │     trace of the last kColumns readings,
+//   │ ─ ─ ╭╯╰─ ─ ─ ─ ─ ─ ─ ─ ─ │     dotted zero line
+//   │ ───╯       ╭──           │
+//   ├──────────────────────────┤  y 264
+//   │ ▮▮▮▮▮▮ batches ▮▮▮▮▮▮    │     min–max bar and mean of the last
+//   └──────────────────────────┘  y 320  kColumns batches
+//
+// Each panel moves left by one kStep-pixel column per entry.  The move is a
+// single DMA2D memory-to-memory copy of the panel (dma2d.h); only the new
+// column on the right is drawn, as a handful of rectangle fills.  The CPU
+// never touches a pixel, so a reading costs it some microseconds whatever
+// the panel size.
+//
+// The chart also keeps the values on screen, so Redraw() can rebuild the
+// whole picture from scratch: after any sequence of Add…() calls the
+// framebuffer equals what Redraw() produces (host/strip_chart_render.cc
+// checks this).
+//
+// Values are clamped to [kMinValue, kMaxValue].
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "dma2d.h"
+
+namespace strip_chart {
+
+inline constexpr int16_t  kMinValue = -64;
+inline constexpr int16_t  kMaxValue = 63;
+inline constexpr uint16_t kStep     = 4;  // pixels per entry
+
+// RGB565
+inline constexpr uint16_t kBackground = 0x0000;
+inline constexpr uint16_t kGrid       = 0x4208;
+inline constexpr uint16_t kTrace      = 0x07E0;
+inline constexpr uint16_t kRange      = 0x4A69;
+inline constexpr uint16_t kMean       = 0xFFE0;
+
+class StripChart {
+public:
+    // |surface| must be at least kWidth × kHeight.
+    static constexpr uint16_t kWidth   = 240;
+    static constexpr uint16_t kHeight  = 320;
+    static constexpr size_t   kColumns = kWidth / kStep;
+
+    explicit StripChart(const dma2d::Surface& surface) : surface_(surface) {}
+
+    void AddSample(int16_t value);
+    void AddBatch(int16_t mean, int16_t min, int16_t max);
+
+    // Draws the whole chart from the values on screen.
+    void Redraw();
+
+    // Microseconds the last Add…() call took, including the wait for the
+    // DMA2D (other fibers run meanwhile).
+    uint32_t last_update_us() const { return last_update_us_; }
+
+private:
+    struct Batch {
+        int16_t mean;
+        int16_t min;
+        int16_t max;
+    };
+
+    // The last N entries, oldest first; the newest sits in the rightmost
+    // column.  samples_ keeps one more than fits: the left neighbour of the
+    // oldest column, where its trace segment starts.
+    template <typename T, size_t N>
+    class History {
+    public:
+        void Push(const T& item) {
+            items_[next_] = item;
+            next_         = (next_ + 1) % N;
+            if (count_ < N)
+                ++count_;
+        }
+        size_t size() const { return count_; }
+        // |i| counts from the oldest entry.
+        const T& operator[](size_t i) const { return items_[(next_ + N - count_ + i) % N]; }
+
+    private:
+        std::array<T, N> items_{};
+        size_t           next_  = 0;
+        size_t           count_ = 0;
+    };
+
+    void DrawSampleColumn(uint16_t x, const int16_t* previous, const int16_t* value);
+    void DrawBatchColumn(uint16_t x, const Batch* batch);
+    // Moves the panel rows [top, top + height) one column to the left.
+    void Scroll(uint16_t top, uint16_t height);
+
+    dma2d::Surface                  surface_;
+    History<int16_t, kColumns + 1>  samples_;
+    History<Batch, kColumns>        batches_;
+    uint32_t                        last_update_us_ = 0;
+};
+
+}  // namespace strip_chart
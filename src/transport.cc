@@ -0,0 +1,204 @@
+// Output transports – see transport.h.
+
+#include "transport.h"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef DEMO_HOST_BUILD
+#include <cstdio>
+
+#include "pw_sys_io/sys_io.h"
+#else
+#include <modm/board.hpp>
+#include <modm/processing/fiber.hpp>
+#endif
+
+namespace transport {
+
+// ── Uart ──────────────────────────────────────────────────────────────────────
+
+#ifdef DEMO_HOST_BUILD
+
+// The pseudo-terminal of host/sys_io_pty.cc.
+void Uart::Write(pw::span<const std::byte> data) {
+    for (std::byte b : data)
+        pw::sys_io::WriteByte(b).IgnoreError();
+}
+
+void Uart::Flush() {}
+
+void EnterCrashMode() {}
+
+#else
+
+namespace {
+
+// Set by EnterCrashMode(): USART1 (the ST-Link UART) is written register by
+// register, with interrupts masked.
+bool crash_mode = false;
+
+}  // namespace
+
+// Waits for a DMA transfer of the log drainer (async_uart.h) to finish, and
+// for room in the TX buffer, yielding to the other fibers meanwhile so the
+// UART never holds up the sampler.  Inside a fiber that lets every other
+// fiber run, the log drainer included, which is why the crash handler
+// switches to crash mode first.
+void Uart::Write(pw::span<const std::byte> data) {
+    if (crash_mode) {
+        for (std::byte b : data) {
+            while (!(USART1->SR & USART_SR_TXE)) {}
+            USART1->DR = static_cast<uint8_t>(b);
+        }
+        return;
+    }
+    while (!async_uart::Idle())
+        modm::this_fiber::yield();
+    for (std::byte b : data) {
+        while (!Board::stlink::Uart::write(static_cast<uint8_t>(b)))
+            modm::this_fiber::yield();
+    }
+}
+
+void Uart::Flush() {
+    if (crash_mode) {
+        while (!(USART1->SR & USART_SR_TC)) {}
+        return;
+    }
+    while (!async_uart::Idle() || !Board::stlink::Uart::isWriteFinished())
+        modm::this_fiber::yield();
+}
+
+// Bytes still in modm's interrupt-driven TX buffer (the end of an RPC reply)
+// are not sent any more; the crash report follows what is on the wire.
+void EnterCrashMode() {
+    __disable_irq();
+    async_uart::Stop();
+    crash_mode = true;
+}
+
+#endif  // DEMO_HOST_BUILD
+
+// ── RamRing ───────────────────────────────────────────────────────────────────
+
+void RamRing::Write(pw::span<const std::byte> data) {
+    uint32_t position = written_.load(std::memory_order_relaxed);
+    for (std::byte b : data)
+        buffer_[position++ % kSize] = b;
+    written_.store(position, std::memory_order_release);
+}
+
+size_t RamRing::Read(pw::span<std::byte> out) {
+    const uint32_t end   = written_.load(std::memory_order_acquire);
+    const size_t   count = std::min({out.size(), kSize, size_t{end}});
+    for (size_t i = 0; i < count; ++i)
+        out[i] = buffer_[(end - count + i) % kSize];
+    return count;
+}
+
+// ── ItmPort / File ────────────────────────────────────────────────────────────
+
+#ifndef DEMO_HOST_BUILD
+
+namespace {
+
+// Set by Initialize() or by a debugger that starts SWO trace; without it
+// stimulus writes would wait forever for a FIFO nobody empties.
+bool ItmEnabled(uint32_t port) {
+    return (CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk) &&
+           (ITM->TCR & ITM_TCR_ITMENA_Msk) && (ITM->TER & (1u << port));
+}
+
+// A stimulus port reads as non-zero while its FIFO has room.
+void WaitForRoom(uint32_t port) {
+    while (ITM->PORT[port].u32 == 0) {}
+}
+
+}  // namespace
+
+template <uint32_t kPort>
+void ItmPort<kPort>::Write(pw::span<const std::byte> data) {
+    if (!ItmEnabled(kPort))
+        return;
+    const std::byte* p = data.data();
+    size_t           n = data.size();
+    // The decoder reassembles the bytes of each stimulus packet in
+    // little-endian order, i.e. in memory order.
+    for (; n >= 4; p += 4, n -= 4) {
+        uint32_t word;
+        std::memcpy(&word, p, 4);
+        WaitForRoom(kPort);
+        ITM->PORT[kPort].u32 = word;
+    }
+    if (n >= 2) {
+        uint16_t half;
+        std::memcpy(&half, p, 2);
+        WaitForRoom(kPort);
+        ITM->PORT[kPort].u16 = half;
+        p += 2;
+        n -= 2;
+    }
+    if (n == 1) {
+        WaitForRoom(kPort);
+        ITM->PORT[kPort].u8 = static_cast<uint8_t>(*p);
+    }
+}
+
+// The ITM has no "sent" flag; room in the FIFO is the closest there is.
+template <uint32_t kPort>
+void ItmPort<kPort>::Flush() {
+    if (ItmEnabled(kPort))
+        WaitForRoom(kPort);
+}
+
+template class ItmPort<kItmTextPort>;
+template class ItmPort<kItmLogPort>;
+
+void Initialize() {
+#ifdef DEMO_LOG_TRANSPORT_ITM
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DBGMCU->CR       |= DBGMCU_CR_TRACE_IOEN;  // TRACE_MODE 0: asynchronous, SWO only
+    TPI->SPPR         = 2;                     // NRZ, like a UART
+    TPI->ACPR         = Board::SystemClock::Frequency / kSwoHz - 1;
+    TPI->FFCR         = 0x100;                 // formatter off (TrigIn stays on)
+    ITM->LAR          = 0xC5AC'CE55;           // unlock
+    ITM->TCR          = ITM_TCR_ITMENA_Msk | ITM_TCR_SYNCENA_Msk | 1u << ITM_TCR_TraceBusID_Pos;
+    ITM->TPR          = 0;                     // ports usable unprivileged
+    ITM->TER          = 1u << kItmTextPort | 1u << kItmLogPort;
+#endif
+}
+
+#else
+
+namespace {
+
+std::FILE* file = nullptr;
+
+}  // namespace
+
+bool File::Open(const char* path) {
+    std::FILE* f = std::fopen(path, "wb");
+    if (f == nullptr)
+        return false;
+    if (file != nullptr)
+        std::fclose(file);
+    file = f;
+    return true;
+}
+
+void File::Write(pw::span<const std::byte> data) {
+    if (file != nullptr)
+        std::fwrite(data.data(), 1, data.size(), file);
+}
+
+void File::Flush() {
+    if (file != nullptr)
+        std::fflush(file);
+}
+
+void Initialize() {}
+
+#endif  // DEMO_HOST_BUILD
+
+}  // namespace transport
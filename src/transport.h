@@ -0,0 +1,179 @@
+// Output transports for log and data bytes, selected at compile time.
+//
+//   transport::Log::Write(bytes);                 // blocking
+//   co_await transport::Log::WriteAsync(line);    // from a coroutine (coro.h)
+//
+// A transport is a class with static members only (see the Transport concept
+// below).  Call sites name a role – Log or Data – never a transport, so
+// switching costs nothing at runtime: no virtual calls, and transports no
+// role uses are never linked in.
+//
+//   Transport    Goes to                              Rate           Builds
+//   -----------  -----------------------------------  -------------  --------
+//   Uart         ST-Link virtual COM port (host: pty)  11.5 KB/s      both
+//   RamRing      last 4 KB in RAM, oldest overwritten  memory speed   both
+//   ItmPort<N>   ITM stimulus port N → SWO pin         ~160 KB/s      firmware
+//   File         a file opened with File::Open()       disk speed     host
+//
+// Log carries the tokenized log messages, Text the assert backend's crash
+// report; pick both with -DDEMO_LOG_TRANSPORT=uart|ram|itm|file.  Only itm
+// separates them: messages go raw to port kItmLogPort, text to port
+// kItmTextPort (the printf port of SWO viewers).  Data carries the
+// pw::sys_io output (RPC replies) and stays on the Uart, the only transport
+// with an input side.  Bytes for RamRing and ItmPort are lost silently when
+// nobody reads them (RamRing: read with a debugger, e.g.
+// `p/x transport::RamRing::buffer_` in gdb; ItmPort: tools/swo_decode.py on
+// a SWO capture).
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+
+#include "async_uart.h"
+#include "pw_span/span.h"
+
+namespace transport {
+
+template <typename T>
+concept Transport = requires(pw::span<const std::byte> data) {
+    { T::kName } -> std::convertible_to<const char*>;
+    // True: tokenized messages go out unencoded, framed as kFrameMarker |
+    // length (u16, little endian) | token ++ arguments.  False: as
+    // '$' Base64 '\n' lines (log_tokenized_handler.cc).
+    { T::kBinary } -> std::convertible_to<bool>;
+    // Returns once all of |data| is accepted; may yield to other fibers.
+    T::Write(data);
+    // Awaitable; |data| must stay valid until the next WriteAsync() or
+    // Flush() has completed.
+    T::WriteAsync(data);
+    // Returns once everything written has left the device.
+    T::Flush();
+};
+
+inline constexpr uint8_t kFrameMarker = 0xA5;
+
+class Uart {
+public:
+    static constexpr const char* kName   = "uart";
+    static constexpr bool        kBinary = false;
+
+    static void Write(pw::span<const std::byte> data);
+    // DMA on the board (async_uart.h).
+    static async_uart::WriteAwaiter WriteAsync(pw::span<const std::byte> data) {
+        return async_uart::Write(data);
+    }
+    static void Flush();
+};
+
+// Without DMA: writes synchronously, WriteAsync() never suspends.
+class RamRing {
+public:
+    static constexpr const char* kName   = "ram";
+    static constexpr bool        kBinary = false;
+    static constexpr size_t      kSize   = 4096;
+
+    static void Write(pw::span<const std::byte> data);
+    static std::suspend_never WriteAsync(pw::span<const std::byte> data) {
+        Write(data);
+        return {};
+    }
+    static void Flush() {}
+
+    // Copies the newest bytes, oldest first, into |out|; returns how many.
+    static size_t Read(pw::span<std::byte> out);
+    // Bytes written since boot; the ring holds the last kSize of them.
+    static uint32_t written() { return written_.load(std::memory_order_relaxed); }
+
+private:
+    static inline std::array<std::byte, kSize> buffer_{};
+    static inline std::atomic<uint32_t>        written_{0};
+};
+
+#ifndef DEMO_HOST_BUILD
+
+inline constexpr uint32_t kItmTextPort = 0;
+inline constexpr uint32_t kItmLogPort  = 1;
+
+// Without DMA, see RamRing.  Written in 32-bit stimulus words where
+// possible: 5 bytes on the SWO line per 4 bytes of data instead of 8.
+template <uint32_t kPort>
+class ItmPort {
+public:
+    static constexpr const char* kName   = "itm";
+    static constexpr bool        kBinary = kPort != kItmTextPort;
+
+    static void Write(pw::span<const std::byte> data);
+    static std::suspend_never WriteAsync(pw::span<const std::byte> data) {
+        Write(data);
+        return {};
+    }
+    static void Flush();
+};
+
+#else
+
+// Without DMA, see RamRing.
+class File {
+public:
+    static constexpr const char* kName   = "file";
+    static constexpr bool        kBinary = false;
+
+    // Truncates |path|.  False with errno set on failure; until a successful
+    // Open() everything written is dropped.
+    static bool Open(const char* path);
+
+    static void Write(pw::span<const std::byte> data);
+    static std::suspend_never WriteAsync(pw::span<const std::byte> data) {
+        Write(data);
+        return {};
+    }
+    static void Flush();
+};
+
+#endif  // DEMO_HOST_BUILD
+
+// ── Roles ─────────────────────────────────────────────────────────────────────
+
+#if defined(DEMO_LOG_TRANSPORT_RAM)
+using Log  = RamRing;
+using Text = Log;
+#elif defined(DEMO_LOG_TRANSPORT_ITM)
+#ifdef DEMO_HOST_BUILD
+#error "DEMO_LOG_TRANSPORT=itm needs the board"
+#endif
+using Log  = ItmPort<kItmLogPort>;
+using Text = ItmPort<kItmTextPort>;
+#elif defined(DEMO_LOG_TRANSPORT_FILE)
+#ifndef DEMO_HOST_BUILD
+#error "DEMO_LOG_TRANSPORT=file is for host builds"
+#endif
+using Log  = File;
+using Text = Log;
+#else
+using Log  = Uart;
+using Text = Log;
+#endif
+
+using Data = Uart;
+
+static_assert(Transport<Log> && Transport<Text> && Transport<Data>);
+static_assert(!Text::kBinary && !Data::kBinary);
+
+// Sets up what the selected transports need beyond async_uart::Initialize():
+// for itm, SWO output at kSwoHz (asynchronous NRZ on PB3, formatter off).
+// Call once at boot.
+inline constexpr uint32_t kSwoHz = 2'000'000;
+void Initialize();
+
+// For the crash handler: masks interrupts, lets the running DMA transfer
+// (and the one queued behind it) finish by polling, then switches Uart to
+// polled register writes.  From then on no transport yields to another
+// fiber, so nothing else runs.  There is no way back.  No-op on the host.
+void EnterCrashMode();
+
+}  // namespace transport
@@ -0,0 +1,114 @@
+// Hardware watchdog with per-task check-ins – see watchdog.h.
+//
+// Registers: RM0090 section 21 (IWDG), 7.3.21 (RCC_CSR), 38.16.4 (DBGMCU).
+
+#include "log_config.h"
+
+#include "watchdog.h"
+
+#include "stats.h"
+
+#ifndef DEMO_HOST_BUILD
+#include <modm/board.hpp>
+#endif
+
+#undef PW_LOG_MODULE_NAME
+#define PW_LOG_MODULE_NAME "WDOG"
+
+namespace watchdog {
+namespace {
+
+Supervisor supervisor;
+
+// ── Reset record ──────────────────────────────────────────────────────────────
+// Left alone by the startup code (.noinit), so it survives the IWDG reset;
+// valid only with the magic value, which a power-up leaves at random.
+
+struct ResetRecord {
+    uint32_t magic;
+    uint32_t task;
+    uint32_t uptime_ms;
+    uint32_t overdue_ms;
+};
+
+constexpr uint32_t kRecordMagic = 0x57'44'4f'47;  // "WDOG"
+
+#ifdef DEMO_HOST_BUILD
+ResetRecord record;
+#else
+__attribute__((section(".noinit"))) ResetRecord record;
+#endif
+
+void Kick() {
+#ifndef DEMO_HOST_BUILD
+    IWDG->KR = 0xAAAA;
+#endif
+}
+
+}  // namespace
+
+// ── Firmware ──────────────────────────────────────────────────────────────────
+
+ResetCause Initialize() {
+    ResetCause cause{};
+#ifndef DEMO_HOST_BUILD
+    cause.watchdog = (RCC->CSR & RCC_CSR_IWDGRSTF) != 0;
+    RCC->CSR |= RCC_CSR_RMVF;  // clears all reset flags
+#endif
+    if (cause.watchdog && record.magic == kRecordMagic &&
+        record.task < static_cast<uint32_t>(Task::kCount)) {
+        cause.starved    = static_cast<Task>(record.task);
+        cause.uptime_ms  = record.uptime_ms;
+        cause.overdue_ms = record.overdue_ms;
+    }
+    record.magic = 0;
+
+    if (cause.starved) {
+        PW_LOG_WARN("watchdog reset: %s starved, %u ms overdue after %u ms uptime",
+                    Name(*cause.starved), (unsigned int)cause.overdue_ms,
+                    (unsigned int)cause.uptime_ms);
+    } else if (cause.watchdog) {
+        PW_LOG_WARN("watchdog reset: Service() stopped running");
+    }
+    return cause;
+}
+
+void Start() {
+#ifndef DEMO_HOST_BUILD
+    DBGMCU->APB1FZ |= DBGMCU_APB1_FZ_DBG_IWDG_STOP;
+    IWDG->KR  = 0xCCCC;  // start; from here on it cannot be stopped
+    IWDG->KR  = 0x5555;  // unlock PR and RLR
+    IWDG->PR  = 4;       // LSI / 64: 2 ms per count
+    static_assert(kTimeoutMs / 2 <= 0xFFF, "RLR is 12 bits");
+    IWDG->RLR = kTimeoutMs / 2;
+    while (IWDG->SR != 0) {}  // both values taken over
+#endif
+    Kick();
+    PW_LOG_INFO("watchdog: %u ms, fed every %u ms while all tasks check in",
+                (unsigned int)kTimeoutMs, (unsigned int)kKickIntervalMs);
+}
+
+void Watch(Task task, uint32_t deadline_ms) {
+    supervisor.Watch(task, deadline_ms, stats::UptimeMs());
+}
+
+void CheckIn(Task task) { supervisor.CheckIn(task, stats::UptimeMs()); }
+
+void Service() {
+    const bool had_starved = supervisor.starved().has_value();
+    const uint32_t now     = stats::UptimeMs();
+    if (supervisor.Poll(now)) {
+        Kick();
+        return;
+    }
+    if (had_starved || !supervisor.starved())
+        return;
+    record = {kRecordMagic, static_cast<uint32_t>(*supervisor.starved()), now,
+              supervisor.overdue_ms()};
+    PW_LOG_ERROR("watchdog: %s missed its deadline by %u ms; reset follows",
+                 Name(*supervisor.starved()), (unsigned int)supervisor.overdue_ms());
+}
+
+const Supervisor& State() { return supervisor; }
+
+}  // namespace watchdog
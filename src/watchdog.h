@@ -0,0 +1,153 @@
+// Hardware watchdog (IWDG) fed only while every supervised task is alive.
+//
+//   watchdog::Initialize();                        // at boot: logs the last reset
+//   watchdog::Start();                             // when boot is done
+//   watchdog::Watch(Task::kSampler, 1500);         // deadline in ms
+//   watchdog::CheckIn(Task::kSampler);             // from the task, every cycle
+//   watchdog::Service();                           // from the UART fiber's loop
+//
+// Each periodic activity checks in at least once per its own deadline.
+// Service() kicks the IWDG only when all of them have, and no sooner than
+// kKickIntervalMs after the previous kick – a loop that calls it
+// continuously does not keep the board alive on its own.  Once a task has
+// missed its deadline the supervisor stops kicking for good: the IWDG resets
+// the board kTimeoutMs after the last kick.  Anything else that stops the
+// fiber calling Service() – a blocking UART write, an endless loop, the
+// assert handler's halt – ends the same way.
+//
+// Before giving up, the supervisor writes which task starved, and by how
+// much, to a RAM record that survives the reset.  The next Initialize()
+// logs and returns it; main.cpp keeps it in the flash history
+// (history::Event::kWatchdog).
+//
+// Supervisor is the decision logic alone, with time passed in, so the host
+// can run it against a fake clock (host/watchdog_sim.cc).  Call CheckIn()
+// and Service() from fibers, not from interrupt handlers.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace watchdog {
+
+enum class Task : uint8_t {
+    kSampler,
+    kProcessor,
+    kLogDrain,
+    kCount,
+};
+
+constexpr const char* Name(Task task) {
+    switch (task) {
+        case Task::kSampler:   return "sampler";
+        case Task::kProcessor: return "processor";
+        case Task::kLogDrain:  return "log drain";
+        case Task::kCount:     break;
+    }
+    return "?";
+}
+
+// IWDG period: LSI (~32 kHz) / 64, reload 2000.  Long enough for a flash
+// sector erase (up to 2 s), which busy-waits in the superloop build; the LSI
+// varies by up to ±50 % between parts, so kick well within it.
+inline constexpr uint32_t kTimeoutMs      = 4000;
+inline constexpr uint32_t kKickIntervalMs = 250;
+
+class Supervisor {
+public:
+    static constexpr size_t kTasks = static_cast<size_t>(Task::kCount);
+
+    constexpr Supervisor() = default;
+
+    // Starts (or, with deadline 0, stops) supervising |task|; counts as a
+    // check-in.  Tasks not watched yet are not waited for.
+    void Watch(Task task, uint32_t deadline_ms, uint32_t now_ms);
+    void CheckIn(Task task, uint32_t now_ms);
+
+    // True if the hardware watchdog is to be kicked now.  Latches the first
+    // task found past its deadline; from then on always false.
+    bool Poll(uint32_t now_ms);
+
+    std::optional<Task> starved() const { return starved_; }
+    // How far past its deadline the starved task was when Poll() noticed.
+    uint32_t overdue_ms() const { return overdue_ms_; }
+    uint32_t kicks() const { return kicks_; }
+
+private:
+    struct Slot {
+        uint32_t deadline_ms  = 0;  // 0: not watched
+        uint32_t last_checkin = 0;
+    };
+
+    std::array<Slot, kTasks> slots_{};
+    std::optional<Task>      starved_;
+    uint32_t                 overdue_ms_ = 0;
+    uint32_t                 last_kick_  = 0;
+    uint32_t                 kicks_      = 0;
+    bool                     kicked_     = false;
+};
+
+// ── Supervisor ────────────────────────────────────────────────────────────────
+// Inline, so host tools need neither the logger nor the hardware.  Times are
+// differences of uint32_t milliseconds, so the 49-day wrap of the uptime does
+// not matter.
+
+inline void Supervisor::Watch(Task task, uint32_t deadline_ms, uint32_t now_ms) {
+    slots_[static_cast<size_t>(task)] = {deadline_ms, now_ms};
+}
+
+inline void Supervisor::CheckIn(Task task, uint32_t now_ms) {
+    slots_[static_cast<size_t>(task)].last_checkin = now_ms;
+}
+
+inline bool Supervisor::Poll(uint32_t now_ms) {
+    if (starved_)
+        return false;
+    for (size_t i = 0; i < kTasks; ++i) {
+        const Slot& slot = slots_[i];
+        if (slot.deadline_ms == 0)
+            continue;
+        const uint32_t since = now_ms - slot.last_checkin;
+        if (since > slot.deadline_ms) {
+            starved_    = static_cast<Task>(i);
+            overdue_ms_ = since - slot.deadline_ms;
+            return false;
+        }
+    }
+    if (kicked_ && now_ms - last_kick_ < kKickIntervalMs)
+        return false;
+    kicked_    = true;
+    last_kick_ = now_ms;
+    ++kicks_;
+    return true;
+}
+
+// ── Firmware ──────────────────────────────────────────────────────────────────
+
+// What the previous run left behind.
+struct ResetCause {
+    bool                watchdog;  // the IWDG reset the board
+    std::optional<Task> starved;   // set if the supervisor let it
+    uint32_t            uptime_ms; // when the supervisor gave up
+    uint32_t            overdue_ms;
+};
+
+// Reads and clears the reset flags and the starvation record, and logs them.
+ResetCause Initialize();
+
+// Starts the IWDG, which cannot be stopped again; call it once boot is done
+// (formatting the flash history takes seconds).  The IWDG is frozen while a
+// debugger halts the core.  Host builds have no IWDG.
+void Start();
+
+// The firmware's supervisor, on stats::UptimeMs().
+void Watch(Task task, uint32_t deadline_ms);
+void CheckIn(Task task);
+void Service();
+
+const Supervisor& State();
+
+}  // namespace watchdog
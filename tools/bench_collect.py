@@ -0,0 +1,79 @@
+#!/usr/bin/env python3
+"""Run the firmware's hot-path benchmarks and store the results as JSON.
+
+Calls Bench.Run and Device.GetBuildInfo over the UART RPC service
+(src/rpc_services.h), so every result names the build it was measured on:
+
+  python tools/bench_collect.py /dev/ttyACM0                      # to stdout
+  python tools/bench_collect.py /dev/ttyACM0 -o bench.json --runs 64
+  python tools/bench_collect.py /dev/ttyACM0 --append bench-history.jsonl
+
+--append adds one line per run to a JSON Lines file, for tracking a kernel
+across commits.  Cycle counts come from the DWT counter with interrupts
+masked (src/bench.h); the host build answers in nanoseconds ("unit": "ns").
+
+  {"commit": "...", "dirty": false, "build_id": "...", "time": "...",
+   "unit": "cycles", "ticks_per_us": 180, "runs": 32,
+   "kernels": {"crc32": {"cold": ..., "min": ..., "median": ..., "max": ...}, ...}}
+
+Requires pyserial.
+"""
+
+import argparse
+import datetime
+import json
+import sys
+
+import device_info
+import read_build_meta
+import rpc_client
+
+
+def collect(client: rpc_client.RpcClient, runs: int) -> dict:
+    meta = device_info.parse_response(client.build_info())
+    per_us, kernels = client.bench(runs)
+    return {
+        "commit":       meta["commit"],
+        "dirty":        meta["dirty"],
+        "build_id":     meta["runtime_build_id"],
+        "time":         datetime.datetime.now(datetime.timezone.utc).isoformat(timespec="seconds"),
+        "unit":         "ns" if per_us == 1000 else "cycles",
+        "ticks_per_us": per_us,
+        "runs":         runs or 32,
+        "kernels":      kernels,
+    }
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("device", help="serial port or host-build pty")
+    parser.add_argument("--baudrate", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=2.0, help="seconds (default: 2)")
+    parser.add_argument("--runs", type=int, default=0, help="1..64 per kernel (default: 32)")
+    out = parser.add_mutually_exclusive_group()
+    out.add_argument("-o", "--output", help="write the result to this file")
+    out.add_argument("--append", metavar="FILE", help="append it as one line to a JSON Lines file")
+    args = parser.parse_args()
+
+    try:
+        with rpc_client.open_port(args.device, args.baudrate) as port:
+            result = collect(rpc_client.RpcClient(port, args.timeout), args.runs)
+    except (read_build_meta.MetaError, rpc_client.RpcError, TimeoutError, OSError) as e:
+        print(f"ERROR: {args.device}: {e}", file=sys.stderr)
+        return 1
+
+    if args.append:
+        with open(args.append, "a") as f:
+            f.write(json.dumps(result) + "\n")
+    elif args.output:
+        with open(args.output, "w") as f:
+            json.dump(result, f, indent=2)
+            f.write("\n")
+    else:
+        json.dump(result, sys.stdout, indent=2)
+        print()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,62 @@
+#!/usr/bin/env python3
+"""Ask a running device for its build metadata and build ID.
+
+Calls Device.GetBuildInfo over the UART RPC service (src/rpc_services.h)
+and prints the answer in the same form as tools/read_build_meta.py prints an
+ELF, so the device can be matched to its image without resetting it:
+
+  python tools/device_info.py /dev/ttyACM0
+  python tools/device_info.py /dev/ttyACM0 --json
+
+Log output arriving while waiting is ignored.  Requires pyserial.
+"""
+
+import argparse
+import json
+import sys
+
+import read_build_meta
+import rpc_client
+
+
+def parse_response(data: bytes) -> dict:
+    """Decode BuildMetadata | build ID length | build ID."""
+    if len(data) < 8:
+        raise read_build_meta.MetaError("response too short")
+    size = int.from_bytes(data[6:8], "little")   # BuildMetadata.size
+    meta = read_build_meta.parse_metadata(data[:size])
+    rest = data[size:]
+    if not rest or len(rest) < 1 + rest[0]:
+        raise read_build_meta.MetaError("response truncated after metadata")
+    meta["runtime_build_id"] = rest[1:1 + rest[0]].hex()
+    return meta
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("device", help="serial port of the ST-Link VCP")
+    parser.add_argument("--baudrate", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=2.0, help="seconds (default: 2)")
+    parser.add_argument("--json", action="store_true", help="print the fields as JSON")
+    args = parser.parse_args()
+
+    try:
+        with rpc_client.open_port(args.device, args.baudrate) as port:
+            data = rpc_client.RpcClient(port, args.timeout).build_info()
+        meta = parse_response(data)
+    except (read_build_meta.MetaError, rpc_client.RpcError, TimeoutError, OSError) as e:
+        print(f"ERROR: {args.device}: {e}", file=sys.stderr)
+        return 1
+
+    if args.json:
+        json.dump(meta, sys.stdout, indent=2)
+        print()
+    else:
+        read_build_meta.print_metadata(meta)
+        if meta.get("build_id") and meta["build_id"] != meta["runtime_build_id"]:
+            print(f"WARNING: .note.gnu.build-id is {meta['runtime_build_id']}", file=sys.stderr)
+    return 0 if meta["crc_ok"] else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
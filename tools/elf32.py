@@ -0,0 +1,173 @@
+"""Minimal little-endian ELF32 reader shared by the host tools.
+
+Only the pieces the tools need are decoded: the section header table (to find
+named sections such as .build_metadata, and the GNU build ID note), the
+PT_LOAD program headers (to rebuild the flash image exactly as objcopy -O
+binary would) and the symbol table (function sizes).  Everything operates
+on a buffer-protocol object, normally a memory-mapped file, so the cost is
+independent of the image size.
+"""
+
+import mmap
+import struct
+
+ELF_MAGIC   = b"\x7fELF"
+ELFCLASS32  = 1
+ELFDATA2LSB = 1
+SHT_SYMTAB  = 2
+SHT_NOTE    = 7
+SHT_NOBITS  = 8
+SHF_ALLOC   = 0x2
+SHF_EXECINSTR = 0x4
+STT_FUNC    = 2
+PT_LOAD     = 1
+NT_GNU_BUILD_ID = 3
+
+# e_phoff, e_shoff, e_flags, e_ehsize, e_phentsize, e_phnum, e_shentsize, e_shnum, e_shstrndx
+EHDR_FMT = "<IIIHHHHHH"
+EHDR_OFF = 0x1C
+# sh_name, sh_type, sh_flags, sh_addr, sh_offset, sh_size, sh_link
+SHDR_FMT = "<IIIIIII"
+# st_name, st_value, st_size, st_info, st_other, st_shndx
+SYM_FMT  = "<IIIBBH"
+# p_type, p_offset, p_vaddr, p_paddr, p_filesz, p_memsz
+PHDR_FMT = "<IIIIII"
+
+
+class ElfError(Exception):
+    """Raised when a file is not a usable ELF32 image."""
+
+
+class Section:
+    __slots__ = ("name", "type", "flags", "addr", "offset", "size", "link")
+
+    def __init__(self, name, sh_type, flags, addr, offset, size, link):
+        self.name, self.type, self.flags = name, sh_type, flags
+        self.addr, self.offset, self.size, self.link = addr, offset, size, link
+
+
+class Symbol:
+    __slots__ = ("name", "value", "size", "type", "shndx")
+
+    def __init__(self, name, value, size, st_type, shndx):
+        self.name, self.value, self.size, self.type, self.shndx = name, value, size, st_type, shndx
+
+
+class Segment:
+    __slots__ = ("offset", "paddr", "filesz")
+
+    def __init__(self, offset, paddr, filesz):
+        self.offset, self.paddr, self.filesz = offset, paddr, filesz
+
+
+def _header(buf):
+    if len(buf) < 0x34 or buf[:4] != ELF_MAGIC:
+        raise ElfError("not an ELF file")
+    if buf[4] != ELFCLASS32 or buf[5] != ELFDATA2LSB:
+        raise ElfError("not a little-endian ELF32 file")
+    return struct.unpack_from(EHDR_FMT, buf, EHDR_OFF)
+
+
+def iter_sections(buf):
+    """Yield a Section for every entry of the section header table."""
+    _, shoff, _, _, _, _, shentsize, shnum, shstrndx = _header(buf)
+    if shoff == 0 or shnum == 0 or shstrndx >= shnum:
+        raise ElfError("ELF has no section header table")
+    if shoff + shnum * shentsize > len(buf):
+        raise ElfError("section header table truncated")
+
+    _, _, _, _, str_off, str_size, _ = struct.unpack_from(
+        SHDR_FMT, buf, shoff + shstrndx * shentsize)
+    strtab = bytes(buf[str_off:str_off + str_size])
+
+    for i in range(shnum):
+        sh_name, sh_type, sh_flags, sh_addr, sh_offset, sh_size, sh_link = struct.unpack_from(
+            SHDR_FMT, buf, shoff + i * shentsize)
+        end = strtab.find(b"\x00", sh_name)
+        yield Section(strtab[sh_name:end], sh_type, sh_flags, sh_addr, sh_offset, sh_size,
+                      sh_link)
+
+
+def find_section(buf, name: bytes) -> Section:
+    """Return the header of section |name| in the ELF32 image |buf|."""
+    for sec in iter_sections(buf):
+        if sec.name != name:
+            continue
+        if sec.type != SHT_NOBITS and sec.offset + sec.size > len(buf):
+            raise ElfError(f"{name.decode()} extends past end of file")
+        return sec
+
+    raise ElfError(f"section {name.decode()} not found")
+
+
+def gnu_build_id(buf) -> bytes:
+    """Return the descriptor of the NT_GNU_BUILD_ID note (-Wl,--build-id).
+
+    All note sections (and any section named like a build ID) are searched,
+    because the linker script decides which output section the
+    .note.gnu.build-id input section ends up in and what type it gets.
+    """
+    for sec in iter_sections(buf):
+        if sec.type != SHT_NOTE and b"build_id" not in sec.name and b"build-id" not in sec.name:
+            continue
+        pos, end = sec.offset, min(sec.offset + sec.size, len(buf))
+        while pos + 12 <= end:
+            namesz, descsz, n_type = struct.unpack_from("<III", buf, pos)
+            name_off = pos + 12
+            desc_off = name_off + ((namesz + 3) & ~3)
+            if n_type == NT_GNU_BUILD_ID and bytes(buf[name_off:name_off + namesz]) == b"GNU\x00":
+                return bytes(buf[desc_off:desc_off + descsz])
+            pos = desc_off + ((descsz + 3) & ~3)
+    raise ElfError("no GNU build ID note (link with -Wl,--build-id)")
+
+
+def iter_symbols(buf):
+    """Yield a Symbol for every entry of the static symbol table (.symtab)."""
+    sections = list(iter_sections(buf))
+    for sec in sections:
+        if sec.type != SHT_SYMTAB:
+            continue
+        if sec.link >= len(sections):
+            raise ElfError("symbol table without a string table")
+        strsec = sections[sec.link]
+        strtab = bytes(buf[strsec.offset:strsec.offset + strsec.size])
+        entsize = struct.calcsize(SYM_FMT)
+        end = min(sec.offset + sec.size, len(buf))
+        for pos in range(sec.offset + entsize, end - entsize + 1, entsize):  # entry 0 is null
+            st_name, st_value, st_size, st_info, _, st_shndx = struct.unpack_from(SYM_FMT, buf, pos)
+            name_end = strtab.find(b"\x00", st_name)
+            yield Symbol(strtab[st_name:name_end], st_value, st_size, st_info & 0xF, st_shndx)
+        return
+    raise ElfError("ELF has no symbol table (stripped?)")
+
+
+def section_bytes(buf, name: bytes) -> bytes:
+    """Return the raw file contents of section |name|."""
+    sec = find_section(buf, name)
+    if sec.type == SHT_NOBITS:
+        raise ElfError(f"{name.decode()} has no file contents (NOBITS)")
+    return bytes(buf[sec.offset:sec.offset + sec.size])
+
+
+def load_segments(buf) -> list:
+    """Return the PT_LOAD segments that carry file data, sorted by load address."""
+    phoff, _, _, _, phentsize, phnum, _, _, _ = _header(buf)
+    if phoff == 0 or phnum == 0:
+        raise ElfError("ELF has no program header table")
+    segs = []
+    for i in range(phnum):
+        p_type, p_offset, _, p_paddr, p_filesz, _ = struct.unpack_from(
+            PHDR_FMT, buf, phoff + i * phentsize)
+        if p_type == PT_LOAD and p_filesz:
+            segs.append(Segment(p_offset, p_paddr, p_filesz))
+    return sorted(segs, key=lambda s: s.paddr)
+
+
+def map_file(path: str, writable: bool = False) -> mmap.mmap:
+    """Memory-map |path|; the caller closes the returned map."""
+    with open(path, "r+b" if writable else "rb") as f:
+        try:
+            return mmap.mmap(f.fileno(), 0,
+                             access=mmap.ACCESS_WRITE if writable else mmap.ACCESS_READ)
+        except ValueError:  # zero-length file cannot be mapped
+            raise ElfError("empty file") from None
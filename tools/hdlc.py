@@ -0,0 +1,81 @@
+"""HDLC-lite framing used on the device UART (see src/hdlc.h).
+
+  0x7E | (address << 1) | 1 | 0x03 | payload | CRC-32 LE | 0x7E
+
+with 0x7E / 0x7D inside a frame escaped as 0x7D, byte ^ 0x20.  The FCS is
+zlib.crc32 over address, control and payload — the pw_hdlc wire format.
+
+Frames share the port with tokenized log lines; bytes that do not form a valid
+frame are handed to an optional callback so callers can pass the log through.
+"""
+
+import struct
+import zlib
+
+FLAG       = 0x7E
+ESCAPE     = 0x7D
+ESCAPE_XOR = 0x20
+UI_CONTROL = 0x03
+
+
+class Frame:
+    __slots__ = ("address", "payload")
+
+    def __init__(self, address: int, payload: bytes):
+        self.address, self.payload = address, payload
+
+
+def _escape(data: bytes) -> bytes:
+    return (data.replace(b"\x7d", b"\x7d\x5d")
+                .replace(b"\x7e", b"\x7d\x5e"))
+
+
+def encode_ui_frame(address: int, payload: bytes) -> bytes:
+    if not 0 <= address <= 0x7F:
+        raise ValueError(f"address {address} needs more than one byte")
+    body = bytes([(address << 1) | 1, UI_CONTROL]) + payload
+    body += struct.pack("<I", zlib.crc32(body) & 0xFFFF_FFFF)
+    return bytes([FLAG]) + _escape(body) + bytes([FLAG])
+
+
+class FrameDecoder:
+    """Incremental decoder; feed arbitrary chunks, get complete frames back."""
+
+    def __init__(self, on_unframed=None):
+        self._raw   = bytearray()   # bytes since the last flag, as received
+        self._on_unframed = on_unframed
+
+    def _complete(self, raw: bytes):
+        body = bytearray()
+        it = iter(raw)
+        for b in it:
+            if b == ESCAPE:
+                b = next(it, None)
+                if b is None:
+                    return None
+                b ^= ESCAPE_XOR
+            body.append(b)
+        if len(body) < 6 or not body[0] & 1 or body[1] != UI_CONTROL:
+            return None
+        if zlib.crc32(body[:-4]) & 0xFFFF_FFFF != struct.unpack_from("<I", body, len(body) - 4)[0]:
+            return None
+        return Frame(body[0] >> 1, bytes(body[2:-4]))
+
+    def process(self, data: bytes):
+        """Yield every Frame completed by |data|."""
+        for b in data:
+            if b != FLAG:
+                self._raw.append(b)
+                continue
+            raw, self._raw = bytes(self._raw), bytearray()
+            frame = self._complete(raw) if raw else None
+            if frame is not None:
+                yield frame
+            elif raw and self._on_unframed:
+                self._on_unframed(raw)
+
+    def flush(self) -> None:
+        """Pass on bytes still waiting for a flag (end of a capture)."""
+        if self._raw and self._on_unframed:
+            self._on_unframed(bytes(self._raw))
+        self._raw = bytearray()
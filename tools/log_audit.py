@@ -0,0 +1,373 @@
+#!/usr/bin/env python3
+"""Audit what each tokenized log site costs on the wire.
+
+Static report, from the firmware ELF (the .pw_tokenizer.entries section the
+build also extracts tokens.csv from) or from a tokens.csv database:
+
+  python tools/log_audit.py build/debug/stm32f429i_demo
+
+For every format string: the call sites that use it, the argument types
+pw_tokenizer encodes for its conversion specifiers, and the smallest and
+largest message and UART line this can produce.  Sites with arguments that
+cost more than they need to are flagged (strings, 64-bit integers, floats).
+
+With a capture of the log output (UART, host pty, `tools/swo_decode.py`
+without --database: anything with $base64 messages in it) the report is
+ranked by the bytes each site actually sent, per second with --seconds:
+
+  python tools/log_audit.py build/debug/stm32f429i_demo --capture log.txt --seconds 600
+
+and the arguments are checked against the values seen: a value that never
+changes belongs in the format string (hoist it), a string from a small set
+of values can be an enum, an integer that needs three or more varint bytes
+on average, or rises with every message like a millisecond timestamp, is
+worth logging as a delta or in a coarser unit, and a float that only ever
+held whole numbers can be an integer.
+
+Wire costs (pw_tokenizer encode_args.cc; log_tokenized_handler.cc):
+  token                      4 bytes
+  %d %u %x %c %p …           zigzag varint of the 32-bit value, 1–5 bytes
+  %lld %llu %j…              zigzag varint of the 64-bit value, 1–10 bytes
+  %f %e %g …                 float, 4 bytes
+  %s                         length byte + characters
+  UART line                  '$' + Base64 of the message + '\\n'
+"""
+
+import argparse
+import base64
+import collections
+import csv
+import json
+import math
+import re
+import struct
+import sys
+
+import elf32
+
+TOKENS_SECTION = b".pw_tokenizer.entries"
+ENTRY_MAGIC    = 0xBAA98DEE
+ENTRY_HEADER   = struct.Struct("<IIII")   # magic, token, domain length, string length
+
+CONSTANT_MIN   = 8     # messages before an unchanging argument is flagged
+SMALL_SET      = 8     # distinct strings that still make a good enum
+WIDE_BYTES     = 3.0   # average varint bytes that make an integer "wide"
+RISING_BYTES   = 2.0   # … or one that rises in every message
+
+_SPEC = re.compile(r"%(?P<flags>[-+ #0]*)(?P<width>\*|\d+)?(?:\.(?P<precision>\*|\d+))?"
+                   r"(?P<length>hh|h|ll|l|L|j|z|t)?(?P<conv>[diouxXcspfFeEgGaA%])")
+_MESSAGE = re.compile(rb"\$([A-Za-z0-9+/]+={0,2})")
+_MODULE  = re.compile(r"^\[[^\]]*\] ")   # PW_LOG_TOKENIZED_FORMAT_STRING in src/log_config.h
+
+INT, INT64, FLOAT, STRING = "int", "int64", "float", "string"
+_COST = {INT: (1, 5), INT64: (1, 10), FLOAT: (4, 4), STRING: (1, None)}
+
+
+# ── Format strings ────────────────────────────────────────────────────────────
+
+def arg_types(fmt: str) -> list:
+    """Encoded argument types of |fmt|, in order ('*' widths count as ints)."""
+    types = []
+    for m in _SPEC.finditer(fmt):
+        conv = m.group("conv")
+        if conv == "%":
+            continue
+        types += [INT] * ((m.group("width") == "*") + (m.group("precision") == "*"))
+        if conv == "s":
+            types.append(STRING)
+        elif conv in "fFeEgGaA":
+            types.append(FLOAT)
+        elif m.group("length") in ("ll", "j"):
+            types.append(INT64)
+        else:
+            types.append(INT)
+    return types
+
+
+def line_bytes(message_bytes: int) -> int:
+    return 2 + 4 * math.ceil(message_bytes / 3)
+
+
+class Site:
+    """One format string: a token and the log calls that use it."""
+
+    def __init__(self, token: int, domain: str, fmt: str):
+        self.token  = token
+        self.domain = domain
+        self.fmt    = fmt
+        self.sites  = 0
+        self.types  = arg_types(fmt)
+        self.flags  = []
+        # Filled from a capture.
+        self.count      = 0
+        self.wire_bytes = 0
+        self.args       = [ArgStats(t) for t in self.types]
+
+    def size_range(self):
+        lo = 4 + sum(_COST[t][0] for t in self.types)
+        hi = None if STRING in self.types else 4 + sum(_COST[t][1] for t in self.types)
+        return lo, hi
+
+    def static_flags(self):
+        for i, t in enumerate(self.types):
+            if t == STRING:
+                self.flags.append(f"arg {i + 1}: string, 1 + length bytes per message")
+            elif t == INT64:
+                self.flags.append(f"arg {i + 1}: 64-bit, up to 10 bytes; 32 bits enough?")
+            elif t == FLOAT:
+                self.flags.append(f"arg {i + 1}: float, always 4 bytes")
+
+
+def read_elf(path: str) -> dict:
+    """Token → Site from the entries section; |sites| counts the entries."""
+    with elf32.map_file(path) as m:
+        data = elf32.section_bytes(m, TOKENS_SECTION)
+    sites = {}
+    pos = 0
+    while pos + ENTRY_HEADER.size <= len(data):
+        magic, token, domain_len, string_len = ENTRY_HEADER.unpack_from(data, pos)
+        if magic != ENTRY_MAGIC:
+            pos += 1   # alignment padding between entries
+            continue
+        start  = pos + ENTRY_HEADER.size
+        domain = data[start:start + domain_len].rstrip(b"\0").decode(errors="replace")
+        fmt    = data[start + domain_len:start + domain_len + string_len]
+        site = sites.get(token)
+        if site is None:
+            site = sites[token] = Site(token, domain, fmt.rstrip(b"\0").decode(errors="replace"))
+        site.sites += 1
+        pos = start + domain_len + string_len
+    return sites
+
+
+def read_csv(path: str) -> dict:
+    """Token → Site from a pw_tokenizer CSV database (sites unknown)."""
+    sites = {}
+    with open(path, newline="", encoding="utf-8") as f:
+        for row in csv.reader(f):
+            if len(row) < 3:
+                continue
+            token = int(row[0], 16)
+            domain, fmt = (row[2], row[3]) if len(row) >= 4 else ("", row[2])
+            sites[token] = Site(token, domain, fmt)
+    return sites
+
+
+def read_sites(path: str) -> dict:
+    with open(path, "rb") as f:
+        is_elf = f.read(4) == elf32.ELF_MAGIC
+    sites = read_elf(path) if is_elf else read_csv(path)
+    for site in sites.values():
+        site.static_flags()
+    # The same text under several module prefixes is one string each time.
+    by_text = collections.defaultdict(list)
+    for site in sites.values():
+        by_text[_MODULE.sub("", site.fmt)].append(site)
+    for same in by_text.values():
+        if len(same) > 1:
+            for site in same:
+                site.flags.append(f"same text as {len(same) - 1} other token(s)")
+    return sites
+
+
+# ── Capture ───────────────────────────────────────────────────────────────────
+
+class ArgStats:
+    def __init__(self, arg_type: str):
+        self.type     = arg_type
+        self.bytes    = 0
+        self.values   = collections.Counter()   # up to SMALL_SET + 1 distinct
+        self.many     = False                   # more distinct values than that
+        self.integral = True
+        self.rising   = True                    # every value above the last
+        self.last     = None
+
+    def add(self, value, size: int) -> None:
+        self.bytes += size
+        if self.type == FLOAT and not float(value).is_integer():
+            self.integral = False
+        if self.last is not None and not value > self.last:
+            self.rising = False
+        self.last = value
+        if not self.many:
+            self.values[value] += 1
+            self.many = len(self.values) > SMALL_SET
+
+
+def read_varint(data: bytes, pos: int):
+    value = shift = 0
+    while pos < len(data):
+        b = data[pos]
+        pos += 1
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return (value >> 1) ^ -(value & 1), pos
+    raise ValueError("truncated varint")
+
+
+def decode_args(types: list, data: bytes):
+    """Yield (value, encoded size) per argument."""
+    pos = 0
+    for t in types:
+        start = pos
+        if t in (INT, INT64):
+            value, pos = read_varint(data, pos)
+        elif t == FLOAT:
+            (value,) = struct.unpack_from("<f", data, pos)
+            pos += 4
+        else:
+            length = data[pos] & 0x7F   # bit 7: truncated
+            value = bytes(data[pos + 1:pos + 1 + length])
+            pos += 1 + length
+        if pos > len(data):
+            raise ValueError("truncated argument")
+        yield value, pos - start
+
+
+def read_capture(path: str, sites: dict) -> collections.Counter:
+    other = collections.Counter()
+    with open(path, "rb") as f:
+        for line in f:
+            for m in _MESSAGE.finditer(line):
+                try:
+                    message = base64.b64decode(m.group(1), validate=True)
+                except ValueError:
+                    other["undecodable"] += 1
+                    continue
+                if len(message) < 4:
+                    other["undecodable"] += 1
+                    continue
+                site = sites.get(struct.unpack_from("<I", message)[0])
+                if site is None:
+                    other["unknown token"] += 1
+                    other["unknown token bytes"] += len(m.group(0)) + 1
+                    continue
+                site.count += 1
+                site.wire_bytes += len(m.group(0)) + 1   # '$' … '\n'
+                try:
+                    for arg, (value, size) in zip(site.args,
+                                                  list(decode_args(site.types, message[4:]))):
+                        arg.add(value, size)
+                except (ValueError, IndexError, struct.error):
+                    other["bad arguments"] += 1
+    return other
+
+
+def capture_flags(site: Site) -> None:
+    if site.count == 0:
+        return
+    for i, arg in enumerate(site.args):
+        n = f"arg {i + 1}"
+        average = arg.bytes / site.count
+        if not arg.many and len(arg.values) == 1 and site.count >= CONSTANT_MIN:
+            (value,) = arg.values
+            shown = value.decode(errors="replace") if isinstance(value, bytes) else value
+            site.flags.append(f"{n}: always {shown!r}, {average:.1f} bytes: hoist it")
+        elif arg.type == STRING and not arg.many:
+            site.flags.append(f"{n}: {len(arg.values)} distinct strings, "
+                              f"{average:.1f} bytes: use an enum or a nested token")
+        elif arg.type in (INT, INT64) and (
+                average >= WIDE_BYTES or
+                (arg.rising and site.count >= CONSTANT_MIN and average >= RISING_BYTES)):
+            rising = ", rising in every message" if arg.rising else ""
+            site.flags.append(f"{n}: {average:.1f} varint bytes on average{rising}: "
+                              f"log a delta or a coarser unit")
+        elif arg.type == FLOAT and arg.integral:
+            site.flags.append(f"{n}: float holding whole numbers: use an integer")
+
+
+# ── Report ────────────────────────────────────────────────────────────────────
+
+def report(sites: dict, seconds, other, as_json: bool, out) -> None:
+    with_capture = other is not None
+    rows = sorted(sites.values(),
+                  key=(lambda s: (-s.wire_bytes, s.fmt)) if with_capture
+                  else (lambda s: (-(s.size_range()[1] or 1 << 16), s.fmt)))
+    total = sum(s.wire_bytes for s in rows)
+
+    if as_json:
+        result = []
+        for s in rows:
+            lo, hi = s.size_range()
+            entry = {"token": f"{s.token:08x}", "domain": s.domain, "format": s.fmt,
+                     "sites": s.sites, "args": s.types, "min_bytes": lo, "max_bytes": hi,
+                     "max_line_bytes": None if hi is None else line_bytes(hi),
+                     "flags": s.flags}
+            if with_capture:
+                entry.update(messages=s.count, wire_bytes=s.wire_bytes)
+                if seconds:
+                    entry["bytes_per_second"] = s.wire_bytes / seconds
+            result.append(entry)
+        doc = {"sites": result}
+        if with_capture:
+            doc.update(total_wire_bytes=total, other=dict(other))
+        json.dump(doc, out, indent=2)
+        out.write("\n")
+        return
+
+    rate = "B/s" if seconds else "bytes"
+    if with_capture:
+        print(f"{'':>3} {rate:>9} {'share':>6} {'msgs':>7} {'sites':>5} {'size':>7}  format",
+              file=out)
+    else:
+        print(f"{'sites':>5} {'bytes':>7} {'line':>5}  args           format", file=out)
+    for rank, s in enumerate(rows, 1):
+        if with_capture and s.count == 0:
+            continue
+        lo, hi = s.size_range()
+        size = f"{lo}-{hi if hi is not None else '?'}"
+        if with_capture:
+            value = f"{s.wire_bytes / seconds:.1f}" if seconds else s.wire_bytes
+            print(f"{rank:>3} {value:>9} {100.0 * s.wire_bytes / total:>5.1f}% {s.count:>7} "
+                  f"{s.sites or '?':>5} {size:>7}  {s.fmt}", file=out)
+        else:
+            line = line_bytes(hi) if hi is not None else "?"
+            print(f"{s.sites or '?':>5} {size:>7} {line:>5}  {','.join(s.types) or '-':<14} "
+                  f"{s.fmt}", file=out)
+        for flag in s.flags:
+            print(f"{'':>13}! {flag}", file=out)
+
+    if with_capture:
+        silent = sum(1 for s in rows if s.count == 0)
+        print(f"\n{sum(s.count for s in rows)} messages, {total} bytes"
+              + (f" in {seconds:g} s ({total / seconds:.1f} B/s)" if seconds else "")
+              + f"; {silent} format strings never seen", file=out)
+        for what, n in sorted(other.items()):
+            print(f"{what}: {n}", file=out)
+    else:
+        print(f"\n{len(rows)} format strings, {sum(s.sites for s in rows)} sites", file=out)
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="firmware ELF, or a pw_tokenizer tokens.csv")
+    parser.add_argument("--capture", help="log output with $base64 messages ('-': stdin)")
+    parser.add_argument("--seconds", type=float, help="duration of the capture, for B/s")
+    parser.add_argument("--json", action="store_true", help="machine-readable output")
+    parser.add_argument("-o", "--output", help="write the report here instead of stdout")
+    args = parser.parse_args()
+    if args.seconds is not None and args.seconds <= 0:
+        parser.error("--seconds must be positive")
+
+    try:
+        sites = read_sites(args.elf)
+        other = None
+        if args.capture:
+            other = read_capture("/dev/stdin" if args.capture == "-" else args.capture, sites)
+            for site in sites.values():
+                capture_flags(site)
+        out = open(args.output, "w", encoding="utf-8") if args.output else sys.stdout
+    except (elf32.ElfError, OSError, ValueError) as e:
+        print(f"ERROR: {e}", file=sys.stderr)
+        return 1
+    try:
+        report(sites, args.seconds, other, args.json, out)
+    finally:
+        if out is not sys.stdout:
+            out.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,189 @@
+#!/usr/bin/env python3
+"""Post-link step: fill in the link-time fields of the firmware image.
+
+Run by CMake after every link, before the .bin / .hex files are generated:
+
+  python tools/patch_image.py build/debug/stm32f429i_demo
+
+Two structures are patched in place, in this order:
+
+1. .build_metadata (v2 layout, see src/build_metadata.cc): the GNU build ID
+   from the .note.gnu.build-id note and the first 8 bytes of the SHA-256 of the
+   .pw_tokenizer.entries section are stored, then the struct's CRC-32 is
+   recomputed.  One read of this section thus identifies both the image and
+   the token database that decodes it.
+
+2. .image_check (see src/image_check.h): the flash image is rebuilt from the
+   PT_LOAD segments of the ELF (by load address, gaps and the tail up to the
+   next word boundary filled with 0xFF as in erased flash).  The trailer's base
+   / length fields are set first, then the CRC is computed over the image with
+   the crc32 field itself read as zero.  This runs last so that it covers the
+   patched metadata.
+
+Re-running the script on an already-patched ELF is a no-op.
+
+With --check-bin, nothing is patched: the image is rebuilt from the ELF as
+above and compared byte for byte with a raw binary made from it (objcopy -O
+binary --gap-fill 0xff, as CMake does after patching).  Without the gap fill
+objcopy pads gaps between segments with 0x00, and a board flashed from such a
+.bin fails the boot-time image check.
+
+  python tools/patch_image.py --check-bin build/debug/stm32f429i_demo.bin \
+                              build/debug/stm32f429i_demo
+
+Trailer layout (16 bytes, little-endian, word-aligned) — must match
+ImageCheck in src/image_check.h:
+  Offset  Size  Field
+  ------  ----  -----
+   0       4    magic    "IMGC"
+   4       4    base     load address of the first image byte
+   8       4    length   image size in bytes (multiple of 4)
+  12       4    crc32    CRC-32/MPEG-2 over the image as 32-bit LE words
+
+CRC algorithm: poly 0x04C11DB7, init 0xFFFFFFFF, no reflection, no final XOR,
+each 32-bit word fed MSB first — exactly what the STM32F4 CRC unit computes
+when the words are written to CRC->DR, so the firmware can check the image in
+hardware.
+"""
+
+import array
+import hashlib
+import struct
+import sys
+import zlib
+
+import elf32
+import read_build_meta as meta
+
+SECTION_NAME = b".image_check"
+MAGIC        = b"IMGC"
+TRAILER_FMT  = "<4sIII"
+TRAILER_SIZE = struct.calcsize(TRAILER_FMT)  # 16
+CRC_OFFSET   = 12
+
+TOKENS_SECTION    = b".pw_tokenizer.entries"
+BUILD_ID_OFFSET   = 71   # build_id_len, followed by build_id[20] and tokens_hash[8]
+BUILD_ID_CAPACITY = 20
+TOKENS_HASH_SIZE  = 8
+
+# Bit-reversal of every byte value, for mapping MPEG-2 onto zlib's reflected CRC.
+_REV8 = bytes(int(f"{i:08b}"[::-1], 2) for i in range(256))
+
+
+def crc32_mpeg2_words(image: bytes) -> int:
+    """CRC-32/MPEG-2 of |image| fed as little-endian 32-bit words, MSB first.
+
+    A non-reflected CRC over a bit stream equals the bit-reversed register of
+    the reflected CRC over the same stream with every byte bit-reversed, so the
+    work is delegated to zlib.crc32 (C speed) instead of a Python byte loop.
+    """
+    words = array.array("I", image)
+    if sys.byteorder == "little":
+        words.byteswap()  # MSB of each word first, as the CRC unit sees it
+    reg = ~zlib.crc32(words.tobytes().translate(_REV8)) & 0xFFFF_FFFF
+    return int(f"{reg:032b}"[::-1], 2)
+
+
+def build_image(buf):
+    """Return (base, bytearray) of the flash image described by the ELF."""
+    segs = elf32.load_segments(buf)
+    if not segs:
+        raise elf32.ElfError("ELF has no loadable segments")
+    base = segs[0].paddr
+    end  = max(s.paddr + s.filesz for s in segs)
+    size = (end - base + 3) & ~3
+    image = bytearray(b"\xff") * size
+    for s in segs:
+        image[s.paddr - base:s.paddr - base + s.filesz] = buf[s.offset:s.offset + s.filesz]
+    return base, image
+
+
+def patch_metadata(m) -> str:
+    """Store build ID + token database fingerprint in .build_metadata v2."""
+    sec = elf32.find_section(m, meta.SECTION_NAME)
+    off = sec.offset
+    if (sec.size < meta.V2_STRUCT_SIZE or m[off:off + 4] != meta.MAGIC
+            or m[off + 4] != meta.V2_VERSION):
+        return "build_metadata: not a v2 layout, left unchanged"
+
+    build_id = elf32.gnu_build_id(m)[:BUILD_ID_CAPACITY]
+    try:
+        entries = elf32.section_bytes(m, TOKENS_SECTION)
+        tokens_hash = hashlib.sha256(entries).digest()[:TOKENS_HASH_SIZE]
+    except elf32.ElfError:
+        tokens_hash = bytes(TOKENS_HASH_SIZE)  # no tokenized strings linked in
+
+    fields = (bytes([len(build_id)]) + build_id.ljust(BUILD_ID_CAPACITY, b"\x00")
+              + tokens_hash)
+    m[off + BUILD_ID_OFFSET:off + BUILD_ID_OFFSET + len(fields)] = fields
+    crc = zlib.crc32(m[off:off + meta.V2_CRC_OFFSET]) & 0xFFFF_FFFF
+    struct.pack_into("<I", m, off + meta.V2_CRC_OFFSET, crc)
+    return (f"build_metadata: build_id={build_id.hex()} tokens={tokens_hash.hex()} "
+            f"crc32={crc:#010x}")
+
+
+def patch(elf_path: str) -> int:
+    with elf32.map_file(elf_path, writable=True) as m:
+        print(patch_metadata(m))
+
+        sec = elf32.find_section(m, SECTION_NAME)
+        if sec.size < TRAILER_SIZE or m[sec.offset:sec.offset + 4] != MAGIC:
+            raise elf32.ElfError(f"{SECTION_NAME.decode()} does not hold an ImageCheck trailer")
+
+        base, image = build_image(m)
+        pos = sec.addr - base
+        if sec.addr % 4 or not 0 <= pos <= len(image) - TRAILER_SIZE:
+            raise elf32.ElfError(
+                f"{SECTION_NAME.decode()} at {sec.addr:#010x} is not a word-aligned "
+                f"part of the flash image")
+
+        trailer = struct.pack(TRAILER_FMT, MAGIC, base, len(image), 0)
+        image[pos:pos + TRAILER_SIZE] = trailer
+        crc = crc32_mpeg2_words(bytes(image))
+
+        m[sec.offset:sec.offset + TRAILER_SIZE] = trailer
+        struct.pack_into("<I", m, sec.offset + CRC_OFFSET, crc)
+        m.flush()
+
+    print(f"image_check: base={base:#010x} length={len(image)} crc32={crc:#010x}")
+    return 0
+
+
+def check_bin(bin_path: str, elf_path: str) -> int:
+    """Compare the image the CRC was computed over with |bin_path|."""
+    with elf32.map_file(elf_path) as m:
+        base, image = build_image(m)
+    with open(bin_path, "rb") as f:
+        data = f.read()
+    # The .bin ends with the last segment byte; the image is padded with 0xFF
+    # to a word, which is what erased flash reads as anyway.
+    tail = image[len(data):]
+    if len(tail) < 4 and image[:len(data)] == data and tail == b"\xff" * len(tail):
+        print(f"image_check: {bin_path} matches the image ({len(data)} bytes)")
+        return 0
+    if len(data) > len(image) or len(tail) >= 4:
+        detail = f"{len(data)} bytes, image has {len(image)}"
+    else:
+        at = next(i for i in range(len(data)) if image[i] != data[i])
+        detail = (f"first difference at {base + at:#010x}: image {image[at]:#04x}, "
+                  f".bin {data[at]:#04x}")
+    print(f"ERROR: {bin_path} is not the image the CRC covers ({detail}); "
+          f"generate it with objcopy --gap-fill 0xff", file=sys.stderr)
+    return 1
+
+
+def main() -> int:
+    args = sys.argv[1:]
+    check = len(args) == 3 and args[0] == "--check-bin"
+    if len(args) != 1 and not check:
+        print(f"Usage: {sys.argv[0]} [--check-bin <bin>] <elf>", file=sys.stderr)
+        return 1
+    try:
+        return check_bin(args[1], args[2]) if check else patch(args[0])
+    except (elf32.ElfError, OSError) as e:
+        print(f"ERROR: {args[-1]}: {e}", file=sys.stderr)
+        return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,21 +1,42 @@
 #!/usr/bin/env python3
 """Extract and verify the .build_metadata section from a firmware ELF.
 
-Uses arm-none-eabi-objcopy to pull out the section as raw binary, then
-parses the packed struct and verifies the CRC-32 — no Python dependencies
-beyond the standard library.
+The ELF32 section header table is parsed directly from a memory-mapped view
+of the file, so no toolchain (objcopy) and no temporary files are needed, and
+the script runs unchanged on Windows and Linux hosts.  Only the Python
+standard library is used.
 
 Usage:
   python tools/read_build_meta.py build/debug/stm32f429i_demo
+  python tools/read_build_meta.py --batch archive/ --format csv -o inventory.csv
+
+Batch mode walks a directory tree, parses every ELF it finds in parallel and
+writes one inventory record per image (JSON list or CSV) to stdout or -o.
 
 Exit code:
-  0  metadata OK (CRC passed)
-  1  error (bad magic, section missing, CRC mismatch)
+  0  metadata OK (CRC passed) — in batch mode: for every ELF found
+  1  error (bad magic, section missing, CRC mismatch) — in batch mode: for any ELF
 
-Struct layout (71 bytes, little-endian, no padding):
+Struct layout v2 (104 bytes, little-endian, no padding):
   Offset  Size  Field
   ------  ----  -----
-   0       4    magic    "META"  (no null terminator)
+   0       4    magic        "META"  (no null terminator)
+   4       1    version      2
+   5       1    reserved     0
+   6       2    size         struct size in bytes
+   8       9    commit       8-char git hash + NUL
+  17       1    dirty        0 = clean, 1 = modified working tree
+  18      32    branch       branch name + NUL
+  50      12    date         __DATE__  "Mmm DD YYYY" + NUL
+  62       9    time         __TIME__  "HH:MM:SS" + NUL
+  71       1    build_id_len bytes of build_id in use (0 = not patched)
+  72      20    build_id     GNU build ID (filled in by tools/patch_image.py)
+  92       8    tokens_hash  SHA-256[0:8] of .pw_tokenizer.entries (ditto)
+ 100       4    crc32        CRC-32/ISO-HDLC of bytes 0..99 (LE)
+
+Struct layout v1 (71 bytes, images built before the v2 layout; byte 4 is the
+first commit character, never a small version number):
+   0       4    magic    "META"
    4       9    commit   8-char git hash + NUL
   13       1    dirty    0 = clean, 1 = modified working tree
   14      32    branch   branch name + NUL
@@ -26,83 +47,96 @@ Struct layout (71 bytes, little-endian, no padding):
 CRC algorithm: IEEE 802.3 (zlib polynomial), same as Python's zlib.crc32().
 """
 
+import argparse
+import concurrent.futures
+import csv
+import json
 import os
 import struct
-import subprocess
 import sys
-import tempfile
 import zlib
 
+import elf32
+
 # Must match BuildMetadata in src/build_metadata.cc
-MAGIC       = b"META"
-STRUCT_FMT  = "<4s9sB32s12s9sI"
-STRUCT_SIZE = struct.calcsize(STRUCT_FMT)  # 71
+MAGIC          = b"META"
+V2_VERSION     = 2
+V2_STRUCT_FMT  = "<4sBBH9sB32s12s9sB20s8sI"
+V2_STRUCT_SIZE = struct.calcsize(V2_STRUCT_FMT)  # 104
+V2_CRC_OFFSET  = V2_STRUCT_SIZE - 4
+
+V1_STRUCT_FMT  = "<4s9sB32s12s9sI"
+V1_STRUCT_SIZE = struct.calcsize(V1_STRUCT_FMT)  # 71
+
+assert V2_STRUCT_SIZE == 104, f"Unexpected struct size {V2_STRUCT_SIZE}"
+assert V1_STRUCT_SIZE == 71, f"Unexpected struct size {V1_STRUCT_SIZE}"
+
+SECTION_NAME = b".build_metadata"
+
+INVENTORY_FIELDS = ("path", "status", "version", "commit", "dirty", "branch",
+                    "date", "time", "build_id", "tokens_hash", "crc32", "error")
+
+
+class MetaError(Exception):
+    """Raised when an ELF carries no valid metadata."""
 
-assert STRUCT_SIZE == 71, f"Unexpected struct size {STRUCT_SIZE}"
 
 def extract_section(elf_path: str) -> bytes:
-    """Use arm-none-eabi-objcopy to dump .build_metadata as a raw binary."""
-    with tempfile.NamedTemporaryFile(delete=False, suffix=".bin") as f:
-        tmp = f.name
+    """Memory-map |elf_path| and return the raw .build_metadata bytes."""
     try:
-        result = subprocess.run(
-            [
-                "C:\\Arm\\arm-none-eabi\\bin\\arm-none-eabi-objcopy",
-                "-O", "binary",
-                "--only-section=.build_metadata",
-                elf_path,
-                tmp,
-            ],
-            capture_output=True,
-        )
-        if result.returncode != 0:
-            print(f"ERROR: objcopy failed:\n{result.stderr.decode()}", file=sys.stderr)
-            sys.exit(1)
-        with open(tmp, "rb") as f:
-            return f.read()
-    finally:
-        if os.path.exists(tmp):
-            os.unlink(tmp)
+        with elf32.map_file(elf_path) as m:
+            return elf32.section_bytes(m, SECTION_NAME)
+    except elf32.ElfError as e:
+        raise MetaError(str(e)) from None
 
 
 def verify_crc(commit: bytes, dirty: int, branch: bytes, date: bytes, time_b: bytes) -> int:
-    """Compute the expected CRC-32 over the metadata content fields.
+    """Compute the expected v1 CRC-32 over the metadata content fields.
 
     Byte sequence fed to zlib.crc32():
       commit_chars + [dirty_byte] + branch_chars + date_chars + time_chars
-    All strings without their null terminator (mirrors the firmware's crc32_str).
+    All strings without their null terminator (mirrors the v1 firmware).
     """
     payload = commit + bytes([dirty]) + branch + date + time_b
     return zlib.crc32(payload) & 0xFFFF_FFFF
 
 
-def main() -> int:
-    if len(sys.argv) < 2:
-        print(f"Usage: {sys.argv[0]} <elf>", file=sys.stderr)
-        return 1
+def _text(b: bytes) -> str:
+    return b.rstrip(b"\x00").decode(errors="replace")
 
-    elf_path = sys.argv[1]
-    if not os.path.isfile(elf_path):
-        print(f"ERROR: file not found: {elf_path}", file=sys.stderr)
-        return 1
 
-    data = extract_section(elf_path)
+def parse_v2(data: bytes) -> dict:
+    if len(data) < V2_STRUCT_SIZE:
+        raise MetaError(f".build_metadata v2 is {len(data)} bytes (expected {V2_STRUCT_SIZE})")
+    (_, version, _, size, commit, dirty, branch, date_b, time_b,
+     build_id_len, build_id, tokens_hash, stored_crc) = struct.unpack_from(V2_STRUCT_FMT, data)
+    if size < V2_STRUCT_SIZE or size > len(data):
+        raise MetaError(f"bad struct size {size} in .build_metadata v2 header")
+    computed = zlib.crc32(data[:V2_CRC_OFFSET]) & 0xFFFF_FFFF
+    return {
+        "version":      version,
+        "commit":       _text(commit),
+        "dirty":        bool(dirty),
+        "branch":       _text(branch),
+        "date":         _text(date_b),
+        "time":         _text(time_b),
+        "build_id":     build_id[:build_id_len].hex(),
+        "tokens_hash":  tokens_hash.hex() if any(tokens_hash) else "",
+        "crc32":        stored_crc,
+        "crc_computed": computed,
+        "crc_ok":       computed == stored_crc,
+    }
 
-    if len(data) < STRUCT_SIZE:
-        print(
-            f"ERROR: .build_metadata section is {len(data)} bytes "
-            f"(expected >= {STRUCT_SIZE}).  Was the section added to the linker script?",
-            file=sys.stderr,
-        )
-        return 1
 
-    magic, commit, dirty, branch, date_b, time_b, stored_crc = struct.unpack_from(
-        STRUCT_FMT, data
-    )
+def parse_v1(data: bytes) -> dict:
+    if len(data) < V1_STRUCT_SIZE:
+        raise MetaError(
+            f".build_metadata section is {len(data)} bytes "
+            f"(expected >= {V1_STRUCT_SIZE}).  Was the section added to the linker script?")
 
-    if magic != MAGIC:
-        print(f"ERROR: bad magic {magic!r} (expected {MAGIC!r})", file=sys.stderr)
-        return 1
+    _, commit, dirty, branch, date_b, time_b, stored_crc = struct.unpack_from(
+        V1_STRUCT_FMT, data
+    )
 
     # Strip embedded NUL bytes for display and CRC input.
     commit_s = commit.rstrip(b"\x00")
@@ -111,17 +145,157 @@ def main() -> int:
     time_s   = time_b.rstrip(b"\x00")
 
     computed = verify_crc(commit_s, dirty, branch_s, date_s, time_s)
-    ok = computed == stored_crc
 
-    print(f"Commit : {commit_s.decode()}{'-dirty' if dirty else ''}")
-    print(f"Branch : {branch_s.decode()}")
-    print(f"Built  : {date_s.decode()} {time_s.decode()}")
+    return {
+        "version":      1,
+        "commit":       commit_s.decode(errors="replace"),
+        "dirty":        bool(dirty),
+        "branch":       branch_s.decode(errors="replace"),
+        "date":         date_s.decode(errors="replace"),
+        "time":         time_s.decode(errors="replace"),
+        "build_id":     "",
+        "tokens_hash":  "",
+        "crc32":        stored_crc,
+        "crc_computed": computed,
+        "crc_ok":       computed == stored_crc,
+    }
+
+
+def parse_metadata(data: bytes) -> dict:
+    """Decode and CRC-check a raw .build_metadata blob (v1 or v2)."""
+    if len(data) < 5 or data[:4] != MAGIC:
+        raise MetaError(f"bad magic {data[:4]!r} (expected {MAGIC!r})")
+    # v1 continues with an ASCII commit hash; v2+ with a small version number.
+    if data[4] < 0x20:
+        if data[4] != V2_VERSION:
+            raise MetaError(f"unsupported .build_metadata layout version {data[4]}")
+        return parse_v2(data)
+    return parse_v1(data)
+
+
+def read_metadata(elf_path: str) -> dict:
+    return parse_metadata(extract_section(elf_path))
+
+
+# ── Batch mode ────────────────────────────────────────────────────────────────
+
+def is_elf(path: str) -> bool:
+    try:
+        with open(path, "rb") as f:
+            return f.read(4) == elf32.ELF_MAGIC
+    except OSError:
+        return False
+
+
+def iter_elfs(root: str):
+    """Yield every ELF file below |root| (identified by magic, not extension)."""
+    for dirpath, _, filenames in os.walk(root):
+        for fn in filenames:
+            path = os.path.join(dirpath, fn)
+            if is_elf(path):
+                yield path
+
+
+def inventory_record(elf_path: str) -> dict:
+    """Worker: never raises, so one bad image cannot abort the whole batch."""
+    rec = dict.fromkeys(INVENTORY_FIELDS, "")
+    rec["path"] = elf_path
+    try:
+        meta = read_metadata(elf_path)
+    except (MetaError, elf32.ElfError, OSError, struct.error) as e:
+        rec["status"] = "error"
+        rec["error"]  = str(e)
+        return rec
+    rec.update({k: meta[k] for k in ("version", "commit", "dirty", "branch", "date",
+                                     "time", "build_id", "tokens_hash")})
+    rec["crc32"]  = f"{meta['crc32']:#010x}"
+    rec["status"] = "ok" if meta["crc_ok"] else "crc_mismatch"
+    if not meta["crc_ok"]:
+        rec["error"] = f"computed {meta['crc_computed']:#010x}"
+    return rec
+
+
+def run_batch(root: str, fmt: str, out, jobs: int) -> int:
+    paths = sorted(iter_elfs(root))
+    # Per-ELF work is a handful of small reads, so batch many paths per task to
+    # keep inter-process overhead below the parsing cost.
+    chunk = max(1, len(paths) // (jobs * 8))
+    if jobs > 1 and len(paths) > chunk:
+        with concurrent.futures.ProcessPoolExecutor(max_workers=jobs) as pool:
+            records = list(pool.map(inventory_record, paths, chunksize=chunk))
+    else:
+        records = [inventory_record(p) for p in paths]
+
+    if fmt == "json":
+        json.dump(records, out, indent=2)
+        out.write("\n")
+    else:
+        writer = csv.DictWriter(out, fieldnames=INVENTORY_FIELDS, lineterminator="\n")
+        writer.writeheader()
+        writer.writerows(records)
+
+    bad = sum(1 for r in records if r["status"] != "ok")
+    print(f"{len(records)} ELF(s) scanned, {bad} with errors", file=sys.stderr)
+    return 0 if bad == 0 else 1
+
+
+# ── Single-image mode ─────────────────────────────────────────────────────────
+
+def print_metadata(meta: dict) -> None:
+    print(f"Commit : {meta['commit']}{'-dirty' if meta['dirty'] else ''}")
+    print(f"Branch : {meta['branch']}")
+    print(f"Built  : {meta['date']} {meta['time']}")
+    if meta["version"] >= 2:
+        print(f"BuildID: {meta['build_id'] or '(not patched)'}")
+        print(f"Tokens : {meta['tokens_hash'] or '(not patched)'}")
     print(
-        f"CRC32  : {stored_crc:#010x}  "
-        + ("OK" if ok else f"MISMATCH (computed {computed:#010x})")
+        f"CRC32  : {meta['crc32']:#010x}  "
+        + ("OK" if meta["crc_ok"] else f"MISMATCH (computed {meta['crc_computed']:#010x})")
     )
 
-    return 0 if ok else 1
+
+def run_single(elf_path: str) -> int:
+    if not os.path.isfile(elf_path):
+        print(f"ERROR: file not found: {elf_path}", file=sys.stderr)
+        return 1
+
+    try:
+        meta = read_metadata(elf_path)
+    except (MetaError, elf32.ElfError, OSError, struct.error) as e:
+        print(f"ERROR: {e}", file=sys.stderr)
+        return 1
+
+    print_metadata(meta)
+    return 0 if meta["crc_ok"] else 1
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(
+        description="Extract and verify .build_metadata from firmware ELF files.")
+    parser.add_argument("elf", nargs="?", help="firmware ELF (single-image mode)")
+    parser.add_argument("--batch", metavar="DIR",
+                        help="scan DIR recursively and emit an inventory of all ELFs")
+    parser.add_argument("--format", choices=("json", "csv"), default="json",
+                        help="inventory format in batch mode (default: json)")
+    parser.add_argument("-o", "--output", metavar="FILE",
+                        help="write the inventory to FILE instead of stdout")
+    parser.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1,
+                        help="parallel worker processes in batch mode")
+    args = parser.parse_args()
+
+    if args.batch:
+        if not os.path.isdir(args.batch):
+            print(f"ERROR: not a directory: {args.batch}", file=sys.stderr)
+            return 1
+        if args.output:
+            with open(args.output, "w", newline="", encoding="utf-8") as out:
+                return run_batch(args.batch, args.format, out, max(1, args.jobs))
+        return run_batch(args.batch, args.format, sys.stdout, max(1, args.jobs))
+
+    if not args.elf:
+        parser.print_usage(sys.stderr)
+        return 1
+    return run_single(args.elf)
 
 
 if __name__ == "__main__":
@@ -0,0 +1,346 @@
+#!/usr/bin/env python3
+"""Host client for the firmware's UART RPC service (src/rpc.h).
+
+  python tools/rpc_client.py /dev/ttyACM0 list
+  python tools/rpc_client.py /dev/ttyACM0 stats
+  python tools/rpc_client.py /dev/ttyACM0 dump-stats
+  python tools/rpc_client.py /dev/ttyACM0 log-level          # query
+  python tools/rpc_client.py /dev/ttyACM0 log-level warn     # set
+  python tools/rpc_client.py /dev/ttyACM0 history            # flash log
+  python tools/rpc_client.py /dev/ttyACM0 capture-start      # record into SDRAM
+  python tools/rpc_client.py /dev/ttyACM0 capture-read > capture.csv
+  python tools/rpc_client.py /dev/ttyACM0 mem-bench          # SRAM vs SDRAM
+  python tools/rpc_client.py /dev/ttyACM0 bench --runs 64    # hot-path cycles
+  python tools/rpc_client.py /dev/ttyACM0 config             # all settings
+  python tools/rpc_client.py /dev/ttyACM0 config sample_period_ms 250
+  python tools/rpc_client.py /dev/ttyACM0 call Stats.Get     # raw hex response
+
+The port may equally be the pseudo-terminal of the host build
+(build/host/host/stm32f429i_demo_host --link /tmp/demo-uart).
+
+Method IDs are the pw_tokenizer tokens of "Service.Method", computed here
+with the same 65599 hash, so no token database is needed.  Log lines that
+arrive while waiting for a response are written to stderr undecoded (pipe the
+port through tools/token_db_store.py decode to read them).
+
+Requires pyserial.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+import hdlc
+
+ADDRESS = ord("R")   # rpc::kAddress
+
+# pw::Status codes
+STATUS_NAMES = (
+    "OK", "CANCELLED", "UNKNOWN", "INVALID_ARGUMENT", "DEADLINE_EXCEEDED",
+    "NOT_FOUND", "ALREADY_EXISTS", "PERMISSION_DENIED", "RESOURCE_EXHAUSTED",
+    "FAILED_PRECONDITION", "ABORTED", "OUT_OF_RANGE", "UNIMPLEMENTED",
+    "INTERNAL", "UNAVAILABLE", "DATA_LOSS", "UNAUTHENTICATED",
+)
+
+# Methods of src/rpc_services.h
+METHODS = (
+    "Device.GetBuildInfo",
+    "Log.SetLevel",
+    "Stats.Get",
+    "Stats.Dump",
+    "Rpc.ListMethods",
+    "History.Read",
+    "Capture.Start",
+    "Capture.Stop",
+    "Capture.Read",
+    "Memory.Bench",
+    "Config.Get",
+    "Config.Set",
+    "Bench.Run",
+)
+
+# Stats.Get response, in order (u32 each)
+STATS_FIELDS = ("uptime_ms", "samples", "batches", "log_emitted", "log_filtered",
+                "rpc_calls", "rpc_errors", "rpc_dropped_frames", "log_dropped",
+                "overruns", "jitter_max_us", "switch_cycles", "display_us")
+
+# Configuration keys (src/config.h: kEntries), name → id
+CONFIG_KEYS = {"baud": 0, "batch_size": 1, "sample_period_ms": 2, "log_level": 3}
+CONFIG_APPLY = {0: "now", 1: "after a reset", 2: "at the next batch"}
+
+LOG_LEVELS = {"debug": 1, "info": 2, "warn": 3, "error": 4, "critical": 5, "fatal": 7}
+
+# History records (src/history.h): type → (name, fields); "s" marks zigzag
+# (signed) varints.
+HISTORY_RECORDS = {
+    1: ("batch", ("batch", "t_ms", "mean:s", "min:s", "max:s",
+                  "jitter_max_us", "jitter_mean_us")),
+    2: ("event", ("event", "value", "uptime_ms")),
+}
+HISTORY_EVENTS = {1: "boot", 2: "log-level", 3: "watchdog"}
+
+# Capture.Read sample: t_ms (u32), raw_value (s16), jitter_us (u16)
+CAPTURE_SAMPLE = struct.Struct("<IhH")
+
+# Memory.Bench result per region (u32 each)
+BENCH_FIELDS = ("write_cycles_per_kb", "read_cycles_per_kb", "latency_cycles")
+
+# Bench.Run result per kernel (u32 each, src/bench.h)
+KERNEL_FIELDS = ("cold", "min", "median", "max")
+
+
+def method_id(name: str) -> int:
+    """pw_tokenizer's 65599 hash (PW_TOKENIZE_STRING) of |name|."""
+    h, coefficient = len(name), 65599
+    for c in name.encode():
+        h = (h + coefficient * c) & 0xFFFF_FFFF
+        coefficient = (coefficient * 65599) & 0xFFFF_FFFF
+    return h
+
+
+def decode_varints(data: bytes) -> list:
+    values, value, shift = [], 0, 0
+    for b in data:
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            values.append(value)
+            value, shift = 0, 0
+    return values
+
+
+def decode_history(rtype: int, payload: bytes) -> tuple:
+    """(name, {field: value}) of one History.Read record."""
+    name, fields = HISTORY_RECORDS.get(rtype, (f"type{rtype}", ()))
+    out = {}
+    for field, v in zip(fields, decode_varints(payload)):
+        field, _, kind = field.partition(":")
+        out[field] = (v >> 1) ^ -(v & 1) if kind == "s" else v
+    if name == "event":
+        out["event"] = HISTORY_EVENTS.get(out.get("event"), out.get("event"))
+    return name, out
+
+
+class RpcError(Exception):
+    def __init__(self, method: str, status: int):
+        name = STATUS_NAMES[status] if status < len(STATUS_NAMES) else str(status)
+        super().__init__(f"{method}: {name}")
+        self.status = status
+
+
+class RpcClient:
+    def __init__(self, port, timeout: float = 2.0, log=None):
+        self._port    = port
+        self._timeout = timeout
+        self._call_id = 0
+        self._decoder = hdlc.FrameDecoder(log)
+
+    def call(self, method: str, request: bytes = b"") -> bytes:
+        """Invoke |method| and return the response body; raises RpcError."""
+        mid = method_id(method)
+        self._call_id = (self._call_id + 1) & 0xFF
+        self._port.write(hdlc.encode_ui_frame(
+            ADDRESS, struct.pack("<IB", mid, self._call_id) + request))
+
+        deadline = time.monotonic() + self._timeout
+        while time.monotonic() < deadline:
+            for frame in self._decoder.process(self._port.read(self._port.in_waiting or 1)):
+                p = frame.payload
+                if frame.address != ADDRESS or len(p) < 6:
+                    continue
+                rid, call_id, status = struct.unpack_from("<IBB", p)
+                if rid != mid or call_id != self._call_id:
+                    continue   # late answer to an earlier, timed-out call
+                if status != 0:
+                    raise RpcError(method, status)
+                return bytes(p[6:])
+        raise TimeoutError(f"{method}: no response within {self._timeout:.1f} s")
+
+    # ── Typed wrappers ────────────────────────────────────────────────────────
+
+    def build_info(self) -> bytes:
+        return self.call("Device.GetBuildInfo")
+
+    def stats(self) -> dict:
+        data = self.call("Stats.Get")
+        n = min(len(data) // 4, len(STATS_FIELDS))
+        return dict(zip(STATS_FIELDS, struct.unpack_from(f"<{n}I", data)))
+
+    def dump_stats(self) -> None:
+        self.call("Stats.Dump")
+
+    def log_level(self, level: int = 0) -> int:
+        """Set the level (0: only query); returns the previous level."""
+        return self.call("Log.SetLevel", bytes([level]))[0]
+
+    def list_methods(self) -> list:
+        data = self.call("Rpc.ListMethods")
+        return list(struct.unpack(f"<{len(data) // 4}I", data))
+
+    def history(self, first: int = 0):
+        """Yields (type, payload) of every record from |first| on."""
+        retries = 8  # UNAVAILABLE while a sector erase (up to 2 s) runs
+        while True:
+            try:
+                data = self.call("History.Read", struct.pack("<I", first))
+            except RpcError as e:
+                if e.status != STATUS_NAMES.index("UNAVAILABLE") or retries == 0:
+                    raise
+                retries -= 1
+                time.sleep(0.5)
+                continue
+            if not data:
+                return
+            pos = 0
+            while pos + 2 <= len(data):
+                rtype, size = data[pos], data[pos + 1]
+                yield rtype, data[pos + 2:pos + 2 + size]
+                pos += 2 + size
+                first += 1
+
+    def capture_start(self, max_samples: int = 0) -> int:
+        """Starts a capture; returns how many samples it will record."""
+        return struct.unpack("<I", self.call("Capture.Start", struct.pack("<I", max_samples)))[0]
+
+    def capture_stop(self) -> int:
+        return struct.unpack("<I", self.call("Capture.Stop"))[0]
+
+    def capture_read(self, first: int = 0):
+        """Yields (t_ms, raw_value, jitter_us) of every recorded sample."""
+        while True:
+            data = self.call("Capture.Read", struct.pack("<I", first))
+            count, _running = struct.unpack_from("<IB", data)
+            samples = data[5:]
+            if not samples:
+                return
+            for sample in CAPTURE_SAMPLE.iter_unpack(samples):
+                yield sample
+            first += len(samples) // CAPTURE_SAMPLE.size
+            if first >= count:
+                return
+
+    def config_get(self, key: int) -> dict:
+        value, default, lo, hi, apply = struct.unpack(
+            "<IIIIB", self.call("Config.Get", bytes([key])))
+        return {"value": value, "default": default, "min": lo, "max": hi,
+                "apply": CONFIG_APPLY.get(apply, apply)}
+
+    def config_set(self, key: int, value: int):
+        """Returns (previous value, when the new one applies)."""
+        previous, apply = struct.unpack(
+            "<IB", self.call("Config.Set", struct.pack("<BI", key, value)))
+        return previous, CONFIG_APPLY.get(apply, apply)
+
+    def memory_bench(self) -> dict:
+        data = self.call("Memory.Bench")
+        values = struct.unpack(f"<{len(data) // 4}I", data)
+        n = len(BENCH_FIELDS)
+        return {region: dict(zip(BENCH_FIELDS, values[i * n:(i + 1) * n]))
+                for i, region in enumerate(("sram", "sdram"))}
+
+    def bench(self, runs: int = 0):
+        """(ticks per µs, {kernel: {cold, min, median, max}}); runs 0: 32."""
+        data = self.call("Bench.Run", bytes([runs]))
+        per_us, = struct.unpack_from("<I", data)
+        kernels, pos = {}, 4
+        while pos < len(data):
+            size = data[pos]
+            name = data[pos + 1:pos + 1 + size].decode()
+            pos += 1 + size
+            kernels[name] = dict(zip(KERNEL_FIELDS, struct.unpack_from("<4I", data, pos)))
+            pos += 16
+        return per_us, kernels
+
+
+def open_port(device: str, baudrate: int):
+    import serial  # pyserial, see README
+    return serial.Serial(device, baudrate, timeout=0.05)
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("device", help="serial port or host-build pty")
+    parser.add_argument("--baudrate", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=2.0, help="seconds (default: 2)")
+    sub = parser.add_subparsers(dest="cmd", required=True)
+    sub.add_parser("list", help="methods the device implements")
+    sub.add_parser("stats", help="read the counters")
+    sub.add_parser("dump-stats", help="have the device log its counters")
+    p = sub.add_parser("log-level", help="query or set the runtime log level")
+    p.add_argument("level", nargs="?", choices=sorted(LOG_LEVELS, key=LOG_LEVELS.get))
+    p = sub.add_parser("history", help="read batch summaries and events from flash")
+    p.add_argument("--first", type=int, default=0, help="skip older records")
+    p = sub.add_parser("capture-start", help="record every reading into SDRAM")
+    p.add_argument("samples", nargs="?", type=int, default=0, help="0: until the buffer is full")
+    sub.add_parser("capture-stop", help="stop recording")
+    sub.add_parser("capture-read", help="print the recorded samples as CSV")
+    sub.add_parser("mem-bench", help="SRAM vs SDRAM bandwidth and latency")
+    p = sub.add_parser("bench", help="cycles per run of the hot paths (interrupts masked)")
+    p.add_argument("--runs", type=int, default=0, help="1..64 (default: 32)")
+    p = sub.add_parser("config", help="list the settings, or change one (stored in flash)")
+    p.add_argument("key", nargs="?", choices=list(CONFIG_KEYS))
+    p.add_argument("value", nargs="?", type=int)
+    p = sub.add_parser("call", help="invoke any method, print the response as hex")
+    p.add_argument("method")
+    p.add_argument("request", nargs="?", default="", help="request body as hex")
+    args = parser.parse_args()
+
+    names = {v: k for k, v in LOG_LEVELS.items()}
+    log = lambda raw: sys.stderr.buffer.write(raw)  # noqa: E731
+
+    try:
+        with open_port(args.device, args.baudrate) as port:
+            client = RpcClient(port, args.timeout, log)
+            if args.cmd == "list":
+                known = {method_id(m): m for m in METHODS}
+                for mid in client.list_methods():
+                    print(f"{mid:#010x}  {known.get(mid, '?')}")
+            elif args.cmd == "stats":
+                for k, v in client.stats().items():
+                    print(f"{k:<18} {v}")
+            elif args.cmd == "dump-stats":
+                client.dump_stats()
+            elif args.cmd == "log-level":
+                prev = client.log_level(LOG_LEVELS[args.level] if args.level else 0)
+                print(f"{names.get(prev, prev)}" + (f" → {args.level}" if args.level else ""))
+            elif args.cmd == "history":
+                for rtype, payload in client.history(args.first):
+                    name, fields = decode_history(rtype, payload)
+                    print(f"{name:<6} " + " ".join(f"{k}={v}" for k, v in fields.items()))
+            elif args.cmd == "capture-start":
+                print(f"recording {client.capture_start(args.samples)} samples")
+            elif args.cmd == "capture-stop":
+                print(f"{client.capture_stop()} samples recorded")
+            elif args.cmd == "capture-read":
+                print("t_ms,raw_value,jitter_us")
+                for t_ms, raw, jitter in client.capture_read():
+                    print(f"{t_ms},{raw},{jitter}")
+            elif args.cmd == "config" and args.value is not None:
+                previous, apply = client.config_set(CONFIG_KEYS[args.key], args.value)
+                print(f"{args.key}: {previous} → {args.value}, applies {apply}")
+            elif args.cmd == "config":
+                for name, key in CONFIG_KEYS.items():
+                    if args.key in (None, name):
+                        c = client.config_get(key)
+                        print(f"{name:<17} {c['value']:<8} (default {c['default']}, "
+                              f"{c['min']}..{c['max']}, applies {c['apply']})")
+            elif args.cmd == "mem-bench":
+                for region, r in client.memory_bench().items():
+                    print(f"{region:<6} " + "  ".join(f"{k}={v}" for k, v in r.items()))
+            elif args.cmd == "bench":
+                per_us, kernels = client.bench(args.runs)
+                print(f"{'kernel':<14}" + "".join(f"{f:>9}" for f in KERNEL_FIELDS)
+                      + f"   ({per_us} ticks per µs)")
+                for name, r in kernels.items():
+                    print(f"{name:<14}" + "".join(f"{r[f]:>9}" for f in KERNEL_FIELDS))
+            else:
+                print(client.call(args.method, bytes.fromhex(args.request)).hex())
+    except (RpcError, TimeoutError, OSError) as e:
+        print(f"ERROR: {args.device}: {e}", file=sys.stderr)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,240 @@
+#!/usr/bin/env python3
+"""Decode a captured SWO byte stream of the ITM log transport.
+
+With -DDEMO_LOG_TRANSPORT=itm the firmware writes tokenized log messages
+unencoded to ITM stimulus port 1 and the assert handler's text to port 0
+(src/transport.h).  Capture the SWO pin in UART (NRZ) mode at
+transport::kSwoHz, for example with OpenOCD:
+
+  openocd -f board/stm32f429discovery.cfg \\
+          -c "tpiu config internal swo.bin uart off 180000000 2000000" \\
+          -c "itm ports on"
+
+and decode the file afterwards:
+
+  python tools/swo_decode.py swo.bin                        # $base64 lines
+  python tools/swo_decode.py swo.bin --database build/debug/stm32f429i_demo.tokens.csv
+  python tools/swo_decode.py swo.bin --store tokendb/       # see token_db_store.py
+
+Port 0 text is printed as it is; each port 1 message becomes one line, either
+'$' Base64 like the UART transport sends (so any pw_tokenizer tool reads the
+output) or detokenized.  Other ports and hardware (DWT) packets are counted
+and skipped; statistics go to stderr.
+
+Framing (ARMv7-M ARM, appendix D4): the stream is a sequence of packets,
+each a header byte optionally followed by payload.  Port 1 carries
+0xA5 | length (u16, little endian) | token ++ arguments; after an overflow
+packet or a bad length the decoder drops bytes up to the next 0xA5.
+"""
+
+import argparse
+import base64
+import collections
+import os
+import struct
+import sys
+
+LOG_PORT     = 1      # transport::kItmLogPort
+TEXT_PORT    = 0      # transport::kItmTextPort
+FRAME_MARKER = 0xA5   # transport::kFrameMarker
+MAX_FRAME    = 512    # above LogQueue::kMaxPayloadSize; longer means garbage
+
+
+# ── ITM packets ───────────────────────────────────────────────────────────────
+
+class ItmParser:
+    """Splits a SWO byte stream into (port, payload bytes) of SWIT packets."""
+
+    def __init__(self):
+        self.stats    = collections.Counter()
+        self._pending = b""   # incomplete packet at the end of the last chunk
+
+    def process(self, data: bytes):
+        """Yield (port, bytes) for every software source packet in |data|;
+        None as port marks an overflow (data lost before this point)."""
+        buf = self._pending + data
+        i = 0
+        while i < len(buf):
+            b = buf[i]
+            if b == 0x00:                               # synchronisation
+                i += 1
+                continue
+            if b == 0x70:                               # overflow
+                self.stats["overflow"] += 1
+                i += 1
+                yield None, b""
+                continue
+            if b & 0x03:                                # source packet
+                size = (1, 2, 4)[(b & 0x03) - 1]
+                if i + 1 + size > len(buf):
+                    break
+                payload = buf[i + 1:i + 1 + size]
+                i += 1 + size
+                if b & 0x04:                            # hardware (DWT)
+                    self.stats["hardware"] += 1
+                    continue
+                self.stats["software"] += 1
+                yield b >> 3, payload
+                continue
+            # Protocol packets: payload bytes carry a continuation bit.
+            if b == 0x80:                               # end of a sync run
+                self.stats["sync"] += 1
+                i += 1
+                continue
+            if (b & 0x8F) == 0x00:                      # local timestamp 2
+                self.stats["timestamp"] += 1
+                i += 1
+                continue
+            if (b & 0xCF) == 0xC0 or (b & 0xDF) == 0x94 or (b & 0x8B) == 0x88:
+                # local timestamp 1, global timestamp 1/2, extension
+                end = i + 1
+                while end < len(buf) and buf[end] & 0x80:
+                    end += 1
+                if end >= len(buf):
+                    break
+                self.stats["extension" if (b & 0x0B) == 0x08 else "timestamp"] += 1
+                i = end + 1
+                continue
+            if (b & 0x0B) == 0x08:                      # extension, one byte
+                self.stats["extension"] += 1
+                i += 1
+                continue
+            self.stats["reserved"] += 1
+            i += 1
+        self._pending = bytes(buf[i:])
+
+
+# ── Log frames ────────────────────────────────────────────────────────────────
+
+class FrameDecoder:
+    """Reassembles FRAME_MARKER | length | message frames of the log port."""
+
+    def __init__(self):
+        self.frames  = 0
+        self.dropped = 0     # bytes skipped while looking for a marker
+        self._buf    = bytearray()
+
+    def reset(self) -> None:
+        self.dropped += len(self._buf)
+        self._buf.clear()
+
+    def process(self, data: bytes):
+        """Yield every message completed by |data|."""
+        self._buf += data
+        while self._buf:
+            if self._buf[0] != FRAME_MARKER:
+                start = self._buf.find(FRAME_MARKER)
+                skip = len(self._buf) if start < 0 else start
+                self.dropped += skip
+                del self._buf[:skip]
+                continue
+            if len(self._buf) < 3:
+                return
+            (length,) = struct.unpack_from("<H", self._buf, 1)
+            if length == 0 or length > MAX_FRAME:
+                self.dropped += 1
+                del self._buf[:1]
+                continue
+            if len(self._buf) < 3 + length:
+                return
+            message = bytes(self._buf[3:3 + length])
+            del self._buf[:3 + length]
+            self.frames += 1
+            yield message
+
+
+# ── Output ────────────────────────────────────────────────────────────────────
+
+def _import_pw_tokenizer():
+    try:
+        import pw_tokenizer  # noqa: F401
+    except ImportError:
+        root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+        sys.path.insert(0, os.path.join(root, "ext", "pigweed", "pw_tokenizer", "py"))
+    from pw_tokenizer import detokenize
+    return detokenize
+
+
+def make_formatter(args):
+    """Returns message bytes → output line (bytes, without newline)."""
+    def encoded(message: bytes) -> bytes:
+        return b"$" + base64.b64encode(message)
+
+    if args.store:
+        import token_db_store
+        dec = token_db_store.StreamDecoder(token_db_store.Store(args.store),
+                                           capacity=8, initial=args.build_id)
+        return lambda message: dec.line(encoded(message))
+    if args.database:
+        det = _import_pw_tokenizer().Detokenizer(args.database)
+
+        def detokenized(message: bytes) -> bytes:
+            result = det.detokenize(message)
+            return str(result).encode() if result.ok() else encoded(message)
+        return detokenized
+    return encoded
+
+
+def decode(src, out, formatter, chunk_size: int = 4096):
+    itm, frames = ItmParser(), FrameDecoder()
+    other_ports = collections.Counter()
+    at_line_start = True
+
+    def write_line(line: bytes) -> None:
+        nonlocal at_line_start
+        # Text without a newline yet (a crash report in progress) gets one,
+        # so a message never starts in the middle of a line.
+        out.write((b"" if at_line_start else b"\n") + line + b"\n")
+        at_line_start = True
+
+    for chunk in iter(lambda: src.read(chunk_size), b""):
+        for port, payload in itm.process(chunk):
+            if port is None:
+                frames.reset()
+            elif port == LOG_PORT:
+                for message in frames.process(payload):
+                    write_line(formatter(message))
+            elif port == TEXT_PORT:
+                out.write(payload)
+                at_line_start = payload.endswith(b"\n")
+            else:
+                other_ports[port] += len(payload)
+        out.flush()
+
+    s = itm.stats
+    print(f"[swo] {frames.frames} messages, {s['software']} stimulus packets, "
+          f"{s['overflow']} overflows, {frames.dropped} bytes dropped", file=sys.stderr)
+    if s["hardware"] or s["timestamp"] or s["extension"] or s["reserved"]:
+        print(f"[swo] skipped: {s['hardware']} hardware, {s['timestamp']} timestamp, "
+              f"{s['extension']} extension, {s['reserved']} reserved packets", file=sys.stderr)
+    for port, count in sorted(other_ports.items()):
+        print(f"[swo] port {port}: {count} bytes ignored", file=sys.stderr)
+    return 0
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", help="SWO capture ('-': stdin)")
+    db = parser.add_mutually_exclusive_group()
+    db.add_argument("--database", help="pw_tokenizer database (tokens.csv) to detokenize with")
+    db.add_argument("--store", help="token database store, switching by build ID")
+    parser.add_argument("--build-id", help="with --store: database until the first boot banner")
+    args = parser.parse_args()
+
+    try:
+        formatter = make_formatter(args)
+        src = sys.stdin.buffer if args.input == "-" else open(args.input, "rb")
+    except OSError as e:
+        print(f"ERROR: {e}", file=sys.stderr)
+        return 1
+    try:
+        return decode(src, sys.stdout.buffer, formatter)
+    except KeyboardInterrupt:
+        return 0
+    finally:
+        if src is not sys.stdin.buffer:
+            src.close()
+
+
+if __name__ == "__main__":
+    sys.exit(main())
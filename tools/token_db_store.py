@@ -0,0 +1,296 @@
+#!/usr/bin/env python3
+"""Token database store keyed by GNU build ID.
+
+Decoding a capture with the tokens.csv of a different firmware version
+silently produces garbage.  This tool keeps one database per build in an
+indexed directory and picks the right one from the build ID the firmware logs
+at boot ("Build ID: <hex>"):
+
+  # After each build (CMake does this automatically when TOKEN_DB_STORE is set)
+  python tools/token_db_store.py add  tokendb/ build/debug/stm32f429i_demo \
+         --database build/debug/stm32f429i_demo.tokens.csv
+  python tools/token_db_store.py list tokendb/
+
+  # Decode a capture or a live port; databases switch on every boot banner
+  python tools/token_db_store.py decode tokendb/ --input capture.txt
+  python tools/token_db_store.py decode tokendb/ --device /dev/ttyACM0
+
+Store layout:
+  tokendb/index.json         {"version": 1, "builds": {<build id hex>: {...}}}
+  tokendb/<build id hex>.csv pw_tokenizer CSV database of that build
+
+The boot banner is recognised by token: its format string is the same in
+every build, so the tokens recorded in the index identify it without knowing
+which database the stream belongs to yet.  Loaded databases are kept in an
+in-memory LRU, so switching between recently seen builds is a dict lookup.
+
+`add` without --database and `decode` need pw_tokenizer; it is imported from
+ext/pigweed/pw_tokenizer/py when not already on PYTHONPATH.
+"""
+
+import argparse
+import base64
+import collections
+import csv
+import json
+import os
+import re
+import shutil
+import struct
+import sys
+import tempfile
+
+import elf32
+import read_build_meta
+
+INDEX_FILE      = "index.json"
+INDEX_VERSION   = 1
+BUILD_ID_FORMAT = "[DEMO] Build ID: %s"   # PW_LOG_INFO in src/main.cpp
+
+_MESSAGE = re.compile(rb"\$([A-Za-z0-9+/]+={0,2})")
+
+
+def _import_pw_tokenizer():
+    try:
+        import pw_tokenizer  # noqa: F401
+    except ImportError:
+        root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+        sys.path.insert(0, os.path.join(root, "ext", "pigweed", "pw_tokenizer", "py"))
+    from pw_tokenizer import database, detokenize, tokens
+    return database, detokenize, tokens
+
+
+# ── Store ─────────────────────────────────────────────────────────────────────
+
+class Store:
+    def __init__(self, path: str):
+        self.path  = path
+        self.index = {"version": INDEX_VERSION, "builds": {}}
+        index_path = os.path.join(path, INDEX_FILE)
+        if os.path.isfile(index_path):
+            with open(index_path, encoding="utf-8") as f:
+                self.index = json.load(f)
+            if self.index.get("version") != INDEX_VERSION:
+                raise SystemExit(f"ERROR: {index_path}: unsupported index version")
+
+    @property
+    def builds(self) -> dict:
+        return self.index["builds"]
+
+    def database_path(self, build_id: str) -> str:
+        return os.path.join(self.path, self.builds[build_id]["database"])
+
+    def banner_tokens(self) -> set:
+        return {int(b["build_id_token"], 16) for b in self.builds.values()
+                if b.get("build_id_token")}
+
+    def save(self) -> None:
+        os.makedirs(self.path, exist_ok=True)
+        fd, tmp = tempfile.mkstemp(dir=self.path, suffix=".tmp")
+        with os.fdopen(fd, "w", encoding="utf-8") as f:
+            json.dump(self.index, f, indent=2, sort_keys=True)
+            f.write("\n")
+        os.replace(tmp, os.path.join(self.path, INDEX_FILE))
+
+
+def find_banner_token(csv_path: str, fmt: str):
+    """Token of |fmt| in a pw_tokenizer CSV (token is the first column, the
+    string the last; the column count differs between Pigweed versions)."""
+    with open(csv_path, newline="", encoding="utf-8") as f:
+        for row in csv.reader(f):
+            if row and row[-1] == fmt:
+                return int(row[0], 16)
+    return None
+
+
+def cmd_add(args) -> int:
+    with elf32.map_file(args.elf) as m:
+        build_id = elf32.gnu_build_id(m).hex()
+
+    try:
+        meta = read_build_meta.read_metadata(args.elf)
+    except read_build_meta.MetaError as e:
+        print(f"WARNING: {args.elf}: {e}; storing without git metadata", file=sys.stderr)
+        meta = {}
+
+    store = Store(args.store)
+    os.makedirs(args.store, exist_ok=True)
+    db_name = f"{build_id}.csv"
+    db_path = os.path.join(args.store, db_name)
+    if args.database:
+        shutil.copyfile(args.database, db_path)
+    else:
+        database, _, tokens = _import_pw_tokenizer()
+        with open(db_path, "wb") as f:
+            tokens.write_csv(database.load_token_database(args.elf), f)
+
+    token = find_banner_token(db_path, args.banner)
+    if token is None:
+        print(f"WARNING: {args.banner!r} not in the database; this build cannot be "
+              f"detected automatically in a stream", file=sys.stderr)
+
+    store.builds[build_id] = {
+        "database":       db_name,
+        "build_id_token": f"{token:#010x}" if token is not None else "",
+        "commit":         meta.get("commit", ""),
+        "dirty":          meta.get("dirty", False),
+        "branch":         meta.get("branch", ""),
+        "built":          f"{meta.get('date', '')} {meta.get('time', '')}".strip(),
+        "tokens_hash":    meta.get("tokens_hash", ""),
+    }
+    store.save()
+    print(f"token-db: {build_id} → {db_path}")
+    return 0
+
+
+def cmd_list(args) -> int:
+    store = Store(args.store)
+    for build_id, b in sorted(store.builds.items(), key=lambda kv: kv[1].get("built", "")):
+        dirty = "-dirty" if b.get("dirty") else ""
+        print(f"{build_id}  {b.get('commit') or '?'}{dirty} @ {b.get('branch') or '?'}  {b.get('built', '')}")
+    return 0
+
+
+# ── Decoder ───────────────────────────────────────────────────────────────────
+
+class DetokenizerCache:
+    """LRU of loaded detokenizers keyed by build ID."""
+
+    def __init__(self, store: Store, capacity: int):
+        _, self._detokenize, _ = _import_pw_tokenizer()
+        self._store    = store
+        self._capacity = capacity
+        self._cache    = collections.OrderedDict()
+
+    def get(self, build_id: str):
+        det = self._cache.get(build_id)
+        if det is not None:
+            self._cache.move_to_end(build_id)
+            return det
+        if build_id not in self._store.builds:
+            return None
+        det = self._detokenize.Detokenizer(self._store.database_path(build_id))
+        self._cache[build_id] = det
+        if len(self._cache) > self._capacity:
+            self._cache.popitem(last=False)
+        return det
+
+
+def parse_banner(payload: bytes):
+    """Build ID hex string from a "Build ID: %s" payload, or None.
+
+    pw_tokenizer encodes a %s argument as one length byte (bit 7 = truncated)
+    followed by the characters.
+    """
+    if len(payload) < 5:
+        return None
+    n = payload[4] & 0x7F
+    arg = payload[5:5 + n]
+    try:
+        text = arg.decode("ascii")
+        bytes.fromhex(text)
+    except ValueError:
+        return None
+    return text.lower()
+
+
+class StreamDecoder:
+    def __init__(self, store: Store, capacity: int, initial: str = None):
+        self._store   = store
+        self._cache   = DetokenizerCache(store, capacity)
+        self._banners = store.banner_tokens()
+        self.build_id = None
+        self._det     = None
+        if initial:
+            self.switch(initial)
+
+    def switch(self, build_id: str) -> None:
+        self.build_id = build_id
+        self._det = self._cache.get(build_id)
+        b = self._store.builds.get(build_id)
+        if b is None:
+            print(f"[token-db] build {build_id} not in store; messages left encoded",
+                  file=sys.stderr)
+        else:
+            print(f"[token-db] build {build_id} ({b.get('commit') or '?'} @ "
+                  f"{b.get('branch') or '?'})", file=sys.stderr)
+
+    def _message(self, m: re.Match) -> bytes:
+        try:
+            payload = base64.b64decode(m.group(1), validate=True)
+        except ValueError:
+            return m.group(0)
+        if len(payload) >= 4 and struct.unpack_from("<I", payload)[0] in self._banners:
+            build_id = parse_banner(payload)
+            if build_id and build_id != self.build_id:
+                self.switch(build_id)
+        if self._det is None:
+            return m.group(0)
+        result = self._det.detokenize(payload)
+        return str(result).encode() if result.ok() else m.group(0)
+
+    def line(self, raw: bytes) -> bytes:
+        return _MESSAGE.sub(self._message, raw)
+
+
+def cmd_decode(args) -> int:
+    store = Store(args.store)
+    dec = StreamDecoder(store, args.cache, args.build_id)
+
+    if args.device:
+        import serial  # pyserial, see README
+        src = serial.Serial(args.device, args.baudrate)
+    elif args.input and args.input != "-":
+        src = open(args.input, "rb")
+    else:
+        src = sys.stdin.buffer
+
+    out = sys.stdout.buffer
+    try:
+        for raw in iter(src.readline, b""):
+            out.write(dec.line(raw))
+            out.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if src is not sys.stdin.buffer:
+            src.close()
+    return 0
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="cmd", required=True)
+
+    p = sub.add_parser("add", help="add (or replace) the database of one firmware ELF")
+    p.add_argument("store")
+    p.add_argument("elf")
+    p.add_argument("--database", help="existing tokens.csv of this ELF (default: extract)")
+    p.add_argument("--banner", default=BUILD_ID_FORMAT,
+                   help=f"format string of the build ID log (default: {BUILD_ID_FORMAT!r})")
+    p.set_defaults(func=cmd_add)
+
+    p = sub.add_parser("list", help="list the builds in a store")
+    p.add_argument("store")
+    p.set_defaults(func=cmd_list)
+
+    p = sub.add_parser("decode", help="detokenize a stream, switching databases by build ID")
+    p.add_argument("store")
+    src = p.add_mutually_exclusive_group()
+    src.add_argument("--input", help="capture file ('-' or omitted: stdin)")
+    src.add_argument("--device", help="serial port (requires pyserial)")
+    p.add_argument("--baudrate", type=int, default=115200)
+    p.add_argument("--build-id", help="database to use until the first boot banner")
+    p.add_argument("--cache", type=int, default=8, help="databases kept loaded (LRU)")
+    p.set_defaults(func=cmd_decode)
+
+    args = parser.parse_args()
+    try:
+        return args.func(args)
+    except (elf32.ElfError, OSError) as e:
+        print(f"ERROR: {e}", file=sys.stderr)
+        return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,204 @@
+#!/usr/bin/env python3
+"""Compare two firmware builds side by side: code size per function and cycles.
+
+Meant for the same preset built with both toolchain files (release and
+clang-release), to pick the compiler for a release on data:
+
+  cmake --build --preset release && cmake --build --preset clang-release
+  python tools/toolchain_compare.py build/release/stm32f429i_demo \\
+                                    build/clang-release/stm32f429i_demo
+
+or, from a configured build, `cmake --build --preset release --target
+toolchain_compare` (see TOOLCHAIN_COMPARE_WITH in CMakeLists.txt).  The
+perf preset's perf_report target uses it the same way, against the
+minsizerel build.
+
+Sizes come from the ELF symbol tables: flash (PT_LOAD file bytes), code
+(executable sections), RAM (allocated sections in SRAM / CCM), and the size
+of every function matching --match – by default the hot paths that Bench.Run
+times (src/bench.h) and their callees.  Compiler clones (.constprop, .isra,
+.part, .llvm.*) are added to their function.  A function missing on one side
+was inlined there, or not used.  Names are demangled with c++filt
+(arm-none-eabi-c++filt, llvm-cxxfilt or c++filt, whichever is found first);
+without one, --match sees the mangled names.
+
+Cycle counts come from the board: flash each build, run
+tools/bench_collect.py against it, and pass both files with --bench.  Each
+file must have been measured on the build it is compared for (its build_id
+is checked against the ELF's GNU build ID).
+
+  python tools/toolchain_compare.py ELF_A ELF_B \\
+      --bench a-bench.json b-bench.json --json compare.json
+
+Columns are labelled with the compiler named in each ELF's .comment section.
+Exit code 1 on a file error or a bench file from a different build.
+"""
+
+import argparse
+import json
+import re
+import shutil
+import subprocess
+import sys
+
+import elf32
+
+# The kernels of src/bench.h and what they call: batch reduction and
+# processing, Base64 log lines, CRCs, argument encoding, the log handler.
+DEFAULT_MATCH = (r"^(bench|batch|crc|log_line|log_control|pw::tokenizer|pw::varint)::"
+                 r"|^pw_log_tokenized_HandleLog|^pw_tokenizer_")
+
+_CLONE   = re.compile(rb"\.(constprop|isra|part|lto_priv|llvm|cold)\.?[0-9a-f.]*$")
+_GCC     = re.compile(rb"GCC: \([^)]*\) (\S+)")
+_CLANG   = re.compile(rb"clang version (\S+)")
+RAM      = ((0x1000_0000, 0x1001_0000), (0x2000_0000, 0x2003_0000))  # CCM, SRAM1–3
+DEMANGLERS = ("arm-none-eabi-c++filt", "llvm-cxxfilt", "c++filt")
+
+
+class Image:
+    """Sizes of one firmware ELF."""
+
+    def __init__(self, path: str):
+        self.path = path
+        buf = elf32.map_file(path)
+        try:
+            sections = list(elf32.iter_sections(buf))
+            self.flash = sum(s.filesz for s in elf32.load_segments(buf))
+            self.code  = sum(s.size for s in sections if s.flags & elf32.SHF_EXECINSTR)
+            self.ram   = sum(s.size for s in sections
+                             if s.flags & elf32.SHF_ALLOC and
+                             any(lo <= s.addr < hi for lo, hi in RAM))
+            self.functions = {}
+            for sym in elf32.iter_symbols(buf):
+                if sym.type == elf32.STT_FUNC and sym.size and sym.shndx:
+                    name = _CLONE.sub(b"", sym.name).decode(errors="replace")
+                    self.functions[name] = self.functions.get(name, 0) + sym.size
+            self.compiler = compiler(buf, sections) or path
+            try:
+                self.build_id = elf32.gnu_build_id(buf).hex()
+            except elf32.ElfError:
+                self.build_id = None
+        finally:
+            buf.close()
+
+
+def compiler(buf, sections) -> str:
+    """'clang 21.1.1' or 'gcc 14.2.1' from .comment; Clang wins if both are named."""
+    comment = b"".join(bytes(buf[s.offset:s.offset + s.size])
+                       for s in sections if s.name == b".comment")
+    for pattern, name in ((_CLANG, "clang"), (_GCC, "gcc")):
+        m = pattern.search(comment)
+        if m:
+            return f"{name} {m.group(1).decode()}"
+    return ""
+
+
+def demangle(names: list) -> dict:
+    """Mangled → readable name, through the first c++filt found (or unchanged)."""
+    tool = next((t for t in map(shutil.which, DEMANGLERS) if t), None)
+    if tool is None or not names:
+        if names:
+            print("WARNING: no c++filt found, matching mangled names", file=sys.stderr)
+        return {n: n for n in names}
+    out = subprocess.run([tool], input="\n".join(names) + "\n", capture_output=True,
+                         text=True, check=True).stdout.splitlines()
+    return dict(zip(names, out)) if len(out) == len(names) else {n: n for n in names}
+
+
+def load_bench(path: str, image: Image) -> dict:
+    with open(path) as f:
+        bench = json.load(f)
+    if image.build_id and bench.get("build_id") and bench["build_id"] != image.build_id:
+        raise ValueError(f"{path} was measured on build {bench['build_id'][:16]}…, "
+                         f"not {image.path} ({image.build_id[:16]}…)")
+    return bench
+
+
+def shorten(name: str) -> str:
+    return name if len(name) <= 72 else name[:69] + "..."
+
+
+def change(a, b) -> str:
+    if not a or b is None:
+        return ""
+    return f"{(b / a - 1) * 100:+.1f}%"
+
+
+def report(a: Image, b: Image, match: str, benches) -> dict:
+    la, lb = a.compiler, b.compiler
+    if la == lb:
+        la, lb = a.path, b.path
+
+    names = demangle(sorted(set(a.functions) | set(b.functions)))
+    pattern = re.compile(match)
+    rows = [(shorten(names[n]), a.functions.get(n), b.functions.get(n))
+            for n in names if pattern.search(names[n])]
+    rows.sort(key=lambda r: -max(r[1] or 0, r[2] or 0))
+    functions = {name: {la: sa, lb: sb} for name, sa, sb in rows}
+
+    nw = max([28] + [len(r[0]) for r in rows])
+    w  = max(12, len(la), len(lb))
+
+    def line(label, va, vb):
+        print(f"{label:<{nw}} {'-' if va is None else va:>{w}} "
+              f"{'-' if vb is None else vb:>{w}} {change(va, vb):>8}")
+
+    print(f"{'image bytes':<{nw}} {la:>{w}} {lb:>{w}} {'change':>8}")
+    image = {}
+    for field in ("flash", "code", "ram"):
+        image[field] = {la: getattr(a, field), lb: getattr(b, field)}
+        line(field, getattr(a, field), getattr(b, field))
+
+    print(f"\n{'function bytes':<{nw}} {la:>{w}} {lb:>{w}} {'change':>8}")
+    for name, sa, sb in rows:
+        line(name, sa, sb)
+    line(f"total ({len(rows)} functions)",
+         sum(r[1] or 0 for r in rows), sum(r[2] or 0 for r in rows))
+
+    cycles = {}
+    if benches:
+        ba, bb = benches
+        unit = ba.get("unit", "cycles")
+        if bb.get("unit", "cycles") != unit:
+            raise ValueError("bench files measured in different units")
+        print(f"\n{'kernel ' + unit + ': median, cold':<{nw}} {la:>{w}} {lb:>{w}} {'change':>8}")
+        for kernel, ka in ba["kernels"].items():
+            kb = bb["kernels"].get(kernel)
+            if kb is None:
+                continue
+            cycles[kernel] = {la: ka, lb: kb}
+            line(kernel, ka["median"], kb["median"])
+            line("  cold", ka["cold"], kb["cold"])
+
+    return {"builds": {la: a.path, lb: b.path}, "image": image,
+            "functions": functions, "kernels": cycles}
+
+
+def main() -> int:
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", nargs=2, help="the two firmware ELFs")
+    parser.add_argument("--match", default=DEFAULT_MATCH,
+                        help="regex on demangled function names (default: the hot paths)")
+    parser.add_argument("--all", action="store_true", help="every function")
+    parser.add_argument("--bench", nargs=2, metavar="JSON",
+                        help="tools/bench_collect.py output for each ELF, same order")
+    parser.add_argument("--json", metavar="FILE", help="also write the comparison as JSON")
+    args = parser.parse_args()
+
+    try:
+        images = [Image(path) for path in args.elf]
+        benches = [load_bench(p, i) for p, i in zip(args.bench, images)] if args.bench else None
+        result = report(*images, "" if args.all else args.match, benches)
+    except (elf32.ElfError, OSError, ValueError, KeyError) as e:
+        print(f"ERROR: {e}", file=sys.stderr)
+        return 1
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(result, f, indent=2)
+            f.write("\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())